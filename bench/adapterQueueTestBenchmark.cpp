@@ -1,5 +1,8 @@
 #include <benchmark/benchmark.h>
 #include "adapterQueue.h"
+#include "allocCounter.h"
+#include "cacheLine.h"
+#include <chrono>
 #include <memory>
 #include <atomic>
 #include <barrier>
@@ -8,29 +11,34 @@
 // =================== Fixture定义（只用于单线程静态数据，不做全局共享） ===================
 class ASBQFixture : public benchmark::Fixture {
 public:
-    void SetUp(const benchmark::State& state) override {
+    void SetUp(benchmark::State& state) override {
         // 只用于单线程用例
         q = std::make_unique<AutoShrinkBlockingQueue<int>>();
         fatq = std::make_unique<AutoShrinkBlockingQueue<FatObj>>();
-        produced = 0;
-        consumed = 0;
+        produced->store(0);
+        consumed->store(0);
+        if (state.thread_index() == 0) mem.start();
     }
-    void TearDown(const benchmark::State&) override {
+    void TearDown(benchmark::State& state) override {
+        // 先记内存 counter 再释放队列：rss_delta/peak_live 反映的是用例结束时队列仍持有的内存
+        if (state.thread_index() == 0) mem.stop(state);
         q.reset(); fatq.reset();
     }
     struct FatObj { char buf[4096]; int id; };
     std::unique_ptr<AutoShrinkBlockingQueue<int>> q;
     std::unique_ptr<AutoShrinkBlockingQueue<FatObj>> fatq;
-    std::atomic<int64_t> produced{0};
-    std::atomic<int64_t> consumed{0};
+    CacheLinePadded<std::atomic<int64_t>> produced{0};
+    CacheLinePadded<std::atomic<int64_t>> consumed{0};
+    BenchMemoryCounters mem;
 };
 
 // =================== 多线程共享对象区（全局静态定义） ===================
 static std::unique_ptr<AutoShrinkBlockingQueue<int>> g_int_queue;
 static std::unique_ptr<AutoShrinkBlockingQueue<ASBQFixture::FatObj>> g_fat_queue;
 static std::unique_ptr<std::barrier<>> g_barrier;
-static std::atomic<int64_t> g_produced{0};
-static std::atomic<int64_t> g_consumed{0};
+// 生产者和消费者各自频繁累加，各占一个 cache line，避免计数器本身的伪共享污染队列测量
+static CacheLinePadded<std::atomic<int64_t>> g_produced{0};
+static CacheLinePadded<std::atomic<int64_t>> g_consumed{0};
 
 // ========================== 1. 单线程 Push ==========================
 BENCHMARK_DEFINE_F(ASBQFixture, SinglePush)(benchmark::State& state) {
@@ -113,8 +121,8 @@ BENCHMARK_DEFINE_F(ASBQFixture, ProducerConsumer)(benchmark::State& state) {
     if (state.thread_index() == 0) {
         g_int_queue = std::make_unique<AutoShrinkBlockingQueue<int>>();
         g_barrier = std::make_unique<std::barrier<>>(state.threads());
-        g_produced.store(0, std::memory_order_relaxed);
-        g_consumed.store(0, std::memory_order_relaxed);
+        g_produced->store(0, std::memory_order_relaxed);
+        g_consumed->store(0, std::memory_order_relaxed);
     }
     while(!g_int_queue || !g_barrier) std::this_thread::yield();
 
@@ -125,7 +133,7 @@ BENCHMARK_DEFINE_F(ASBQFixture, ProducerConsumer)(benchmark::State& state) {
         for (auto _ : state) {
             for (int i = 0; i < batch; ++i) {
                 g_int_queue->push(i);
-                g_produced.fetch_add(1, std::memory_order_relaxed);
+                g_produced->fetch_add(1, std::memory_order_relaxed);
             }
         }
     } else {
@@ -134,19 +142,19 @@ BENCHMARK_DEFINE_F(ASBQFixture, ProducerConsumer)(benchmark::State& state) {
             for (int i = 0; i < batch; ++i) {
                 while (!g_int_queue->try_pop())
                     std::this_thread::yield();
-                g_consumed.fetch_add(1, std::memory_order_relaxed);
+                g_consumed->fetch_add(1, std::memory_order_relaxed);
             }
         }
     }
     g_barrier->arrive_and_wait();
 
     if (state.thread_index() == 0) {
-        state.counters["produce_total"] = g_produced.load();
-        state.counters["consume_total"] = g_consumed.load();
+        state.counters["produce_total"] = g_produced->load();
+        state.counters["consume_total"] = g_consumed->load();
         state.counters["produce_rate"] = benchmark::Counter(
-            static_cast<double>(g_produced.load()), benchmark::Counter::kIsRate);
+            static_cast<double>(g_produced->load()), benchmark::Counter::kIsRate);
         state.counters["consume_rate"] = benchmark::Counter(
-            static_cast<double>(g_consumed.load()), benchmark::Counter::kIsRate);
+            static_cast<double>(g_consumed->load()), benchmark::Counter::kIsRate);
         g_int_queue.reset();
         g_barrier.reset();
     }
@@ -156,16 +164,40 @@ BENCHMARK_REGISTER_F(ASBQFixture, ProducerConsumer)
     ->Arg(1)->Arg(10)->Arg(100);
 
 // ========================== 7. Shrink策略 sweep（无共享资源） ==========================
+// ShrinkSweep 固定参数；ShrinkSweepAutoTuned 以同样的参数起步，开启在线调参（默认 1% CPU 预算），
+// final_interval / final_factor 为结束时调参器停在的参数，shrinks 为实际收缩次数
+static void SetShrinkCounters(benchmark::State& state, const AutoShrinkBlockingQueue<int>& q) {
+    auto [interval, factor] = q.shrink_params();
+    state.counters["final_interval"] = static_cast<double>(interval);
+    state.counters["final_factor"] = factor;
+    state.counters["shrinks"] = static_cast<double>(q.shrink_count());
+}
+
 BENCHMARK_DEFINE_F(ASBQFixture, ShrinkSweep)(benchmark::State& state) {
     size_t shrink_interval = state.range(0);
     float shrink_factor = static_cast<float>(state.range(1)) / 100.0f;
     AutoShrinkBlockingQueue<int> qtmp(shrink_interval, shrink_factor);
     for (auto _ : state)
         qtmp.push(42), benchmark::DoNotOptimize(qtmp.try_pop());
+    SetShrinkCounters(state, qtmp);
 }
 BENCHMARK_REGISTER_F(ASBQFixture, ShrinkSweep)
     ->Args({100,15})->Args({100,25})->Args({500,20})->Args({1000,20});
 
+BENCHMARK_DEFINE_F(ASBQFixture, ShrinkSweepAutoTuned)(benchmark::State& state) {
+    size_t shrink_interval = state.range(0);
+    float shrink_factor = static_cast<float>(state.range(1)) / 100.0f;
+    AutoShrinkBlockingQueue<int> qtmp(shrink_interval, shrink_factor);
+    ShrinkTuning tuning;
+    tuning.window = std::chrono::milliseconds(10); // 基准时长有限，窗口取短一些让调参器来得及收敛
+    qtmp.enable_shrink_tuning(tuning);
+    for (auto _ : state)
+        qtmp.push(42), benchmark::DoNotOptimize(qtmp.try_pop());
+    SetShrinkCounters(state, qtmp);
+}
+BENCHMARK_REGISTER_F(ASBQFixture, ShrinkSweepAutoTuned)
+    ->Args({100,15})->Args({100,25})->Args({500,20})->Args({1000,20});
+
 // ========================== 8. 大对象单线程/多线程 push/try_pop ==========================
 // 单线程push
 BENCHMARK_DEFINE_F(ASBQFixture, FatObjSinglePush)(benchmark::State& state) {
@@ -187,4 +219,14 @@ BENCHMARK_DEFINE_F(ASBQFixture, FatObjSingleTryPop)(benchmark::State& state) {
 }
 BENCHMARK_REGISTER_F(ASBQFixture, FatObjSingleTryPop)->Arg(1000)->Arg(10000);
 
-BENCHMARK_MAIN();
\ No newline at end of file
+// 自定义 main：注册 MemoryManager，JSON 输出（--benchmark_format=json）中附带框架自身的内存统计
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    CountingMemoryManager memory_manager;
+    benchmark::RegisterMemoryManager(&memory_manager);
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::RegisterMemoryManager(nullptr);
+    benchmark::Shutdown();
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "allocCounter.h"
+#include "memoryStats.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include <malloc.h> // Windows: _msize/_aligned_msize，glibc: malloc_usable_size
+
+// operator delete 内调用 free 是有意为之（operator new 就是 malloc 出来的）
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace {
+
+std::atomic<uint64_t> g_allocs{0};
+std::atomic<uint64_t> g_frees{0};
+std::atomic<uint64_t> g_bytes{0};
+std::atomic<uint64_t> g_live{0};
+std::atomic<uint64_t> g_peak_live{0};
+
+size_t UsableSize(void* p, size_t align) {
+#if defined(_WIN32)
+    return align ? _aligned_msize(p, align, 0) : _msize(p);
+#else
+    (void)align;
+    return malloc_usable_size(p);
+#endif
+}
+
+void OnAlloc(size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(n, std::memory_order_relaxed);
+    uint64_t live = g_live.fetch_add(n, std::memory_order_relaxed) + n;
+    uint64_t peak = g_peak_live.load(std::memory_order_relaxed);
+    while (live > peak && !g_peak_live.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+}
+
+void OnFree(size_t n) {
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+    g_live.fetch_sub(n, std::memory_order_relaxed);
+}
+
+void* CountedAlloc(size_t n) {
+    void* p = std::malloc(n ? n : 1);
+    if (p) OnAlloc(UsableSize(p, 0));
+    return p;
+}
+
+void* CountedAlignedAlloc(size_t n, size_t align) {
+    if (n == 0) n = 1;
+#if defined(_WIN32)
+    void* p = _aligned_malloc(n, align);
+#else
+    void* p = std::aligned_alloc(align, (n + align - 1) / align * align);
+#endif
+    if (p) OnAlloc(UsableSize(p, align));
+    return p;
+}
+
+void CountedFree(void* p) {
+    if (!p) return;
+    OnFree(UsableSize(p, 0));
+    std::free(p);
+}
+
+void CountedAlignedFree(void* p, size_t align) {
+    if (!p) return;
+    OnFree(UsableSize(p, align));
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+} // namespace
+
+AllocSnapshot GetAllocSnapshot() {
+    AllocSnapshot s;
+    s.allocs = g_allocs.load(std::memory_order_relaxed);
+    s.frees = g_frees.load(std::memory_order_relaxed);
+    s.bytes = g_bytes.load(std::memory_order_relaxed);
+    s.live = g_live.load(std::memory_order_relaxed);
+    s.peak_live = g_peak_live.load(std::memory_order_relaxed);
+    return s;
+}
+
+void ResetAllocPeak() {
+    g_peak_live.store(g_live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+void CountingMemoryManager::Start() {
+    ResetAllocPeak();
+    begin_ = GetAllocSnapshot();
+}
+
+void CountingMemoryManager::Stop(Result& result) {
+    AllocSnapshot end = GetAllocSnapshot();
+    result.num_allocs = static_cast<int64_t>(end.allocs - begin_.allocs);
+    result.total_allocated_bytes = static_cast<int64_t>(end.bytes - begin_.bytes);
+    result.max_bytes_used = static_cast<int64_t>(end.peak_live - begin_.live);
+    result.net_heap_growth = static_cast<int64_t>(end.live) - static_cast<int64_t>(begin_.live);
+}
+
+void BenchMemoryCounters::start() {
+    ResetAllocPeak();
+    begin_ = GetAllocSnapshot();
+    rss_begin_ = GetProcessRssBytes();
+}
+
+void BenchMemoryCounters::stop(benchmark::State& state) {
+    AllocSnapshot end = GetAllocSnapshot();
+    size_t rss_end = GetProcessRssBytes();
+    state.counters["allocs_per_op"] = benchmark::Counter(
+        static_cast<double>(end.allocs - begin_.allocs), benchmark::Counter::kAvgIterations);
+    state.counters["bytes_per_op"] = benchmark::Counter(
+        static_cast<double>(end.bytes - begin_.bytes), benchmark::Counter::kAvgIterations,
+        benchmark::Counter::kIs1024);
+    state.counters["peak_live"] = benchmark::Counter(
+        static_cast<double>(end.peak_live - begin_.live), benchmark::Counter::kDefaults,
+        benchmark::Counter::kIs1024);
+    state.counters["rss_delta_MiB"] =
+        (static_cast<double>(rss_end) - static_cast<double>(rss_begin_)) / (1024.0 * 1024.0);
+}
+
+// =================== 替换全局 operator new/delete ===================
+
+void* operator new(size_t n) {
+    if (void* p = CountedAlloc(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n) {
+    if (void* p = CountedAlloc(n)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t n, const std::nothrow_t&) noexcept { return CountedAlloc(n); }
+void* operator new[](size_t n, const std::nothrow_t&) noexcept { return CountedAlloc(n); }
+void* operator new(size_t n, std::align_val_t al) {
+    if (void* p = CountedAlignedAlloc(n, static_cast<size_t>(al))) return p;
+    throw std::bad_alloc();
+}
+void* operator new[](size_t n, std::align_val_t al) {
+    if (void* p = CountedAlignedAlloc(n, static_cast<size_t>(al))) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t n, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return CountedAlignedAlloc(n, static_cast<size_t>(al));
+}
+void* operator new[](size_t n, std::align_val_t al, const std::nothrow_t&) noexcept {
+    return CountedAlignedAlloc(n, static_cast<size_t>(al));
+}
+
+void operator delete(void* p) noexcept { CountedFree(p); }
+void operator delete[](void* p) noexcept { CountedFree(p); }
+void operator delete(void* p, size_t) noexcept { CountedFree(p); }
+void operator delete[](void* p, size_t) noexcept { CountedFree(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { CountedFree(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { CountedFree(p); }
+void operator delete(void* p, std::align_val_t al) noexcept { CountedAlignedFree(p, static_cast<size_t>(al)); }
+void operator delete[](void* p, std::align_val_t al) noexcept { CountedAlignedFree(p, static_cast<size_t>(al)); }
+void operator delete(void* p, size_t, std::align_val_t al) noexcept { CountedAlignedFree(p, static_cast<size_t>(al)); }
+void operator delete[](void* p, size_t, std::align_val_t al) noexcept { CountedAlignedFree(p, static_cast<size_t>(al)); }
+void operator delete(void* p, std::align_val_t al, const std::nothrow_t&) noexcept {
+    CountedAlignedFree(p, static_cast<size_t>(al));
+}
+void operator delete[](void* p, std::align_val_t al, const std::nothrow_t&) noexcept {
+    CountedAlignedFree(p, static_cast<size_t>(al));
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+
+// =================== 全局 operator new/delete 计数（只链接进 benchmark 程序） ===================
+// allocCounter.cpp 替换了全部 operator new/delete 形式，按 malloc 实际可用大小计字节，
+// 因此 bytes 含分配器的对齐取整，new/delete 两侧口径一致。计数器为全局原子量，常开。
+
+struct AllocSnapshot {
+    uint64_t allocs = 0;     // 累计分配次数
+    uint64_t frees = 0;      // 累计释放次数
+    uint64_t bytes = 0;      // 累计分配字节
+    uint64_t live = 0;       // 当前存活字节
+    uint64_t peak_live = 0;  // 自上次 ResetAllocPeak 以来的存活字节峰值
+};
+
+AllocSnapshot GetAllocSnapshot();
+
+// 把峰值重置为当前存活字节，用于开始新一段测量
+void ResetAllocPeak();
+
+/**
+ * @brief 接入 benchmark 框架的 MemoryManager，结果出现在 JSON 输出的 allocs_per_iter/max_bytes_used 等字段
+ */
+class CountingMemoryManager : public benchmark::MemoryManager {
+public:
+    void Start() override;
+    void Stop(Result& result) override;
+    // 兼容 1.7.x 中仍为纯虚的旧签名，新版本中只是普通成员函数
+    void Stop(Result* result) { Stop(*result); }
+
+private:
+    AllocSnapshot begin_;
+};
+
+/**
+ * @brief 在控制台结果里直接输出内存 counter
+ *
+ * start() 在计时循环前调用，stop() 在计时循环后调用，产生：
+ *   allocs_per_op  每次迭代的分配次数
+ *   bytes_per_op   每次迭代的分配字节
+ *   peak_live      区间内存活字节峰值相对起点的增量
+ *   rss_delta_MiB  区间前后进程 RSS 差值
+ * 多线程用例只在 thread_index()==0 上调用（counter 会按线程累加）。
+ */
+class BenchMemoryCounters {
+public:
+    void start();
+    void stop(benchmark::State& state);
+
+private:
+    AllocSnapshot begin_;
+    size_t rss_begin_ = 0;
+};
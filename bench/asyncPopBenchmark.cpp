@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+#include "allocCounter.h"
+#include "adapterQueue.h"
+#include "coroExecutor.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// =================== 协程消费者 vs 每消费者一线程 ===================
+// 每轮迭代由生产者推入 batch 个元素，等待全部被 N 个逻辑消费者取走。
+// 负数元素作为毒丸，结束消费者。
+
+static constexpr int kAsyncBatch = 10000;
+
+// ========================== 1. 每消费者一个线程，阻塞 pop ==========================
+static void BM_ThreadPerConsumer(benchmark::State& state) {
+    const int n_consumers = static_cast<int>(state.range(0));
+    AutoShrinkBlockingQueue<int> q;
+    std::atomic<int64_t> consumed{0};
+
+    std::vector<std::thread> consumers;
+    consumers.reserve(n_consumers);
+    for (int i = 0; i < n_consumers; ++i) {
+        consumers.emplace_back([&]{
+            for (;;) {
+                int v = q.pop();
+                if (v < 0) break;
+                consumed.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    int64_t target = 0;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        target += kAsyncBatch;
+        for (int i = 0; i < kAsyncBatch; ++i) q.push(i);
+        while (consumed.load(std::memory_order_relaxed) < target)
+            std::this_thread::yield();
+    }
+    mem.stop(state);
+
+    for (int i = 0; i < n_consumers; ++i) q.push(-1);
+    for (auto& t : consumers) t.join();
+
+    state.counters["os_threads"] = n_consumers;
+    state.SetItemsProcessed(state.iterations() * kAsyncBatch);
+}
+BENCHMARK(BM_ThreadPerConsumer)->Arg(1)->Arg(16)->Arg(256)->Arg(1024)->UseRealTime();
+
+// ========================== 2. 全部消费者协程跑在一个线程上 ==========================
+static DetachedTask AsyncConsumer(AutoShrinkBlockingQueue<int>& q, LoopExecutor& loop,
+                                  std::atomic<int64_t>& consumed, std::atomic<int>& alive) {
+    co_await schedule_on(loop);
+    for (;;) {
+        int v = co_await q.async_pop(loop);
+        if (v < 0) break;
+        consumed.fetch_add(1, std::memory_order_relaxed);
+    }
+    if (alive.fetch_sub(1) == 1) loop.stop();
+}
+
+static void BM_CoroutineConsumersOneThread(benchmark::State& state) {
+    const int n_consumers = static_cast<int>(state.range(0));
+    AutoShrinkBlockingQueue<int> q;
+    LoopExecutor loop;
+    std::atomic<int64_t> consumed{0};
+    std::atomic<int> alive{n_consumers};
+
+    for (int i = 0; i < n_consumers; ++i) AsyncConsumer(q, loop, consumed, alive);
+    std::thread loop_thread([&]{ loop.run(); });
+
+    int64_t target = 0;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        target += kAsyncBatch;
+        for (int i = 0; i < kAsyncBatch; ++i) q.push(i);
+        while (consumed.load(std::memory_order_relaxed) < target)
+            std::this_thread::yield();
+    }
+    mem.stop(state);
+
+    for (int i = 0; i < n_consumers; ++i) q.push(-1);
+    loop_thread.join();
+
+    state.counters["os_threads"] = 1;
+    state.SetItemsProcessed(state.iterations() * kAsyncBatch);
+}
+BENCHMARK(BM_CoroutineConsumersOneThread)->Arg(1)->Arg(16)->Arg(256)->Arg(1024)->Arg(10000)->UseRealTime();
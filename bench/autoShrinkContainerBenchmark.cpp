@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include "allocCounter.h"
+#include "autoShrinkContainers.h"
+#include "containerRetention.h"
+#include <unordered_map>
+#include <vector>
+
+// =================== AutoShrink 容器 vs 标准容器：填满后逐个删除的内存对比 ===================
+// 与 main.cpp DoTest() 的实验相同（10 万个 1KB 对象，插满后逐个删光），
+// 额外输出删光后容器仍持有的字节估算 held_after_drain，以及收缩次数。
+// range(0) = 元素个数
+
+namespace {
+
+struct Data1K {
+    char buf[1024];
+};
+
+template <typename C>
+void SetRetentionCounters(benchmark::State& state, const C& c, size_t shrinks) {
+    state.counters["held_after_drain"] = benchmark::Counter(
+        static_cast<double>(EstimateFootprint(c).allocated_bytes), benchmark::Counter::kDefaults,
+        benchmark::Counter::kIs1024);
+    state.counters["shrinks"] = static_cast<double>(shrinks);
+}
+
+} // namespace
+
+static void BM_StdVectorDrain(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::vector<Data1K> v;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        for (int i = 0; i < n; ++i) v.emplace_back();
+        while (!v.empty()) v.pop_back();
+    }
+    mem.stop(state);
+    SetRetentionCounters(state, v, 0);
+}
+BENCHMARK(BM_StdVectorDrain)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_AutoShrinkVectorDrain(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    AutoShrinkVector<Data1K> v;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        for (int i = 0; i < n; ++i) v.emplace_back();
+        while (!v.empty()) v.pop_back();
+    }
+    mem.stop(state);
+    SetRetentionCounters(state, v, v.shrink_count());
+}
+BENCHMARK(BM_AutoShrinkVectorDrain)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_StdUnorderedMapDrain(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    std::unordered_map<int, Data1K> m;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        for (int i = 0; i < n; ++i) m.emplace(i, Data1K{});
+        for (int i = 0; i < n; ++i) m.erase(i);
+    }
+    mem.stop(state);
+    SetRetentionCounters(state, m, 0);
+}
+BENCHMARK(BM_StdUnorderedMapDrain)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_AutoShrinkUnorderedMapDrain(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    AutoShrinkUnorderedMap<int, Data1K> m;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        for (int i = 0; i < n; ++i) m.emplace(i, Data1K{});
+        for (int i = 0; i < n; ++i) m.erase(i);
+    }
+    mem.stop(state);
+    SetRetentionCounters(state, m, m.shrink_count());
+}
+BENCHMARK(BM_AutoShrinkUnorderedMapDrain)->Arg(1000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// 收缩参数 sweep：range(0)=check_interval，range(1)=shrink_factor*100，观察时间/收缩次数的取舍
+static void BM_AutoShrinkVectorSweep(benchmark::State& state) {
+    AutoShrinkVector<int> v(ShrinkPolicy(static_cast<size_t>(state.range(0)),
+                                         static_cast<float>(state.range(1)) / 100.0f));
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        for (int i = 0; i < 10000; ++i) v.push_back(i);
+        while (!v.empty()) v.pop_back();
+    }
+    mem.stop(state);
+    SetRetentionCounters(state, v, v.shrink_count());
+}
+BENCHMARK(BM_AutoShrinkVectorSweep)->Args({100, 15})->Args({100, 25})->Args({500, 20})->Args({1000, 20});
@@ -0,0 +1,127 @@
+#include <benchmark/benchmark.h>
+#include "allocCounter.h"
+#include "delayQueue.h"
+
+#include <chrono>
+#include <map>
+#include <queue>
+#include <unordered_set>
+#include <vector>
+
+// =================== 重试超时：时间轮延时队列 vs priority_queue / map ===================
+// 每次迭代挂 range(0) 个定时器（deadline 分散在 1ms 内），其中 95% 随即取消（请求按时返回），剩下的等到期取走：
+//   DelayQueue     分层时间轮，O(1) 挂入/取消，突发过后按 ShrinkPolicy 整块释放节点
+//   PriorityQueue  std::priority_queue + 已取消集合（惰性删除），底层 vector 一直保持峰值容量
+//   Map            std::map<(deadline, seq)>，取消即 erase，每个定时器一次节点分配
+// held_after_drain 为全部取走后容器自身仍持有的字节（map 的节点已还给 malloc，记 0，差异体现在 peak_live/rss_delta 上）。
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kCancelPercent = 95;
+
+struct Payload {
+    uint64_t request_id;
+    uint32_t attempt;
+};
+
+Clock::time_point SpreadDeadline(Clock::time_point base, int i) {
+    return base + std::chrono::microseconds(i % 1000);
+}
+
+template <typename C>
+struct ExposedPriorityQueue : std::priority_queue<C, std::vector<C>, std::greater<C>> {
+    size_t capacity() const { return this->c.capacity(); }
+};
+
+void SetHeldCounter(benchmark::State& state, size_t bytes) {
+    state.counters["held_after_drain"] =
+        benchmark::Counter(static_cast<double>(bytes), benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+}
+
+} // namespace
+
+static void BM_RetryTimersDelayQueue(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    DelayQueue<Payload> q;
+    std::vector<DelayQueue<Payload>::TimerId> ids(static_cast<size_t>(n));
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        const auto base = Clock::now();
+        for (int i = 0; i < n; ++i) ids[i] = q.schedule_at(SpreadDeadline(base, i), Payload{static_cast<uint64_t>(i), 1});
+        for (int i = 0; i < n; ++i) {
+            if (i % 100 < kCancelPercent) q.cancel(ids[i]);
+        }
+        while (!q.empty()) benchmark::DoNotOptimize(q.pop());
+    }
+    mem.stop(state);
+    state.SetItemsProcessed(state.iterations() * n);
+    SetHeldCounter(state, q.node_capacity() / DelayQueue<Payload>::kChunkNodes * DelayQueue<Payload>::chunk_bytes());
+    state.counters["shrinks"] = static_cast<double>(q.shrink_count());
+}
+BENCHMARK(BM_RetryTimersDelayQueue)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_RetryTimersPriorityQueue(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    using Entry = std::pair<Clock::time_point, uint64_t>; // (deadline, seq)，payload 放在 seq 对应的表里
+    ExposedPriorityQueue<Entry> q;
+    std::unordered_set<uint64_t> cancelled;
+    std::vector<Payload> payloads(static_cast<size_t>(n));
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        const auto base = Clock::now();
+        for (int i = 0; i < n; ++i) {
+            payloads[i] = Payload{static_cast<uint64_t>(i), 1};
+            q.emplace(SpreadDeadline(base, i), static_cast<uint64_t>(i));
+        }
+        for (int i = 0; i < n; ++i) {
+            if (i % 100 < kCancelPercent) cancelled.insert(static_cast<uint64_t>(i));
+        }
+        while (!q.empty()) {
+            const Entry top = q.top();
+            if (cancelled.erase(top.second) == 0) {
+                while (Clock::now() < top.first) {
+                }
+                benchmark::DoNotOptimize(payloads[top.second]);
+            }
+            q.pop();
+        }
+    }
+    mem.stop(state);
+    state.SetItemsProcessed(state.iterations() * n);
+    SetHeldCounter(state, q.capacity() * sizeof(Entry));
+}
+BENCHMARK(BM_RetryTimersPriorityQueue)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_RetryTimersMap(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    using Map = std::map<std::pair<Clock::time_point, uint64_t>, Payload>;
+    Map m;
+    std::vector<Map::iterator> ids(static_cast<size_t>(n));
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        const auto base = Clock::now();
+        for (int i = 0; i < n; ++i) {
+            ids[i] = m.emplace(std::make_pair(SpreadDeadline(base, i), static_cast<uint64_t>(i)),
+                               Payload{static_cast<uint64_t>(i), 1}).first;
+        }
+        for (int i = 0; i < n; ++i) {
+            if (i % 100 < kCancelPercent) m.erase(ids[i]);
+        }
+        while (!m.empty()) {
+            auto it = m.begin();
+            while (Clock::now() < it->first.first) {
+            }
+            benchmark::DoNotOptimize(it->second);
+            m.erase(it);
+        }
+    }
+    mem.stop(state);
+    state.SetItemsProcessed(state.iterations() * n);
+    SetHeldCounter(state, 0);
+}
+BENCHMARK(BM_RetryTimersMap)->Arg(100000)->Arg(1000000)->Unit(benchmark::kMillisecond);
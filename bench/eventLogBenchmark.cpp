@@ -0,0 +1,89 @@
+#include <benchmark/benchmark.h>
+#include "allocCounter.h"
+#include "eventLog.h"
+#include <spdlog/spdlog.h>
+#include <spdlog/async.h>
+#include <spdlog/sinks/basic_file_sink.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+// =================== 热路径埋点：EventLog vs spdlog 异步 logger ===================
+// 每次迭代记录一条"队列事件"（两个整数参数），对比调用线程上的单条开销。
+// spdlog 一侧与 gain_logger 的配置一致（8192 槽线程池、1 个后台线程、满时阻塞），
+// range(0)=1 时 flush_on(info)，即每条 SPDLOG_INFO 都触发一次 flush，对应原来的配置。
+// EventLog 额外输出 dropped（缓冲满被丢弃的条数），正常应为 0。
+
+namespace {
+
+std::string BenchLogPath(const char* name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+EventLog g_event_log;
+uint16_t g_ev_push = 0;
+
+void StartEventLog(const benchmark::State&) {
+    g_ev_push = g_event_log.register_event("push", "size={} high_mark={}");
+    EventLog::Options opt;
+    opt.ring_capacity = 1 << 18;
+    g_event_log.start(BenchLogPath("bench_queue_events.evlog"), opt);
+}
+
+void StopEventLog(const benchmark::State&) {
+    g_event_log.stop();
+    std::filesystem::remove(BenchLogPath("bench_queue_events.evlog"));
+}
+
+void BM_EventLogRecord(benchmark::State& state) {
+    BenchMemoryCounters mem;
+    if (state.thread_index() == 0) mem.start();
+    uint64_t i = 0;
+    for (auto _ : state) {
+        g_event_log.record(g_ev_push, i, i + 1);
+        ++i;
+    }
+    if (state.thread_index() == 0) {
+        mem.stop(state);
+        state.counters["dropped"] = static_cast<double>(g_event_log.dropped());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EventLogRecord)->Setup(StartEventLog)->Teardown(StopEventLog)
+    ->Threads(1)->Threads(2)->Threads(4)->Threads(8)->UseRealTime();
+
+// async_logger 只持有线程池的 weak_ptr，线程池要单独保活
+std::shared_ptr<spdlog::details::thread_pool> g_spdlog_pool;
+std::shared_ptr<spdlog::async_logger> g_spdlog;
+
+void StartSpdlog(const benchmark::State& state) {
+    g_spdlog_pool = std::make_shared<spdlog::details::thread_pool>(8192, 1);
+    auto sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(BenchLogPath("bench_queue_events.log"), true);
+    g_spdlog = std::make_shared<spdlog::async_logger>("bench_events", sink, g_spdlog_pool,
+                                                      spdlog::async_overflow_policy::block);
+    g_spdlog->flush_on(state.range(0) ? spdlog::level::info : spdlog::level::err);
+}
+
+void StopSpdlog(const benchmark::State&) {
+    g_spdlog->flush();
+    g_spdlog.reset();
+    g_spdlog_pool.reset();
+    std::filesystem::remove(BenchLogPath("bench_queue_events.log"));
+}
+
+void BM_SpdlogAsyncInfo(benchmark::State& state) {
+    BenchMemoryCounters mem;
+    if (state.thread_index() == 0) mem.start();
+    uint64_t i = 0;
+    for (auto _ : state) {
+        g_spdlog->info("push size={} high_mark={}", i, i + 1);
+        ++i;
+    }
+    if (state.thread_index() == 0) mem.stop(state);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SpdlogAsyncInfo)->Setup(StartSpdlog)->Teardown(StopSpdlog)
+    ->ArgName("flush_on_info")->Arg(0)->Arg(1)
+    ->Threads(1)->Threads(4)->UseRealTime();
+
+} // namespace
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+#include "adapterQueue.h"
+#include "cacheLine.h"
+#include "perfCounters.h"
+#include "threadSafeQueue.h"
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// =================== 伪共享回归测试 ===================
+// 1) BM_CounterPerThread：每个线程只累加自己的计数器，紧挨着放 vs 各占一个 cache line。
+//    两者逻辑上完全无共享，差距全部来自伪共享；多核机器上 Packed 的 cycles/l1d_miss 应明显更高。
+// 2) BM_QueueHandoff：1 生产者 + 1 消费者 + 1 个读快照的监控线程，观察队列按 cache line 分组后的每元素开销。
+//    以后调整队列成员布局时对比这里的 cycles_per_item / l1d_miss_per_item，防止回退。
+// perf counter 只在 Linux 且可访问 PMU 时输出（见 perfCounters.h），否则只有耗时。
+
+namespace {
+
+constexpr int kIncrementsPerThread = 2000000;
+constexpr int kHandoffItems = 500000;
+
+template <int N>
+struct PackedCounters {
+    std::atomic<int64_t> c[N];
+    std::atomic<int64_t>& at(int i) { return c[i]; }
+};
+
+template <int N>
+struct PaddedCounters {
+    CacheLinePadded<std::atomic<int64_t>> c[N];
+    std::atomic<int64_t>& at(int i) { return *c[i]; }
+};
+
+} // namespace
+
+// range(0) = 线程数
+template <template <int> class Layout>
+static void BM_CounterPerThread(benchmark::State& state) {
+    const int threads = static_cast<int>(state.range(0));
+    auto counters = std::make_unique<Layout<8>>();
+    PerfCounters perf;
+    perf.start();
+    for (auto _ : state) {
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&counters, t] {
+                std::atomic<int64_t>& mine = counters->at(t);
+                for (int i = 0; i < kIncrementsPerThread; ++i) mine.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        for (auto& w : workers) w.join();
+    }
+    perf.stop(state, static_cast<double>(threads) * kIncrementsPerThread);
+    state.SetItemsProcessed(state.iterations() * threads * kIncrementsPerThread);
+}
+BENCHMARK_TEMPLATE(BM_CounterPerThread, PackedCounters)
+    ->ArgName("threads")->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CounterPerThread, PaddedCounters)
+    ->ArgName("threads")->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+template <typename Q>
+static void BM_QueueHandoff(benchmark::State& state) {
+    auto q = std::make_unique<Q>();
+    PerfCounters perf;
+    perf.start();
+    for (auto _ : state) {
+        std::atomic<bool> done{false};
+        std::thread monitor([&] {
+            size_t sum = 0;
+            while (!done.load(std::memory_order_relaxed)) {
+                sum += q->size();
+                std::this_thread::yield();
+            }
+            benchmark::DoNotOptimize(sum);
+        });
+        std::thread consumer([&] {
+            for (int i = 0; i < kHandoffItems; ++i) benchmark::DoNotOptimize(q->pop());
+        });
+        for (int i = 0; i < kHandoffItems; ++i) q->push(i);
+        consumer.join();
+        done.store(true, std::memory_order_relaxed);
+        monitor.join();
+    }
+    perf.stop(state, kHandoffItems);
+    state.counters["sizeof_queue"] = static_cast<double>(sizeof(Q));
+    state.SetItemsProcessed(state.iterations() * kHandoffItems);
+}
+BENCHMARK_TEMPLATE(BM_QueueHandoff, ThreadSafeQueue<int>)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_QueueHandoff, AutoShrinkBlockingQueue<int>)->UseRealTime()->Unit(benchmark::kMillisecond);
@@ -0,0 +1,107 @@
+#include <benchmark/benchmark.h>
+#include "allocCounter.h"
+#include "queueAdapters.h"
+#include "latencyHistogram.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// =================== push -> pop 端到端延迟分位 ===================
+// 生产者在 push 前打时间戳，消费者 pop 后立即计算差值记入直方图，
+// 以 p50/p99/p99.9/max 作为 counter 输出（单位 ns）。
+// range(0) = 生产者线程数，range(1) = 每个生产者两次 push 之间的间隔 ns（0 表示满速压测）
+
+namespace {
+
+template <size_t Bytes>
+struct TimedPayload {
+    static_assert(Bytes >= sizeof(int64_t), "payload too small");
+    int64_t push_ns;
+    char pad[Bytes - sizeof(int64_t)];
+};
+
+inline int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+inline void SpinFor(int64_t ns) {
+    if (ns <= 0) return;
+    int64_t end = NowNs() + ns;
+    while (NowNs() < end) {}
+}
+
+constexpr int kLatencyBatch = 20000; // 每次迭代所有生产者合计推入的元素数
+
+} // namespace
+
+template <typename Adapter, size_t Bytes>
+static void BM_HandoffLatency(benchmark::State& state) {
+    using Payload = TimedPayload<Bytes>;
+    const int n_producers = static_cast<int>(state.range(0));
+    const int64_t gap_ns = state.range(1);
+    const int per_producer = kLatencyBatch / n_producers;
+    const int total = per_producer * n_producers;
+
+    LatencyHistogram hist;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        Adapter a;
+        std::atomic<bool> go{false};
+        std::thread consumer([&]{
+            Payload p;
+            for (int i = 0; i < total; ++i) {
+                a.pop(p);
+                hist.record(static_cast<uint64_t>(NowNs() - p.push_ns));
+            }
+        });
+        std::vector<std::thread> producers;
+        for (int t = 0; t < n_producers; ++t) {
+            producers.emplace_back([&]{
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                Payload p{};
+                for (int i = 0; i < per_producer; ++i) {
+                    p.push_ns = NowNs();
+                    while (!a.try_push(p)) std::this_thread::yield();
+                    SpinFor(gap_ns);
+                }
+            });
+        }
+        go.store(true, std::memory_order_release);
+        for (auto& t : producers) t.join();
+        consumer.join();
+    }
+    mem.stop(state);
+
+    state.SetLabel(Adapter::kName);
+    state.SetItemsProcessed(state.iterations() * total);
+    state.counters["p50_ns"] = static_cast<double>(hist.percentile(50));
+    state.counters["p99_ns"] = static_cast<double>(hist.percentile(99));
+    state.counters["p99.9_ns"] = static_cast<double>(hist.percentile(99.9));
+    state.counters["max_ns"] = static_cast<double>(hist.max());
+}
+
+static void LatencyArgs(benchmark::internal::Benchmark* b) {
+    for (int producers : {1, 4, 16}) {
+        for (int gap : {0, 2000}) b->Args({producers, gap});
+    }
+    b->ArgNames({"producers", "gap_ns"})->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+#define REGISTER_LATENCY(Adapter, Bytes)                                              \
+    BENCHMARK_TEMPLATE(BM_HandoffLatency, Adapter<TimedPayload<Bytes>>, Bytes)        \
+        ->Apply(LatencyArgs)
+
+// 三种队列 × 三种元素大小，同一组参数并排输出
+REGISTER_LATENCY(ThreadSafeQueueAdapter, 16);
+REGISTER_LATENCY(AutoShrinkQueueAdapter, 16);
+REGISTER_LATENCY(BoostLockFreeAdapter, 16);
+REGISTER_LATENCY(ThreadSafeQueueAdapter, 256);
+REGISTER_LATENCY(AutoShrinkQueueAdapter, 256);
+REGISTER_LATENCY(BoostLockFreeAdapter, 256);
+REGISTER_LATENCY(ThreadSafeQueueAdapter, 1024);
+REGISTER_LATENCY(AutoShrinkQueueAdapter, 1024);
+REGISTER_LATENCY(BoostLockFreeAdapter, 1024);
@@ -0,0 +1,90 @@
+#include <benchmark/benchmark.h>
+#include "allocCounter.h"
+#include "adapterQueue.h"
+#include "threadSafeQueue.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// =================== 监控线程轮询 size/empty/last_high_mark 对生产者吞吐的影响 ===================
+// 场景：进程里有 kMonitoredQueues 个队列，其中第 0 个是热队列（range(0) 个生产者 + 1 个消费者），
+// 监控线程按 range(1) 的模式轮询全部队列的 size()/empty()/last_high_mark()：
+//   0 = 不轮询（基线）；1 = 1kHz 轮询；2 = 不停轮询（压力上限）。
+// size/empty/last_high_mark 读的是原子快照，不碰队列锁，三种模式下的生产者吞吐应基本一致。
+
+namespace {
+
+constexpr size_t kMonitoredQueues = 256;
+constexpr int kItemsPerProducer = 200000;
+
+// 只有 AutoShrinkBlockingQueue 有高水位，ThreadSafeQueue 用 size 代替
+template <typename Q>
+size_t HighMarkOf(const Q& q) {
+    if constexpr (requires { q.last_high_mark(); }) {
+        return q.last_high_mark();
+    } else {
+        return q.size();
+    }
+}
+
+} // namespace
+
+template <typename Q>
+static void BM_ProducerWithMonitor(benchmark::State& state) {
+    const int producers = static_cast<int>(state.range(0));
+    const int poll_mode = static_cast<int>(state.range(1));
+    std::vector<std::unique_ptr<Q>> queues;
+    for (size_t i = 0; i < kMonitoredQueues; ++i) queues.push_back(std::make_unique<Q>());
+    Q& hot = *queues[0];
+
+    uint64_t polls = 0;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        std::atomic<bool> done{false};
+        std::thread monitor;
+        if (poll_mode != 0) {
+            monitor = std::thread([&] {
+                auto next = std::chrono::steady_clock::now();
+                while (!done.load(std::memory_order_relaxed)) {
+                    size_t total = 0;
+                    for (auto& q : queues) total += q->size() + (q->empty() ? 0 : 1) + HighMarkOf(*q);
+                    benchmark::DoNotOptimize(total);
+                    ++polls;
+                    if (poll_mode == 1) {
+                        next += std::chrono::milliseconds(1);
+                        std::this_thread::sleep_until(next);
+                    }
+                }
+            });
+        }
+        std::thread consumer([&] {
+            for (int i = 0; i < producers * kItemsPerProducer; ++i) benchmark::DoNotOptimize(hot.pop());
+        });
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < kItemsPerProducer; ++i) hot.push(i);
+            });
+        }
+        for (auto& t : threads) t.join();
+        consumer.join();
+        done.store(true, std::memory_order_relaxed);
+        if (monitor.joinable()) monitor.join();
+    }
+    mem.stop(state);
+    state.counters["polls"] = benchmark::Counter(static_cast<double>(polls), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * producers * kItemsPerProducer);
+}
+
+static void MonitorArgs(benchmark::internal::Benchmark* b) {
+    for (int producers : {1, 4}) {
+        for (int mode : {0, 1, 2}) b->Args({producers, mode});
+    }
+    b->ArgNames({"producers", "poll"})->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK_TEMPLATE(BM_ProducerWithMonitor, ThreadSafeQueue<int>)->Apply(MonitorArgs);
+BENCHMARK_TEMPLATE(BM_ProducerWithMonitor, AutoShrinkBlockingQueue<int>)->Apply(MonitorArgs);
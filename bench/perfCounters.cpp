@@ -0,0 +1,79 @@
+#include "perfCounters.h"
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstring>
+#endif
+
+namespace {
+
+#if defined(__linux__)
+int OpenCounter(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = 1;
+    attr.inherit = 1;
+    attr.exclude_kernel = 1; // perf_event_paranoid=2 时普通用户只允许统计用户态
+    attr.exclude_hv = 1;
+    return static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+
+constexpr uint64_t kL1dReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                  (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+#endif
+
+const char* const kCounterNames[] = {"cycles_per_item", "instr_per_item", "cache_miss_per_item",
+                                     "l1d_miss_per_item"};
+
+} // namespace
+
+PerfCounters::~PerfCounters() {
+#if defined(__linux__)
+    for (int& fd : fds_) {
+        if (fd >= 0) ::close(fd);
+        fd = -1;
+    }
+#endif
+}
+
+void PerfCounters::start() {
+#if defined(__linux__)
+    const struct { uint32_t type; uint64_t config; } events[kEvents] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HW_CACHE, kL1dReadMiss},
+    };
+    for (int i = 0; i < kEvents; ++i) {
+        if (fds_[i] < 0) fds_[i] = OpenCounter(events[i].type, events[i].config);
+        if (fds_[i] >= 0) {
+            ::ioctl(fds_[i], PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fds_[i], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+void PerfCounters::stop(benchmark::State& state, double items_per_iter) {
+    state.counters["perf_available"] = available() ? 1 : 0;
+#if defined(__linux__)
+    const double per = items_per_iter > 0 ? items_per_iter : 1.0;
+    for (int i = 0; i < kEvents; ++i) {
+        if (fds_[i] < 0) continue;
+        ::ioctl(fds_[i], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t value = 0;
+        if (::read(fds_[i], &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value))) continue;
+        state.counters[kCounterNames[i]] =
+            benchmark::Counter(static_cast<double>(value) / per, benchmark::Counter::kAvgIterations);
+    }
+#else
+    (void)items_per_iter;
+    (void)kCounterNames;
+#endif
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+
+// =================== 硬件性能计数器（Linux perf_event_open，其它平台为空实现） ===================
+// 在调用线程上开启计数，inherit=1，之后由该线程创建的工作线程也计入（线程退出时累加到父计数器），
+// 所以要在创建工作线程之前 start()，在 join 之后 stop()。
+// 容器 / 虚拟机里常常拿不到 PMU，此时 available()==false，stop() 只输出 perf_available=0。
+
+class PerfCounters {
+public:
+    PerfCounters() = default;
+    ~PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void start();
+
+    /**
+     * @brief 停止计数并写入 counter（按迭代平均后再除以 items_per_iter，即每个元素的事件数）：
+     *   cycles_per_item / instr_per_item / cache_miss_per_item / l1d_miss_per_item
+     */
+    void stop(benchmark::State& state, double items_per_iter);
+
+    bool available() const { return fds_[0] >= 0; }
+
+private:
+    static constexpr int kEvents = 4;
+    int fds_[kEvents] = {-1, -1, -1, -1};
+};
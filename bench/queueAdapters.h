@@ -0,0 +1,137 @@
+#pragma once
+
+#include <optional>
+#include <thread>
+#include <utility>
+#include <cstddef>
+#include <limits>
+#include <boost/lockfree/queue.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+#include "adapterQueue.h"
+#include "basicQueue.h"
+#include "threadSafeQueue.h"
+#include "twoLockQueue.h"
+
+// =================== 统一的队列适配层（只给 benchmark 用） ===================
+// 每个适配器提供：
+//   kName                名字，用于 benchmark 标签
+//   try_push(v) -> bool  有界/无锁队列可能失败，调用方自行重试
+//   try_pop(out) -> bool 非阻塞
+//   pop(out)             阻塞直到取到元素；无锁队列用自旋 + yield 模拟
+//   kMultiProducer       是否允许多个生产者/消费者并发访问
+//   kCapacity            可容纳的最大元素数，无界为 size_t 最大值
+
+template <typename T>
+struct ThreadSafeQueueAdapter {
+    static constexpr const char* kName = "ThreadSafeQueue";
+    static constexpr bool kMultiProducer = true;
+    static constexpr size_t kCapacity = std::numeric_limits<size_t>::max();
+    ThreadSafeQueue<T> q;
+
+    bool try_push(const T& v) { q.push(v); return true; }
+    bool try_pop(T& out) {
+        auto v = q.try_pop();
+        if (!v) return false;
+        out = std::move(*v);
+        return true;
+    }
+    void pop(T& out) { out = q.pop(); }
+};
+
+template <typename T>
+struct AutoShrinkQueueAdapter {
+    static constexpr const char* kName = "AutoShrinkBlockingQueue";
+    static constexpr bool kMultiProducer = true;
+    static constexpr size_t kCapacity = std::numeric_limits<size_t>::max();
+    AutoShrinkBlockingQueue<T> q;
+
+    bool try_push(const T& v) { q.push(v); return true; }
+    bool try_pop(T& out) {
+        auto v = q.try_pop();
+        if (!v) return false;
+        out = std::move(*v);
+        return true;
+    }
+    void pop(T& out) { out = q.pop(); }
+};
+
+// 策略组合的 BasicQueue：不同存储/锁/等待/收缩组合各注册一个，ThreadSafeQueue 即其中的 deque+mutex+condvar+NoShrink
+template <typename T, typename Storage, typename Lock, typename Wait, typename Shrink = NoShrink>
+struct BasicQueueAdapter {
+    static constexpr const char* kName = "BasicQueue";
+    static constexpr bool kMultiProducer = true;
+    static constexpr size_t kCapacity = std::numeric_limits<size_t>::max();
+    BasicQueue<T, Storage, Lock, Wait, Shrink> q;
+
+    bool try_push(const T& v) { q.push(v); return true; }
+    bool try_pop(T& out) {
+        auto v = q.try_pop();
+        if (!v) return false;
+        out = std::move(*v);
+        return true;
+    }
+    void pop(T& out) { out = q.pop(); }
+};
+
+// 头尾分锁：生产者与消费者各拿各的锁，队列非空时两端不互相等待
+template <typename T>
+struct TwoLockQueueAdapter {
+    static constexpr const char* kName = "TwoLockQueue";
+    static constexpr bool kMultiProducer = true;
+    static constexpr size_t kCapacity = std::numeric_limits<size_t>::max();
+    TwoLockQueue<T> q;
+
+    bool try_push(const T& v) { q.push(v); return true; }
+    bool try_pop(T& out) {
+        auto v = q.try_pop();
+        if (!v) return false;
+        out = std::move(*v);
+        return true;
+    }
+    void pop(T& out) { out = q.pop(); }
+};
+
+// 非固定容量：节点不够时动态 new，pop 后节点回到内部 freelist，不归还系统
+template <typename T>
+struct BoostLockFreeAdapter {
+    static constexpr const char* kName = "boost::lockfree::queue";
+    static constexpr bool kMultiProducer = true;
+    static constexpr size_t kCapacity = std::numeric_limits<size_t>::max();
+    boost::lockfree::queue<T> q{128};
+
+    bool try_push(const T& v) { return q.push(v); }
+    bool try_pop(T& out) { return q.pop(out); }
+    void pop(T& out) {
+        while (!q.pop(out)) std::this_thread::yield();
+    }
+};
+
+// 固定容量：节点数组一次性分配，满时 push 失败；容量受 16 位节点索引限制，最大 65534
+template <typename T, size_t N = 65534>
+struct BoostLockFreeFixedAdapter {
+    static constexpr const char* kName = "boost::lockfree::queue<capacity>";
+    static constexpr bool kMultiProducer = true;
+    static constexpr size_t kCapacity = N;
+    boost::lockfree::queue<T, boost::lockfree::capacity<N>> q;
+
+    bool try_push(const T& v) { return q.push(v); }
+    bool try_pop(T& out) { return q.pop(out); }
+    void pop(T& out) {
+        while (!q.pop(out)) std::this_thread::yield();
+    }
+};
+
+// 单生产者单消费者环形缓冲，环内保留一个空槽，实际可用 N - 1
+template <typename T, size_t N = 65536>
+struct BoostSpscAdapter {
+    static constexpr const char* kName = "boost::lockfree::spsc_queue";
+    static constexpr bool kMultiProducer = false;
+    static constexpr size_t kCapacity = N - 1;
+    boost::lockfree::spsc_queue<T, boost::lockfree::capacity<N>> q;
+
+    bool try_push(const T& v) { return q.push(v); }
+    bool try_pop(T& out) { return q.pop(out); }
+    void pop(T& out) {
+        while (!q.pop(out)) std::this_thread::yield();
+    }
+};
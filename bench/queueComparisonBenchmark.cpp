@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+#include "allocCounter.h"
+#include "queueAdapters.h"
+#include "memoryStats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// =================== 统一对比：同一组场景跑遍所有队列 ===================
+// 场景（range(0)=生产者数，range(1)=消费者数，range(2)=是否先灌满再排空）：
+//   SPSC 1:1、MPSC 20:1、MPSC 100:1、MPMC 4:4、burst-then-drain 1:1
+// 输出吞吐（items_per_second）以及相对构造队列前的 RSS 增量：
+//   peak_MiB     运行期间 RSS 峰值增量（后台线程 1ms 采样；burst 场景另在灌满瞬间取一次）
+//   drained_MiB  全部元素出队后、队列析构前的 RSS 增量，即队列排空后仍持有的内存
+// spsc_queue 只参与 1:1 场景；固定容量队列在 burst 场景下只灌到容量上限。
+// RSS 是进程级数值，前面用例释放给 malloc 的内存会被后面复用而不体现为增长，
+// 对比内存时请用 --benchmark_filter 每次只跑一个队列。
+
+namespace {
+
+struct Msg64 {
+    uint64_t id;
+    char pad[56];
+};
+
+constexpr int kCompareTotal = 200000; // 每次迭代所有生产者合计推入的元素数
+
+double ToMiB(size_t bytes) { return static_cast<double>(bytes) / (1024.0 * 1024.0); }
+
+// 后台 RSS 峰值采样
+class RssPeakSampler {
+public:
+    explicit RssPeakSampler(size_t baseline) : peak_(baseline) {
+        thread_ = std::thread([this] {
+            while (!stop_.load(std::memory_order_relaxed)) {
+                observe(GetProcessRssBytes());
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+    }
+    ~RssPeakSampler() { stop(); }
+
+    void observe(size_t rss) {
+        size_t cur = peak_.load(std::memory_order_relaxed);
+        while (rss > cur && !peak_.compare_exchange_weak(cur, rss, std::memory_order_relaxed)) {}
+    }
+    size_t stop() {
+        stop_.store(true, std::memory_order_relaxed);
+        if (thread_.joinable()) thread_.join();
+        return peak_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<size_t> peak_;
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+} // namespace
+
+template <typename Adapter>
+static void BM_QueueCompare(benchmark::State& state) {
+    const int n_producers = static_cast<int>(state.range(0));
+    const int n_consumers = static_cast<int>(state.range(1));
+    const bool burst = state.range(2) != 0;
+    const int total = burst
+        ? static_cast<int>(std::min<size_t>(kCompareTotal, Adapter::kCapacity))
+        : kCompareTotal;
+    const int per_producer = total / n_producers;
+    const int per_consumer = total / n_consumers;
+
+    double peak_mib = 0.0;
+    double drained_mib = 0.0;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        size_t baseline = GetProcessRssBytes();
+        RssPeakSampler sampler(baseline);
+        // spsc/固定容量的环形缓冲是对象内数组，放堆上避免撑爆栈
+        auto a = std::make_unique<Adapter>();
+
+        auto produce = [&](int id) {
+            Msg64 m{};
+            for (int i = 0; i < per_producer; ++i) {
+                m.id = static_cast<uint64_t>(id) * per_producer + i;
+                while (!a->try_push(m)) std::this_thread::yield();
+            }
+        };
+        auto consume = [&] {
+            Msg64 m;
+            for (int i = 0; i < per_consumer; ++i) {
+                a->pop(m);
+                benchmark::DoNotOptimize(m);
+            }
+        };
+
+        std::vector<std::thread> producers;
+        std::vector<std::thread> consumers;
+        if (burst) {
+            for (int t = 0; t < n_producers; ++t) producers.emplace_back(produce, t);
+            for (auto& t : producers) t.join();
+            sampler.observe(GetProcessRssBytes());
+            for (int t = 0; t < n_consumers; ++t) consumers.emplace_back(consume);
+            for (auto& t : consumers) t.join();
+        } else {
+            for (int t = 0; t < n_consumers; ++t) consumers.emplace_back(consume);
+            for (int t = 0; t < n_producers; ++t) producers.emplace_back(produce, t);
+            for (auto& t : producers) t.join();
+            for (auto& t : consumers) t.join();
+        }
+
+        size_t peak = sampler.stop();
+        size_t drained = GetProcessRssBytes();
+        peak_mib = std::max(peak_mib, ToMiB(peak > baseline ? peak - baseline : 0));
+        drained_mib = ToMiB(drained > baseline ? drained - baseline : 0);
+    }
+    mem.stop(state);
+
+    state.SetLabel(Adapter::kName);
+    state.SetItemsProcessed(state.iterations() * per_producer * n_producers);
+    state.counters["peak_MiB"] = peak_mib;
+    state.counters["drained_MiB"] = drained_mib;
+}
+
+template <typename Adapter>
+static void CompareArgs(benchmark::internal::Benchmark* b) {
+    b->Args({1, 1, 0});       // SPSC
+    if constexpr (Adapter::kMultiProducer) {
+        b->Args({20, 1, 0});  // MPSC 20:1
+        b->Args({100, 1, 0}); // MPSC 100:1
+        b->Args({4, 4, 0});   // MPMC
+    }
+    b->Args({1, 1, 1});       // burst-then-drain
+    b->ArgNames({"producers", "consumers", "burst"})->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+#define REGISTER_COMPARE(...) \
+    BENCHMARK_TEMPLATE(BM_QueueCompare, __VA_ARGS__)->Apply(CompareArgs<__VA_ARGS__>)
+
+REGISTER_COMPARE(ThreadSafeQueueAdapter<Msg64>);
+REGISTER_COMPARE(AutoShrinkQueueAdapter<Msg64>);
+REGISTER_COMPARE(TwoLockQueueAdapter<Msg64>);
+REGISTER_COMPARE(BasicQueueAdapter<Msg64, RingStorage, MutexLock, CondVarWait, ShrinkPolicy>);
+REGISTER_COMPARE(BasicQueueAdapter<Msg64, RingStorage, SpinLock, YieldWait>);
+REGISTER_COMPARE(BoostLockFreeAdapter<Msg64>);
+REGISTER_COMPARE(BoostLockFreeFixedAdapter<Msg64>);
+REGISTER_COMPARE(BoostSpscAdapter<Msg64>);
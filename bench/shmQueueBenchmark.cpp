@@ -0,0 +1,109 @@
+#if defined(__linux__)
+
+#include <benchmark/benchmark.h>
+#include "shmQueue.h"
+
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstring>
+#include <string>
+
+// =================== 跨进程交接：共享内存队列 vs socket ===================
+// fork 出的生产者进程推 range(0) 条 64 字节消息，本进程（消费者）逐条取出，计时覆盖整批交接：
+//   ShmQueue    POSIX 共享内存环形队列，空/满时在 futex 上阻塞
+//   SocketPair  AF_UNIX SOCK_STREAM，每条消息一次 write/read，对应现在的 socket 方案
+// 两边都只有一份消息拷贝进出内核或共享内存，差异主要是每条消息的系统调用和唤醒开销。
+
+namespace {
+
+struct Msg {
+    uint64_t seq;
+    char payload[56];
+};
+
+constexpr size_t kShmCapacity = 4096;
+
+bool ReadFull(int fd, void* buf, size_t len) {
+    char* p = static_cast<char*>(buf);
+    while (len != 0) {
+        ssize_t n = ::read(fd, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool WriteFull(int fd, const void* buf, size_t len) {
+    const char* p = static_cast<const char*>(buf);
+    while (len != 0) {
+        ssize_t n = ::write(fd, p, len);
+        if (n <= 0) return false;
+        p += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+static void BM_CrossProcessShmQueue(benchmark::State& state) {
+    const uint64_t n = static_cast<uint64_t>(state.range(0));
+    const std::string name = "/shm_queue_bench_" + std::to_string(::getpid());
+    ShmQueue<Msg>::remove(name);
+    ShmQueue<Msg> q;
+    if (!q.create(name, kShmCapacity)) {
+        state.SkipWithError("shm_open failed");
+        return;
+    }
+    for (auto _ : state) {
+        pid_t child = ::fork();
+        if (child == 0) {
+            ShmQueue<Msg> producer;
+            if (!producer.open(name)) ::_exit(1);
+            for (uint64_t i = 0; i < n; ++i) producer.push(Msg{i, {}});
+            ::_exit(0);
+        }
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < n; ++i) sum += q.pop().seq;
+        benchmark::DoNotOptimize(sum);
+        ::waitpid(child, nullptr, 0);
+    }
+    ShmQueue<Msg>::remove(name);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+    state.counters["shm_KB"] = static_cast<double>(q.allocated_bytes()) / 1024.0;
+}
+BENCHMARK(BM_CrossProcessShmQueue)->Arg(200000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_CrossProcessSocketPair(benchmark::State& state) {
+    const uint64_t n = static_cast<uint64_t>(state.range(0));
+    for (auto _ : state) {
+        int fds[2];
+        if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+            state.SkipWithError("socketpair failed");
+            return;
+        }
+        pid_t child = ::fork();
+        if (child == 0) {
+            ::close(fds[0]);
+            for (uint64_t i = 0; i < n; ++i) {
+                Msg m{i, {}};
+                if (!WriteFull(fds[1], &m, sizeof(m))) ::_exit(1);
+            }
+            ::_exit(0);
+        }
+        ::close(fds[1]);
+        uint64_t sum = 0;
+        Msg m;
+        for (uint64_t i = 0; i < n && ReadFull(fds[0], &m, sizeof(m)); ++i) sum += m.seq;
+        benchmark::DoNotOptimize(sum);
+        ::close(fds[0]);
+        ::waitpid(child, nullptr, 0);
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(n));
+}
+BENCHMARK(BM_CrossProcessSocketPair)->Arg(200000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+#endif // __linux__
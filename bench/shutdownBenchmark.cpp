@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include "adapterQueue.h"
+#include <memory>
+#include <span>
+#include <string>
+#include <thread>
+
+// =================== 停机/回收对调用线程的占用 ===================
+// 队列里压着 range(0) 个带堆内存的元素，只计调用线程上花掉的时间：
+//   Inline   直接析构队列，逐个析构元素、归还块都在调用线程上
+//   Detached detach_storage() 摘走存储后交给后台线程析构，调用线程只付 O(1) 的 swap
+//   Drain    close() + drain(sink) 分批交给 sink（这里 sink 只是丢弃），对应有序停机
+
+namespace {
+
+using Payload = std::string;
+
+Payload MakePayload(int i) {
+    return Payload(64, static_cast<char>('a' + i % 26)); // 超出 SSO，每个元素一次堆分配
+}
+
+std::unique_ptr<AutoShrinkBlockingQueue<Payload>> FilledQueue(int n) {
+    auto q = std::make_unique<AutoShrinkBlockingQueue<Payload>>();
+    for (int i = 0; i < n; ++i) q->push(MakePayload(i));
+    return q;
+}
+
+} // namespace
+
+static void BM_TeardownInline(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto q = FilledQueue(n);
+        state.ResumeTiming();
+        q.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_TeardownInline)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_TeardownDetached(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto q = FilledQueue(n);
+        std::thread reaper;
+        state.ResumeTiming();
+        reaper = std::thread([s = q->detach_storage()]() mutable { s.clear(); });
+        q.reset();
+        state.PauseTiming();
+        reaper.join();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_TeardownDetached)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// range(1) = 每批个数
+static void BM_CloseAndDrain(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const size_t batch = static_cast<size_t>(state.range(1));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto q = FilledQueue(n);
+        state.ResumeTiming();
+        q->close();
+        size_t drained = q->drain([](std::span<Payload> items) { benchmark::DoNotOptimize(items.data()); }, batch);
+        benchmark::DoNotOptimize(drained);
+    }
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_CloseAndDrain)->Args({100000, 64})->Args({100000, 1024})->Unit(benchmark::kMillisecond);
@@ -0,0 +1,96 @@
+#include <benchmark/benchmark.h>
+#include "allocCounter.h"
+#include "memoryStats.h"
+#include "slabAllocator.h"
+#include <list>
+#include <map>
+#include <memory>
+
+// =================== 节点容器：std::allocator vs 每容器 SlabAllocator ===================
+// 检查点与 DoTest 的 list / map 段一致：插入 N 个 1KB 对象 -> 隔一个删一个 -> 全部删光，
+// 额外输出删光后（容器仍存活）相对插入前的 RSS 增量 rss_after_erase_MiB。
+// 为了不被其它 benchmark 复用的 malloc 空闲内存干扰，对比内存时请用 --benchmark_filter 单独运行。
+
+namespace {
+
+struct Node1K {
+    char buf[1024];
+};
+
+double RssMiB() { return static_cast<double>(GetProcessRssBytes()) / (1024.0 * 1024.0); }
+
+template <typename List>
+void ListCheckpoints(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    double rss_after_erase = 0.0;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        double before = RssMiB();
+        List l;
+        for (int i = 0; i < n; ++i) l.emplace_back();
+        int idx = 0;
+        for (auto it = l.begin(); it != l.end(); ++idx) it = (idx % 2 == 0) ? l.erase(it) : std::next(it);
+        while (!l.empty()) l.pop_front();
+        rss_after_erase = RssMiB() - before;
+    }
+    mem.stop(state);
+    state.counters["rss_after_erase_MiB"] = rss_after_erase;
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+template <typename Map>
+void MapCheckpoints(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    double rss_after_erase = 0.0;
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        double before = RssMiB();
+        Map m;
+        for (int i = 0; i < n; ++i) m.emplace(i, Node1K{});
+        for (int i = 0; i < n; i += 2) m.erase(i);
+        for (int i = 1; i < n; i += 2) m.erase(i);
+        rss_after_erase = RssMiB() - before;
+    }
+    mem.stop(state);
+    state.counters["rss_after_erase_MiB"] = rss_after_erase;
+    state.SetItemsProcessed(state.iterations() * n);
+}
+
+} // namespace
+
+static void BM_StdListCheckpoints(benchmark::State& state) {
+    ListCheckpoints<std::list<Node1K>>(state);
+}
+BENCHMARK(BM_StdListCheckpoints)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_SlabListCheckpoints(benchmark::State& state) {
+    ListCheckpoints<std::list<Node1K, SlabAllocator<Node1K>>>(state);
+}
+BENCHMARK(BM_SlabListCheckpoints)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_StdMapCheckpoints(benchmark::State& state) {
+    MapCheckpoints<std::map<int, Node1K>>(state);
+}
+BENCHMARK(BM_StdMapCheckpoints)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_SlabMapCheckpoints(benchmark::State& state) {
+    MapCheckpoints<std::map<int, Node1K, std::less<int>, SlabAllocator<std::pair<const int, Node1K>>>>(state);
+}
+BENCHMARK(BM_SlabMapCheckpoints)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+// 小节点：热路径分配速度（int 链表 push/pop）
+template <typename List>
+static void BM_SmallNodeChurn(benchmark::State& state) {
+    List l;
+    for (auto _ : state) {
+        l.push_back(1);
+        l.push_back(2);
+        l.pop_front();
+        l.pop_front();
+    }
+    state.SetItemsProcessed(state.iterations() * 2);
+}
+BENCHMARK_TEMPLATE(BM_SmallNodeChurn, std::list<int>);
+BENCHMARK_TEMPLATE(BM_SmallNodeChurn, std::list<int, SlabAllocator<int>>);
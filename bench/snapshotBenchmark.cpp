@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+#include "adapterQueue.h"
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+
+// =================== 队列快照与热重启 ===================
+// BM_SnapshotWrite   range(0) 条 64B 记录写成快照（4MB 块顺序写 + rename）
+// BM_WarmRestart     同样的记录重新装进一个空队列：
+//   restore=1  restore_from：mmap 读快照、锁外解码、整批换入
+//   restore=0  基线：从上游重放，逐条 push
+// 快照写在系统临时目录下，页缓存是热的，测的是 CPU 侧开销而不是冷盘读。
+
+namespace {
+
+struct Msg64 {
+    uint64_t id;
+    char pad[56];
+};
+
+std::string SnapshotPath() {
+    return (std::filesystem::temp_directory_path() / "queue_snapshot_bench.qsnap").string();
+}
+
+std::unique_ptr<AutoShrinkBlockingQueue<Msg64>> FilledQueue(int n) {
+    auto q = std::make_unique<AutoShrinkBlockingQueue<Msg64>>();
+    Msg64 m{};
+    for (int i = 0; i < n; ++i) {
+        m.id = static_cast<uint64_t>(i);
+        q->push(m);
+    }
+    return q;
+}
+
+} // namespace
+
+static void BM_SnapshotWrite(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    auto q = FilledQueue(n);
+    for (auto _ : state) {
+        if (!q->snapshot_to(SnapshotPath())) {
+            state.SkipWithError("snapshot_to failed");
+            break;
+        }
+    }
+    std::filesystem::remove(SnapshotPath());
+    state.SetItemsProcessed(state.iterations() * n);
+    state.SetBytesProcessed(state.iterations() * n * static_cast<int64_t>(sizeof(Msg64) + sizeof(uint32_t)));
+}
+BENCHMARK(BM_SnapshotWrite)->Arg(1000000)->Unit(benchmark::kMillisecond);
+
+static void BM_WarmRestart(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const bool restore = state.range(1) != 0;
+    if (!FilledQueue(n)->snapshot_to(SnapshotPath())) {
+        state.SkipWithError("snapshot_to failed");
+        return;
+    }
+    std::vector<Msg64> upstream(static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) upstream[static_cast<size_t>(i)].id = static_cast<uint64_t>(i);
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto q = std::make_unique<AutoShrinkBlockingQueue<Msg64>>();
+        state.ResumeTiming();
+        if (restore) {
+            benchmark::DoNotOptimize(q->restore_from(SnapshotPath()));
+        } else {
+            for (const Msg64& m : upstream) q->push(m);
+        }
+        state.PauseTiming();
+        q.reset();
+        state.ResumeTiming();
+    }
+    std::filesystem::remove(SnapshotPath());
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_WarmRestart)
+    ->ArgNames({"records", "restore"})
+    ->Args({1000000, 0})
+    ->Args({1000000, 1})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+#include "adapterQueue.h"
+#include "memoryStats.h"
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+
+// =================== 消费者停滞时的积压：纯内存 vs 溢出到磁盘 ===================
+// 先灌入 range(0) 条 1KB 记录（消费者停滞），再全部取出；range(1)=1 时开启 enable_spill，内存阈值 8MiB。
+// 输出：
+//   filled_MiB  灌满时相对构造前的 RSS 增量（纯内存模式约等于 积压条数 × 1KB）
+//   drained_MiB 全部取出后仍持有的 RSS 增量
+//   spilled     灌满时在磁盘上的条数
+// 段文件写在系统临时目录下；RSS 是进程级数值，请用 --benchmark_filter 单独跑一组。
+
+namespace {
+
+struct Record1K {
+    uint64_t id;
+    char payload[1016];
+};
+
+constexpr double kMiB = 1024.0 * 1024.0;
+
+} // namespace
+
+static void BM_StalledConsumerBacklog(benchmark::State& state) {
+    const int n = static_cast<int>(state.range(0));
+    const bool spill = state.range(1) != 0;
+    const std::string dir = (std::filesystem::temp_directory_path() / "queue_spill_bench").string();
+    double filled = 0, drained = 0, spilled = 0;
+    for (auto _ : state) {
+        const size_t base = GetProcessRssBytes();
+        auto q = std::make_unique<AutoShrinkBlockingQueue<Record1K>>();
+        if (spill) {
+            SpillOptions o;
+            o.directory = dir;
+            o.memory_limit_bytes = 8u << 20;
+            if (!q->enable_spill(o)) {
+                state.SkipWithError("spill directory unavailable");
+                break;
+            }
+        }
+        Record1K r{};
+        for (int i = 0; i < n; ++i) {
+            r.id = static_cast<uint64_t>(i);
+            q->push(r);
+        }
+        filled = std::max(filled, (static_cast<double>(GetProcessRssBytes()) - base) / kMiB);
+        if (spill) spilled = static_cast<double>(q->spilled());
+        for (int i = 0; i < n; ++i) benchmark::DoNotOptimize(q->pop());
+        drained = std::max(drained, (static_cast<double>(GetProcessRssBytes()) - base) / kMiB);
+    }
+    std::filesystem::remove_all(dir);
+    state.counters["filled_MiB"] = filled;
+    state.counters["drained_MiB"] = drained;
+    state.counters["spilled"] = spilled;
+    state.SetItemsProcessed(state.iterations() * n);
+}
+BENCHMARK(BM_StalledConsumerBacklog)
+    ->ArgNames({"records", "spill"})
+    ->Args({200000, 0})
+    ->Args({200000, 1})
+    ->Iterations(2)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+#include "allocCounter.h"
+#include "stripedHashMap.h"
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// =================== 分段锁自动收缩哈希表 vs 一把锁包 std::unordered_map ===================
+// 场景：在途请求跟踪，每个线程反复 插入请求 id -> 查找 -> 完成后删除。
+// 全局一把锁的对照组与 ThreadSafeQueue 包 std::queue 的做法相同。
+
+// 对照组：一把锁 + std::unordered_map，接口与 StripedHashMap 对齐
+template <typename K, typename V>
+class LockedUnorderedMap {
+public:
+    bool insert(const K& key, const V& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return map_.try_emplace(key, value).second;
+    }
+    std::optional<V> find(const K& key) const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = map_.find(key);
+        if (it == map_.end()) return std::nullopt;
+        return it->second;
+    }
+    bool erase(const K& key) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return map_.erase(key) != 0;
+    }
+    size_t bucket_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return map_.bucket_count();
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<K, V> map_;
+};
+
+namespace {
+
+struct InFlight {
+    uint64_t start_ns;
+    uint64_t conn_id;
+    char pad[48];
+};
+
+constexpr uint64_t kInFlightOpsPerThread = 20000; // 每次迭代每个线程处理的请求数
+
+} // namespace
+
+// range(0) = 线程数，range(1) = 每个线程同时在途的请求数
+template <typename Map>
+static void BM_InFlightTracking(benchmark::State& state) {
+    const int n_threads = static_cast<int>(state.range(0));
+    const uint64_t window = static_cast<uint64_t>(state.range(1));
+    Map m;
+
+    BenchMemoryCounters mem;
+    mem.start();
+    for (auto _ : state) {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < n_threads; ++t) {
+            threads.emplace_back([&m, t, window] {
+                const uint64_t base = static_cast<uint64_t>(t) << 40;
+                for (uint64_t next = 0; next < kInFlightOpsPerThread; ++next) {
+                    uint64_t id = base + next;
+                    m.insert(id, InFlight{next, id, {}});
+                    benchmark::DoNotOptimize(m.find(id));
+                    if (next >= window) m.erase(base + next - window);
+                }
+                // 收尾：剩余在途请求全部完成
+                for (uint64_t i = kInFlightOpsPerThread - std::min(window, kInFlightOpsPerThread);
+                     i < kInFlightOpsPerThread; ++i) {
+                    m.erase(base + i);
+                }
+            });
+        }
+        for (auto& th : threads) th.join();
+    }
+    mem.stop(state);
+    state.counters["buckets_after_drain"] = static_cast<double>(m.bucket_count());
+    state.SetItemsProcessed(state.iterations() * n_threads * kInFlightOpsPerThread);
+}
+
+static void InFlightArgs(benchmark::internal::Benchmark* b) {
+    for (int threads : {1, 2, 4, 8}) {
+        for (int window : {64, 4096}) b->Args({threads, window});
+    }
+    b->ArgNames({"threads", "window"})->UseRealTime()->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK_TEMPLATE(BM_InFlightTracking, LockedUnorderedMap<uint64_t, InFlight>)->Apply(InFlightArgs);
+BENCHMARK_TEMPLATE(BM_InFlightTracking, StripedHashMap<uint64_t, InFlight>)->Apply(InFlightArgs);
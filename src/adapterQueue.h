@@ -1,143 +1,497 @@
 #pragma once
 
+#include <algorithm>
+#include <coroutine>
 #include <deque>
-#include <mutex>
-#include <condition_variable>
+#include <iterator>
+#include <memory>
 #include <optional>
+#include <string>
 #include <type_traits>
+#include <utility>
+
+#include "basicQueue.h"
+#include "coroExecutor.h"
+#include "containerRetention.h"
+#include "queueClosedError.h"
+#include "spillStore.h"
+#include "queueSnapshot.h"
+
+/**
+ * @brief 可溢出到磁盘的 deque 存储（BasicQueue 存储策略）：未开启溢出时与 DequeStorage 相同
+ *
+ * enable_spill 之后，内存部分超过阈值（或溢出区非空，保证 FIFO）的新元素追加写到 SpillStore，
+ * 内存部分取空时立即按顺序读回一批，维持"内存部分为空则整个存储为空"。
+ * size() 含溢出区，resident_size() 只算内存部分；收缩只重建内存部分，溢出区不动。
+ */
+struct SpillDequeStorage {
+    template <typename T>
+    class container {
+    public:
+        template <typename... Args>
+        void emplace_back(Args&&... args) {
+            if constexpr (SpillCodable<T>) {
+                if (spill_) {
+                    append_spillable(T(std::forward<Args>(args)...));
+                    return;
+                }
+            }
+            d_.emplace_back(std::forward<Args>(args)...);
+        }
+        T take_front() {
+            T v = std::move(d_.front());
+            d_.pop_front();
+            if constexpr (SpillCodable<T>) {
+                if (spill_) {
+                    size_t bytes = SpillStore<T>::memory_bytes_of(v);
+                    memory_bytes_ -= bytes < memory_bytes_ ? bytes : memory_bytes_;
+                    if (d_.empty() && !spill_->empty()) refill();
+                }
+            }
+            return v;
+        }
+        bool empty() const { return d_.empty(); }
+        size_t size() const {
+            if constexpr (SpillCodable<T>) {
+                if (spill_) return d_.size() + spill_->size();
+            }
+            return d_.size();
+        }
+        size_t resident_size() const { return d_.size(); }
+        void rebuild(std::optional<container>& retired) {
+            // 用 move 迭代器转移（支持 move-only 类型，无拷贝）
+            retired.emplace();
+            retired->d_ = std::deque<T>(std::make_move_iterator(d_.begin()), std::make_move_iterator(d_.end()));
+            d_.swap(retired->d_);
+        }
+        size_t allocated_bytes(size_t high_mark) const { return EstimateFootprint(d_, high_mark).allocated_bytes; }
+
+        // ---- 以下供 AutoShrinkBlockingQueue 使用 ----
+
+        const std::deque<T>& resident() const { return d_; }
+        const SpillStore<T>* spill() const { return spill_.get(); }
+
+        /**
+         * @brief 挂上溢出区，已开启时返回 false（store 保持不动）
+         */
+        bool enable_spill(std::unique_ptr<SpillStore<T>>& store) requires SpillCodable<T> {
+            if (spill_) return false;
+            memory_bytes_ = 0;
+            for (const T& v : d_) memory_bytes_ += SpillStore<T>::memory_bytes_of(v);
+            spill_ = std::move(store);
+            return true;
+        }
+
+        /**
+         * @brief 摘走内存部分；溢出区非空时随即读回一批
+         */
+        std::deque<T> detach_resident() {
+            std::deque<T> detached;
+            detached.swap(d_);
+            memory_bytes_ = 0;
+            if constexpr (SpillCodable<T>) {
+                if (spill_ && !spill_->empty()) refill();
+            }
+            return detached;
+        }
+
+        /**
+         * @brief 为空且未开启溢出时整体换入 loaded（换下的空 deque 留在 loaded 中）；否则返回 false，由调用方逐个入队
+         */
+        bool adopt(std::deque<T>& loaded) {
+            if (!d_.empty() || spill_) return false;
+            d_.swap(loaded);
+            return true;
+        }
+
+    private:
+        void append_spillable(T&& v) {
+            if (!spill_->empty() || memory_bytes_ >= spill_->options().memory_limit_bytes) {
+                spill_->append(std::move(v));
+                return;
+            }
+            memory_bytes_ += SpillStore<T>::memory_bytes_of(v);
+            d_.push_back(std::move(v));
+        }
+
+        void refill() { spill_->pop_into(d_, spill_->options().refill_batch, memory_bytes_); }
+
+        std::deque<T> d_;
+        // 磁盘溢出区（未开启时为空）及内存部分的估算字节数
+        std::unique_ptr<SpillStore<T>> spill_;
+        size_t memory_bytes_ = 0;
+    };
+};
+
+/**
+ * @brief 协程等待策略（BasicQueue 异步等待策略）：挂起的 async_pop / async_push 以侵入式 FIFO 链表登记在队列上，
+ *        由各自的执行器在锁外恢复
+ * @note 节点位于协程帧内的 awaiter 中，挂起期间地址不变，无额外分配。
+ *       消费者节点仅在队列为空时存在，生产者节点仅在有界且满时存在
+ */
+struct CoroWaiters {
+    template <typename T>
+    class waiters {
+    public:
+        struct pop_node {
+            CoroExecutor* ex = nullptr;
+            std::coroutine_handle<> handle;
+            std::optional<T> slot; // 交到的元素；恢复时为空表示队列已关闭
+            pop_node* next = nullptr;
+        };
+
+        struct push_node {
+            push_node(CoroExecutor& e, T&& v) : ex(&e), value(std::move(v)) {}
+            CoroExecutor* ex;
+            std::coroutine_handle<> handle;
+            T value;
+            bool rejected = false; // 恢复时为 true 表示队列已关闭，元素未入队
+            push_node* next = nullptr;
+        };
+
+        template <typename W>
+        struct list {
+            W* head = nullptr;
+            W* tail = nullptr;
+            bool empty() const { return head == nullptr; }
+            void push_back(W* w) {
+                w->next = nullptr;
+                if (tail) tail->next = w; else head = w;
+                tail = w;
+            }
+            W* pop_front() {
+                W* w = head;
+                if (w) {
+                    head = w->next;
+                    if (!head) tail = nullptr;
+                }
+                return w;
+            }
+        };
+
+        class pending {
+        public:
+            void resume() {
+                while (pop_node* p = pops_.pop_front()) p->ex->post(p->handle);
+                while (push_node* p = pushes_.pop_front()) p->ex->post(p->handle);
+            }
+
+        private:
+            friend class waiters;
+            list<pop_node> pops_;
+            list<push_node> pushes_;
+        };
+
+        bool consumer_waiting() const noexcept { return !pops_.empty(); }
+
+        void hand_off(T&& value, pending& p) {
+            pop_node* w = pops_.pop_front();
+            w->slot.emplace(std::move(value));
+            p.pops_.push_back(w);
+        }
+
+        template <typename Put>
+        bool admit_producer(Put&& put, pending& p) {
+            push_node* w = pushes_.pop_front();
+            if (!w) return false;
+            put(std::move(w->value));
+            p.pushes_.push_back(w);
+            return true;
+        }
+
+        void close(pending& p) {
+            while (pop_node* w = pops_.pop_front()) p.pops_.push_back(w);
+            while (push_node* w = pushes_.pop_front()) {
+                w->rejected = true;
+                p.pushes_.push_back(w);
+            }
+        }
+
+        void wait_pop(pop_node* w) { pops_.push_back(w); }
+        void wait_push(push_node* w) { pushes_.push_back(w); }
+
+    private:
+        list<pop_node> pops_;
+        list<push_node> pushes_;
+    };
+};
 
 /**
  * @brief 自动收缩、线程安全的阻塞队列
- * 
+ *
  * T 必须可 move 构造和 move 赋值
- * 提供线程安全的 push/pop/try_pop/size/empty，自动按需收缩内存
+ * 同步部分（push/pop/try_pop/drain_into/drain/close/收缩/通知器/eventfd）即 BasicQueue 的
+ * AutoShrinkQueue 组合，只是存储换成可溢出的 SpillDequeStorage、异步等待策略为 CoroWaiters；本类在其上增加：
+ * 提供协程接口 co_await async_pop() / co_await async_push()，挂起的协程由执行器恢复，不占用线程
+ * Linux 下可开启 eventfd 模式接入 epoll 事件循环，配合 drain_into 批量消费
+ * 有序停机：close() 拒绝后续入队并唤醒所有等待者，再用 drain(sink) 分批把剩余元素交给 sink（sink 在锁外执行）；
+ * 也可以用 detach_storage() O(1) 摘走整个底层存储，交给后台线程析构，不占用延迟敏感线程
+ * 可编解码的 T（见 SpillCodec）可开启 enable_spill：内存部分超过阈值后，新元素追加写到磁盘段文件，
+ * 内存部分取空时按顺序分批读回，整体仍是 FIFO，消费者长时间停滞时 RSS 有上界
+ * 同样的 T 可用 snapshot_to / restore_from 把积压元素存成快照文件，重启后整批载回（见 queueSnapshot.h）
  * 注意：size/empty 仅为快照，不能用于并发逻辑判断
+ * 成员布局沿用 BasicQueue 的 cache line 分组（只读配置 / 锁内状态 / 两个条件变量 / 快照）
  */
 template <typename T>
-class AutoShrinkBlockingQueue {
-    static_assert(std::is_move_constructible<T>::value,
-                  "AutoShrinkBlockingQueue: T must be move constructible");
+class AutoShrinkBlockingQueue
+    : public BasicQueue<T, SpillDequeStorage, MutexLock, CondVarWait, ShrinkPolicy, SnapshotStats, CoroWaiters> {
     static_assert(std::is_move_assignable<T>::value,
                   "AutoShrinkBlockingQueue: T must be move assignable");
 
+    using base = BasicQueue<T, SpillDequeStorage, MutexLock, CondVarWait, ShrinkPolicy, SnapshotStats, CoroWaiters>;
+    using typename base::storage_type;
+    using typename base::lock_type;
+    using typename base::async_type;
+    using typename base::pending_type;
+
 public:
+    class PopAwaiter;
+    class PushAwaiter;
+
     /**
      * @param shrink_check_interval 每多少次 pop/try_pop 检查一次是否需要 shrink
      * @param shrink_factor 当前队长低于 high mark 的 shrink_factor 时触发 shrink（推荐 0.15~0.25）
+     * @param capacity 队列容量上限，0 表示不限（有界模式下 push 满时阻塞，async_push 满时挂起）
      */
     explicit AutoShrinkBlockingQueue(
         size_t shrink_check_interval = 150,
-        float shrink_factor = 0.25f
+        float shrink_factor = 0.25f,
+        size_t capacity = 0
     )
-        : shrink_check_interval_(shrink_check_interval),
-          shrink_factor_(shrink_factor),
-          op_count_(0),
-          last_high_mark_(0)
+        : base(shrink_check_interval, shrink_factor, capacity)
     {}
 
-    AutoShrinkBlockingQueue(const AutoShrinkBlockingQueue&) = delete;
-    AutoShrinkBlockingQueue& operator=(const AutoShrinkBlockingQueue&) = delete;
-
     /**
-     * @brief 线程安全入队
+     * @brief O(1) 摘走内存中的底层存储，返回的 deque 由调用方决定在哪个线程析构
+     * @note 未开启磁盘溢出时队列变为空。开启溢出时只摘走内存部分（即最早的那批元素），磁盘上的积压保留在队列中，
+     *       随即按 refill_batch 读回一批，因此之后 size() 可能不为 0，FIFO 顺序不变
+     * @note 有界模式下会接纳挂起的协程生产者并唤醒阻塞的 push；high mark 随之归零（计入一次 shrink）
      */
-    void push(const T& value) {
+    std::deque<T> detach_storage() {
+        std::deque<T> detached;
+        pending_type admitted;
+        bool any_admitted = false;
         {
-            std::unique_lock<std::mutex> lock(mutex_);
-            queue_.push_back(value);
-            if (queue_.size() > last_high_mark_) {
-                last_high_mark_ = queue_.size();
+            lock_type lock(mutex_);
+            detached = storage_.detach_resident();
+            shrink_.on_shrunk(0);
+            shrink_.on_grow(storage_.resident_size());
+            while (storage_.size() < capacity_) {
+                bool into_empty = false;
+                if (!this->admit_locked(admitted, into_empty)) break;
+                any_admitted = true;
             }
+            this->publish_locked();
         }
-        cond_empty_.notify_one();
-    }
-    void push(T&& value) {
-        {
-            std::unique_lock<std::mutex> lock(mutex_);
-            queue_.push_back(std::move(value));
-            if (queue_.size() > last_high_mark_) {
-                last_high_mark_ = queue_.size();
+        if (capacity_ != 0) {
+            not_full_.notify_all();
+            if (any_admitted) {
+                not_empty_.notify_all();
+                this->notify_external(true);
+                admitted.resume();
             }
         }
-        cond_empty_.notify_one();
+        return detached;
     }
 
     /**
-     * @brief 阻塞直到有数据，线程安全
-     * @return 出队元素
-     * @note 如果 T 的移动构造/赋值抛异常，队列元素将丢失
+     * @brief 协程出队：T v = co_await q.async_pop(ex);
+     * @param ex 数据到达后用于恢复协程的执行器，默认在生产者线程上就地恢复
+     * @note 有数据时不挂起；为空时协程挂起并登记在等待链表中，push 直接把元素交给最早的等待者。
+     *       协程等待者优先于阻塞在 pop() 上的线程获得新元素。
      */
-    T pop() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        cond_empty_.wait(lock, [this]{ return !queue_.empty(); });
-        T val = std::move(queue_.front());
-        queue_.pop_front();
-        auto_shrink();
-        return val;
+    PopAwaiter async_pop(CoroExecutor& ex = InlineExecutor::instance()) {
+        return PopAwaiter(*this, ex);
     }
 
     /**
-     * @brief 非阻塞尝试出队，线程安全
-     * @return 有数据时返回元素，否则返回空
+     * @brief 协程入队：co_await q.async_push(v, ex);
+     * @note 仅在有界模式且队列已满时挂起，pop 腾出空位后由 ex 恢复；无界模式下等价于 push
      */
-    std::optional<T> try_pop() {
-        std::unique_lock<std::mutex> lock(mutex_);
-        if (queue_.empty()) return std::nullopt;
-        T val = std::move(queue_.front());
-        queue_.pop_front();
-        auto_shrink();
-        return val;
+    PushAwaiter async_push(T value, CoroExecutor& ex = InlineExecutor::instance()) {
+        return PushAwaiter(*this, ex, std::move(value));
     }
 
     /**
-     * @brief 队列当前元素数，仅做信息快照，不可用于业务并发逻辑
+     * @brief 估算收缩能回收的字节数（按历史高水位推算 deque 囤积的块），仅作为信息描述
      */
-    size_t size() const {
-        std::unique_lock<std::mutex> lock(mutex_);
-        return queue_.size();
+    size_t reclaimable_bytes() const {
+        lock_type lock(mutex_);
+        return EstimateFootprint(storage_.resident(), shrink_.high_mark()).reclaimable();
     }
 
     /**
-     * @brief 队列是否为空，仅做信息快照，不可用于业务并发逻辑
+     * @brief 开启磁盘溢出模式（仅限有 SpillCodec 的 T），可在任意时刻调用，重复调用返回 false
+     * @return 目录不可用或已开启时返回 false
+     * @note 读回发生在出队线程上、持锁期间（缺页读盘），溢出是为消费者长时间停滞兜底，不是常态路径
      */
-    bool empty() const {
-        std::unique_lock<std::mutex> lock(mutex_);
-        return queue_.empty();
+    bool enable_spill(SpillOptions options) requires SpillCodable<T> {
+        auto store = std::make_unique<SpillStore<T>>(std::move(options));
+        if (!store->prepare()) return false;
+        lock_type lock(mutex_);
+        return storage_.enable_spill(store);
     }
 
     /**
-     * @brief 返回历史最大队列长度，仅作为信息描述
+     * @brief 当前在溢出区（磁盘段 + 写盘失败时的内存暂存）的元素数，仅作为信息描述
      */
-    size_t last_high_mark() const {
-        std::unique_lock<std::mutex> lock(mutex_);
-        return last_high_mark_;
+    size_t spilled() const requires SpillCodable<T> {
+        lock_type lock(mutex_);
+        const SpillStore<T>* spill = storage_.spill();
+        return spill ? spill->size() : 0;
     }
 
-private:
-    // 自动 shrink 原则：每 shrink_check_interval 次 pop 检查一次
-    void auto_shrink() {
-        ++op_count_;
-        if (op_count_ >= shrink_check_interval_) {
-            op_count_ = 0;
-             // 空队列也允许 shrink，这样内存和 high_mark 也能归零，行为语义更自然 ===
-            if (queue_.empty() || queue_.size() < last_high_mark_ * shrink_factor_) {
-                // 用move迭代器高效转移（支持move-only类型，无拷贝)
-                // 如果元素类型不可 move，可fallback到常规 copy 构造法
-                std::deque<T> newq(std::make_move_iterator(queue_.begin()),
-                                   std::make_move_iterator(queue_.end()));
-                queue_.swap(newq);
-                last_high_mark_ = queue_.size();// 空时会归零
+    /**
+     * @brief 当前段文件个数，仅作为信息描述
+     */
+    size_t spill_segments() const requires SpillCodable<T> {
+        lock_type lock(mutex_);
+        const SpillStore<T>* spill = storage_.spill();
+        return spill ? spill->segments() : 0;
+    }
+
+    /**
+     * @brief 把当前全部元素（含溢出区）按 FIFO 顺序写成快照文件，队列内容不变
+     * @return 写入失败返回 false，目标路径上原有的文件保持不变
+     * @note 持锁期间按 4MB 块顺序写文件，生产者/消费者会被阻塞；通常在 close() 之后、进程退出前调用
+     */
+    bool snapshot_to(const std::string& path) const requires SpillCodable<T> {
+        queue_snapshot_detail::SnapshotWriter writer(path);
+        if (!writer.ok()) return false; // 临时文件打不开（目录不存在、只读、无权限），不必持锁遍历
+        {
+            lock_type lock(mutex_);
+            for (const T& v : storage_.resident()) writer.append(v);
+            if (const SpillStore<T>* spill = storage_.spill()) {
+                spill->visit([&](const char* data, size_t bytes, size_t records) { writer.append_raw(data, bytes, records); },
+                             [&](const T& v) { writer.append(v); });
             }
         }
+        return writer.commit();
+    }
+
+    /**
+     * @brief 从快照文件整批载入元素，追加到队尾（挂起的协程消费者先拿到最前面的元素）
+     * @return 文件不存在/损坏、队列已关闭，或有界模式下放不下时返回 false，此时队列不变
+     * @note mmap 读取、解码都在锁外完成；队列为空且未开启溢出时直接换入整个存储，不逐个 push
+     */
+    bool restore_from(const std::string& path) requires SpillCodable<T> {
+        std::deque<T> loaded;
+        if (!queue_snapshot_detail::ReadSnapshot<T>(path, loaded)) return false;
+        if (loaded.empty()) return true;
+        pending_type served;
+        bool was_empty = false;
+        {
+            lock_type lock(mutex_);
+            if (closed_) return false;
+            if (capacity_ != 0 && storage_.size() + loaded.size() > capacity_) return false;
+            while (!loaded.empty() && async_.consumer_waiting()) {
+                async_.hand_off(std::move(loaded.front()), served);
+                loaded.pop_front();
+            }
+            was_empty = storage_.empty();
+            if (!storage_.adopt(loaded)) { // 换下来的空 deque 随 loaded 在锁外析构
+                for (T& v : loaded) storage_.emplace_back(std::move(v));
+            }
+            shrink_.on_grow(storage_.resident_size());
+            this->publish_locked();
+        }
+        served.resume();
+        if (!this->empty()) {
+            not_empty_.notify_all();
+            this->notify_external(was_empty);
+        }
+        return true;
     }
 
-    mutable std::mutex mutex_;
-    std::condition_variable cond_empty_;
-    std::deque<T> queue_;
+    // ========== 协程 awaiter ==========
+    // awaiter 对象位于协程帧内，挂起期间其中的节点以侵入式链表挂在队列上，无额外分配
 
-    // shrink参数及高水位
-    const size_t shrink_check_interval_;
-    const float shrink_factor_;
-    size_t op_count_;
-    size_t last_high_mark_;
-};
\ No newline at end of file
+    class PopAwaiter {
+    public:
+        PopAwaiter(AutoShrinkBlockingQueue& q, CoroExecutor& ex) : q_(q) { node_.ex = &ex; }
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            node_.handle = h;
+            return q_.suspend_pop(&node_);
+        }
+        T await_resume() {
+            if (!node_.slot) throw QueueClosedError(); // 队列已关闭且为空
+            return std::move(*node_.slot);
+        }
+
+    private:
+        AutoShrinkBlockingQueue& q_;
+        typename async_type::pop_node node_;
+    };
+
+    class PushAwaiter {
+    public:
+        PushAwaiter(AutoShrinkBlockingQueue& q, CoroExecutor& ex, T&& value)
+            : q_(q), node_(ex, std::move(value)) {}
+
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> h) {
+            node_.handle = h;
+            return q_.suspend_push(&node_);
+        }
+        void await_resume() const {
+            if (node_.rejected) throw QueueClosedError();
+        }
+
+    private:
+        AutoShrinkBlockingQueue& q_;
+        typename async_type::push_node node_;
+    };
+
+private:
+    using base::capacity_;
+    using base::mutex_;
+    using base::storage_;
+    using base::shrink_;
+    using base::closed_;
+    using base::async_;
+    using base::not_empty_;
+    using base::not_full_;
+
+    // 返回 true 表示协程已挂起登记；false 表示已取到数据（或队列已关闭且为空），协程直接继续
+    bool suspend_pop(typename async_type::pop_node* w) {
+        std::optional<storage_type> retired;
+        pending_type admitted;
+        bool any = false;
+        bool into_empty = false;
+        {
+            lock_type lock(mutex_);
+            if (storage_.empty()) {
+                if (closed_) return false; // slot 为空，await_resume 抛 QueueClosedError
+                async_.wait_pop(w);
+                return true;
+            }
+            w->slot.emplace(this->take_front_locked(retired));
+            any = this->admit_locked(admitted, into_empty);
+            this->publish_locked();
+        }
+        this->after_slot_freed(any, into_empty, admitted);
+        return false;
+    }
+
+    bool suspend_push(typename async_type::push_node* w) {
+        pending_type handed;
+        bool was_empty = false;
+        bool direct;
+        {
+            lock_type lock(mutex_);
+            if (closed_) {
+                w->rejected = true;
+                return false;
+            }
+            if (capacity_ != 0 && storage_.size() >= capacity_) {
+                async_.wait_push(w);
+                return true;
+            }
+            direct = this->enqueue_locked(handed, was_empty, std::move(w->value));
+        }
+        this->after_enqueue(direct, was_empty, handed);
+        return false;
+    }
+};
@@ -8,6 +8,7 @@
 #include <atomic>
 #include <optional>
 #include <cassert>
+#include <cstring>
 #include <spdlog/spdlog.h>
 #include "util.h"
 
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "shrinkPolicy.h"
+#include "containerRetention.h"
+
+/**
+ * @brief 自动收缩的 vector：pop_back/erase/clear 后按 Policy 摊还地 shrink_to_fit
+ *
+ * 接口是 std::vector 的常用子集，非线程安全（与 std::vector 一致）。
+ * 任何删除操作都可能触发收缩并使迭代器、引用失效；只读/追加操作与 std::vector 的失效规则相同。
+ */
+template <typename T, typename Policy = ShrinkPolicy>
+class AutoShrinkVector {
+public:
+    using value_type = T;
+    using iterator = typename std::vector<T>::iterator;
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    explicit AutoShrinkVector(Policy policy = Policy()) : policy_(std::move(policy)) {}
+
+    void push_back(const T& value) {
+        vec_.push_back(value);
+        policy_.on_grow(vec_.size());
+    }
+    void push_back(T&& value) {
+        vec_.push_back(std::move(value));
+        policy_.on_grow(vec_.size());
+    }
+    template <typename... Args>
+    T& emplace_back(Args&&... args) {
+        T& ref = vec_.emplace_back(std::forward<Args>(args)...);
+        policy_.on_grow(vec_.size());
+        return ref;
+    }
+
+    void pop_back() {
+        vec_.pop_back();
+        after_remove(1);
+    }
+
+    /**
+     * @return 被删元素之后位置的迭代器（触发收缩时已按新缓冲重新定位）
+     */
+    iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+    iterator erase(const_iterator first, const_iterator last) {
+        size_t removed = static_cast<size_t>(last - first);
+        auto offset = first - vec_.cbegin();
+        iterator next = vec_.erase(first, last);
+        if (after_remove(removed)) return vec_.begin() + offset;
+        return next;
+    }
+
+    /**
+     * @brief 删除所有满足 pred 的元素，最多触发一次收缩
+     * @return 删除的元素个数
+     */
+    template <typename Pred>
+    size_t erase_if(Pred pred) {
+        size_t removed = std::erase_if(vec_, pred);
+        if (removed) after_remove(removed);
+        return removed;
+    }
+
+    void clear() {
+        size_t removed = vec_.size();
+        vec_.clear();
+        after_remove(removed);
+    }
+
+    void reserve(size_t n) { vec_.reserve(n); }
+
+    /**
+     * @brief 立即收缩（不等策略触发），high mark 同步降到当前元素数
+     */
+    void shrink_to_fit() {
+        ShrinkContainer(vec_);
+        policy_.on_shrunk(vec_.size());
+    }
+
+    T& operator[](size_t i) { return vec_[i]; }
+    const T& operator[](size_t i) const { return vec_[i]; }
+    T& front() { return vec_.front(); }
+    const T& front() const { return vec_.front(); }
+    T& back() { return vec_.back(); }
+    const T& back() const { return vec_.back(); }
+    T* data() { return vec_.data(); }
+    const T* data() const { return vec_.data(); }
+    iterator begin() { return vec_.begin(); }
+    iterator end() { return vec_.end(); }
+    const_iterator begin() const { return vec_.begin(); }
+    const_iterator end() const { return vec_.end(); }
+
+    size_t size() const { return vec_.size(); }
+    bool empty() const { return vec_.empty(); }
+    size_t capacity() const { return vec_.capacity(); }
+
+    size_t high_mark() const { return policy_.high_mark(); }
+    size_t shrink_count() const { return policy_.shrink_count(); }
+    const std::vector<T>& underlying() const { return vec_; }
+
+private:
+    // 返回 true 表示发生了收缩
+    bool after_remove(size_t removed) {
+        if (!policy_.on_remove(vec_.size(), removed)) return false;
+        shrink_to_fit();
+        return true;
+    }
+
+    std::vector<T> vec_;
+    Policy policy_;
+};
+
+/**
+ * @brief 自动收缩的 unordered_map：erase/clear 后按 Policy 摊还地把桶数组缩回与当前元素数相称的大小
+ *
+ * 接口是 std::unordered_map 的常用子集，非线程安全。
+ * 按 key 删除、erase_if、clear 可能触发收缩（rehash，迭代器失效，引用不失效）；
+ * 按迭代器删除为了保证返回的迭代器可继续遍历，只计数不收缩，欠下的收缩在下一次按 key 删除时补上。
+ */
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEq = std::equal_to<K>,
+          typename Policy = ShrinkPolicy>
+class AutoShrinkUnorderedMap {
+public:
+    using map_type = std::unordered_map<K, V, Hash, KeyEq>;
+    using value_type = typename map_type::value_type;
+    using iterator = typename map_type::iterator;
+    using const_iterator = typename map_type::const_iterator;
+
+    explicit AutoShrinkUnorderedMap(Policy policy = Policy()) : policy_(std::move(policy)) {}
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args) {
+        auto r = map_.emplace(std::forward<Args>(args)...);
+        if (r.second) policy_.on_grow(map_.size());
+        return r;
+    }
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+        auto r = map_.try_emplace(key, std::forward<Args>(args)...);
+        if (r.second) policy_.on_grow(map_.size());
+        return r;
+    }
+    std::pair<iterator, bool> insert(const value_type& value) { return emplace(value); }
+    std::pair<iterator, bool> insert(value_type&& value) { return emplace(std::move(value)); }
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+        auto r = map_.insert_or_assign(key, std::forward<M>(value));
+        if (r.second) policy_.on_grow(map_.size());
+        return r;
+    }
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+    iterator find(const K& key) { return map_.find(key); }
+    const_iterator find(const K& key) const { return map_.find(key); }
+    V& at(const K& key) { return map_.at(key); }
+    const V& at(const K& key) const { return map_.at(key); }
+    bool contains(const K& key) const { return map_.find(key) != map_.end(); }
+    size_t count(const K& key) const { return map_.count(key); }
+
+    size_t erase(const K& key) {
+        size_t removed = map_.erase(key);
+        if (removed || shrink_pending_) after_remove(removed);
+        return removed;
+    }
+
+    iterator erase(const_iterator pos) {
+        iterator next = map_.erase(pos);
+        if (policy_.on_remove(map_.size())) shrink_pending_ = true;
+        return next;
+    }
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+    /**
+     * @brief 删除所有满足 pred 的元素，最多触发一次收缩
+     * @return 删除的元素个数
+     */
+    template <typename Pred>
+    size_t erase_if(Pred pred) {
+        size_t removed = std::erase_if(map_, pred);
+        if (removed || shrink_pending_) after_remove(removed);
+        return removed;
+    }
+
+    void clear() {
+        size_t removed = map_.size();
+        map_.clear();
+        after_remove(removed);
+    }
+
+    /**
+     * @brief 立即收缩桶数组（不等策略触发），high mark 同步降到当前元素数
+     */
+    void shrink_to_fit() {
+        shrink_pending_ = false;
+        ShrinkContainer(map_);
+        policy_.on_shrunk(map_.size());
+    }
+
+    iterator begin() { return map_.begin(); }
+    iterator end() { return map_.end(); }
+    const_iterator begin() const { return map_.begin(); }
+    const_iterator end() const { return map_.end(); }
+
+    size_t size() const { return map_.size(); }
+    bool empty() const { return map_.empty(); }
+    size_t bucket_count() const { return map_.bucket_count(); }
+
+    size_t high_mark() const { return policy_.high_mark(); }
+    size_t shrink_count() const { return policy_.shrink_count(); }
+    const map_type& underlying() const { return map_; }
+
+private:
+    void after_remove(size_t removed) {
+        bool due = policy_.on_remove(map_.size(), removed) || shrink_pending_;
+        if (due) shrink_to_fit();
+    }
+
+    map_type map_;
+    Policy policy_;
+    bool shrink_pending_ = false;
+};
+
+// 接入 ContainerRetentionRegistry：估算的是包装内的标准容器
+template <typename T, typename P>
+ContainerFootprint EstimateFootprint(const AutoShrinkVector<T, P>& c, size_t high_water = 0) {
+    return EstimateFootprint(c.underlying(), high_water);
+}
+template <typename T, typename P>
+void ShrinkContainer(AutoShrinkVector<T, P>& c) { c.shrink_to_fit(); }
+template <typename T, typename P>
+const char* ContainerKindName(const AutoShrinkVector<T, P>&) { return "auto_shrink_vector"; }
+
+template <typename K, typename V, typename H, typename E, typename P>
+ContainerFootprint EstimateFootprint(const AutoShrinkUnorderedMap<K, V, H, E, P>& c, size_t high_water = 0) {
+    return EstimateFootprint(c.underlying(), high_water);
+}
+template <typename K, typename V, typename H, typename E, typename P>
+void ShrinkContainer(AutoShrinkUnorderedMap<K, V, H, E, P>& c) { c.shrink_to_fit(); }
+template <typename K, typename V, typename H, typename E, typename P>
+const char* ContainerKindName(const AutoShrinkUnorderedMap<K, V, H, E, P>&) { return "auto_shrink_unordered_map"; }
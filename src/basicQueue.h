@@ -0,0 +1,470 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "cacheLine.h"
+#include "eventFdNotifier.h"
+#include "queueClosedError.h"
+#include "queueNotifier.h"
+#include "queuePolicies.h"
+#include "shrinkPolicy.h"
+
+/**
+ * @brief 按编译期策略组合的线程安全队列，push/pop 只维护这一份
+ *
+ * @tparam Storage   存储策略（DequeStorage / RingStorage）
+ * @tparam Lock      锁策略（MutexLock / SpinLock）
+ * @tparam Wait      等待策略（CondVarWait / YieldWait）
+ * @tparam Shrink    收缩策略（NoShrink / ShrinkPolicy，或同接口的自定义策略）
+ * @tparam Stats     统计策略（SnapshotStats / NoStats）
+ * @tparam AsyncWait 异步等待策略（NoAsyncWaiters，或 AutoShrinkBlockingQueue 的协程等待者）
+ *
+ * 策略对象直接作为成员内联调用，不经过虚函数；NoShrink / NoStats / NoAsyncWaiters 的调用在编译期被消去，
+ * 因此 ThreadSafeQueue 作为 BasicQueue 的别名与原来手写的实现生成相同的热路径。
+ * capacity 非 0 时为有界队列（push 满时阻塞）；close() 之后 push 抛 QueueClosedError，
+ * 阻塞中的 push/pop 全部唤醒，剩余元素仍可 pop/try_pop/drain 取走，取空后 pop 抛 QueueClosedError；
+ * 收缩换下的旧存储在锁外析构；支持外部通知器与 Linux eventfd。
+ * 协程等待、磁盘溢出、快照由 AutoShrinkBlockingQueue 在此之上派生提供，同一把锁下的状态与辅助函数为此开放给派生类。
+ * T 必须可 move 构造。size/empty/last_high_mark/shrink_count 仅为快照，不能用于并发逻辑判断。
+ */
+template <typename T, typename Storage = DequeStorage, typename Lock = MutexLock, typename Wait = CondVarWait,
+          typename Shrink = ShrinkPolicy, typename Stats = SnapshotStats, typename AsyncWait = NoAsyncWaiters>
+class BasicQueue {
+    static_assert(std::is_move_constructible<T>::value, "BasicQueue: T must be move constructible");
+
+protected:
+    using storage_type = typename Storage::template container<T>;
+    using mutex_type = typename Lock::mutex_type;
+    using waiter_type = typename Wait::template waiter<mutex_type>;
+    using lock_type = std::unique_lock<mutex_type>;
+    using async_type = typename AsyncWait::template waiters<T>;
+    using pending_type = typename async_type::pending;
+
+public:
+    /**
+     * @param shrink 收缩策略对象
+     * @param capacity 队列容量上限，0 表示不限
+     */
+    explicit BasicQueue(Shrink shrink = Shrink(), size_t capacity = 0)
+        : capacity_(capacity), shrink_(std::move(shrink)) {}
+
+    /**
+     * @brief 与 AutoShrinkBlockingQueue 相同的构造参数，收缩策略为 ShrinkPolicy 时可用
+     * @param shrink_check_interval 每多少次出队检查一次是否需要 shrink
+     * @param shrink_factor 当前队长低于 high mark 的 shrink_factor 时触发 shrink
+     * @param capacity 队列容量上限，0 表示不限
+     */
+    BasicQueue(size_t shrink_check_interval, float shrink_factor, size_t capacity = 0)
+        requires std::is_constructible_v<Shrink, size_t, float>
+        : capacity_(capacity), shrink_(shrink_check_interval, shrink_factor) {}
+
+    BasicQueue(const BasicQueue&) = delete;
+    BasicQueue& operator=(const BasicQueue&) = delete;
+
+    /**
+     * @brief 线程安全入队，有界模式下队列满时阻塞
+     * @throw QueueClosedError 队列已关闭（包括阻塞等待空位期间被关闭）
+     */
+    void push(const T& value) { emplace(value); }
+    void push(T&& value) { emplace(std::move(value)); }
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        pending_type handed;
+        bool was_empty = false;
+        bool direct;
+        {
+            lock_type lock(mutex_);
+            if (capacity_ != 0) not_full_.wait(lock, [this] { return storage_.size() < capacity_ || closed_; });
+            if (closed_) throw QueueClosedError();
+            direct = enqueue_locked(handed, was_empty, std::forward<Args>(args)...);
+        }
+        after_enqueue(direct, was_empty, handed);
+    }
+
+    /**
+     * @brief 阻塞直到有数据，线程安全
+     * @throw QueueClosedError 队列已关闭且已取空
+     */
+    T pop() {
+        std::optional<storage_type> retired; // 收缩换下的旧存储，解锁后才析构
+        pending_type admitted;
+        bool into_empty = false;
+        lock_type lock(mutex_);
+        not_empty_.wait(lock, [this] { return !storage_.empty() || closed_; });
+        if (storage_.empty()) throw QueueClosedError();
+        T value = take_front_locked(retired);
+        const bool any = admit_locked(admitted, into_empty);
+        publish_locked();
+        lock.unlock();
+        after_slot_freed(any, into_empty, admitted);
+        return value;
+    }
+
+    /**
+     * @brief 非阻塞尝试出队，线程安全
+     */
+    std::optional<T> try_pop() {
+        std::optional<storage_type> retired;
+        pending_type admitted;
+        bool into_empty = false;
+        lock_type lock(mutex_);
+        if (storage_.empty()) return std::nullopt;
+        T value = take_front_locked(retired);
+        const bool any = admit_locked(admitted, into_empty);
+        publish_locked();
+        lock.unlock();
+        after_slot_freed(any, into_empty, admitted);
+        return value;
+    }
+
+    /**
+     * @brief 非阻塞批量出队，最多移出 max 个元素写入 out，返回实际个数
+     * @note 若因 max 限制未取空队列，会重新触发外部通知器（eventfd 再次可读）
+     */
+    template <typename OutputIt>
+    size_t drain_into(OutputIt out, size_t max = std::numeric_limits<size_t>::max()) {
+        std::optional<storage_type> retired;
+        pending_type admitted;
+        bool any_admitted = false;
+        size_t n = 0;
+        bool remaining;
+        {
+            lock_type lock(mutex_);
+            while (n < max && !storage_.empty()) {
+                *out = take_front_locked(retired);
+                ++out;
+                ++n;
+                bool into_empty = false;
+                any_admitted |= admit_locked(admitted, into_empty);
+            }
+            remaining = !storage_.empty();
+            if (n != 0) publish_locked();
+        }
+        if (capacity_ != 0 && n != 0) {
+            not_full_.notify_all();
+            if (any_admitted) {
+                not_empty_.notify_all();
+                admitted.resume();
+            }
+        }
+        if (remaining) notify_external(true);
+        return n;
+    }
+
+    /**
+     * @brief 分批取出剩余元素交给 sink（在锁外执行），直到队列为空，用于有序停机
+     * @return 交给 sink 的元素总数
+     */
+    template <typename F>
+    size_t drain(F&& sink, size_t batch = 256) {
+        std::vector<T> buf;
+        buf.reserve(batch);
+        size_t total = 0;
+        while (size_t n = drain_into(std::back_inserter(buf), batch)) {
+            sink(std::span<T>(buf.data(), buf.size()));
+            buf.clear();
+            total += n;
+        }
+        return total;
+    }
+
+    /**
+     * @brief 关闭队列：之后的 push 抛 QueueClosedError，阻塞（或异步挂起）中的生产者/消费者全部唤醒；重复调用无副作用
+     */
+    void close() {
+        pending_type woken;
+        {
+            lock_type lock(mutex_);
+            if (closed_) return;
+            closed_ = true;
+            async_.close(woken);
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+        // 让 epoll / QueueSet 上等待的消费者醒来检查 closed()
+        notify_external(true);
+        woken.resume();
+    }
+
+    bool closed() const {
+        lock_type lock(mutex_);
+        return closed_;
+    }
+
+    /**
+     * @brief 立即收缩底层存储（不等收缩策略触发），旧存储在锁外析构
+     * @return 估算回收的字节数
+     */
+    size_t shrink_to_fit() {
+        std::optional<storage_type> retired;
+        lock_type lock(mutex_);
+        const size_t before = storage_.allocated_bytes(shrink_.high_mark());
+        storage_.rebuild(retired);
+        shrink_.on_shrunk(resident_size_locked());
+        publish_locked();
+        const size_t after = storage_.allocated_bytes(resident_size_locked());
+        return before > after ? before - after : 0;
+    }
+
+    /**
+     * @brief 开关由收缩策略触发的自动收缩；关闭后仍记录高水位，收缩交给 shrink_to_fit 的调用方决定
+     */
+    void set_auto_shrink(bool enabled) {
+        lock_type lock(mutex_);
+        auto_shrink_ = enabled;
+    }
+
+    /**
+     * @brief 运行时调整收缩参数，下一次检查起生效；开启在线调参时调参器会在此基础上继续调整
+     * @param shrink_check_interval 每多少次出队检查一次是否需要 shrink（0 按 1 处理）
+     * @param shrink_factor 当前队长低于 high mark 的 shrink_factor 时触发 shrink（限制在 [0, 1]）
+     * @note 收缩策略为 ShrinkPolicy（或提供同名接口的策略）时，以下收缩参数接口可用
+     */
+    void set_shrink_params(size_t shrink_check_interval, float shrink_factor)
+        requires requires(Shrink& s) { s.set_check_interval(size_t{}); s.set_shrink_factor(float{}); }
+    {
+        lock_type lock(mutex_);
+        shrink_.set_check_interval(shrink_check_interval);
+        shrink_.set_shrink_factor(shrink_factor);
+    }
+
+    /**
+     * @brief 当前生效的 (check_interval, shrink_factor)
+     */
+    std::pair<size_t, float> shrink_params() const
+        requires requires(const Shrink& s) { s.check_interval(); s.shrink_factor(); }
+    {
+        lock_type lock(mutex_);
+        return {shrink_.check_interval(), shrink_.shrink_factor()};
+    }
+
+    /**
+     * @brief 开启收缩参数的在线调参：按窗口观察收缩耗时与收缩后回涨，在 CPU 预算内尽量早地归还内存，规则见 ShrinkAutoTuner
+     */
+    void enable_shrink_tuning(const ShrinkTuning& tuning = ShrinkTuning())
+        requires requires(Shrink& s) { s.enable_tuning(ShrinkTuning{}); }
+    {
+        lock_type lock(mutex_);
+        shrink_.enable_tuning(tuning);
+    }
+
+    /**
+     * @brief 关闭在线调参，参数停在当前值
+     */
+    void disable_shrink_tuning()
+        requires requires(Shrink& s) { s.disable_tuning(); }
+    {
+        lock_type lock(mutex_);
+        shrink_.disable_tuning();
+    }
+
+    /**
+     * @brief 调参器统计快照，未开启时为空
+     */
+    std::optional<ShrinkTunerStats> shrink_tuner_stats() const
+        requires requires(const Shrink& s) { s.tuner(); }
+    {
+        lock_type lock(mutex_);
+        if (const ShrinkAutoTuner* t = shrink_.tuner()) return t->stats();
+        return std::nullopt;
+    }
+
+    /**
+     * @brief 队列当前元素数，仅做信息快照；Stats 为 SnapshotStats 时不加锁
+     */
+    size_t size() const {
+        if constexpr (Stats::kLockFree) {
+            return stats_.size();
+        } else {
+            lock_type lock(mutex_);
+            return storage_.size();
+        }
+    }
+
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief 返回历史最大队列长度（NoShrink 下恒为 0），仅作为信息描述
+     */
+    size_t last_high_mark() const {
+        if constexpr (Stats::kLockFree) {
+            return stats_.high_mark();
+        } else {
+            lock_type lock(mutex_);
+            return shrink_.high_mark();
+        }
+    }
+
+    /**
+     * @brief 累计真正执行 shrink 的次数，仅作为信息描述
+     */
+    size_t shrink_count() const {
+        if constexpr (Stats::kLockFree) {
+            return stats_.shrink_count();
+        } else {
+            lock_type lock(mutex_);
+            return shrink_.shrink_count();
+        }
+    }
+
+    /**
+     * @brief 容量上限，0 表示无界
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief 挂接外部通知器，每次入队后回调；传 nullptr 解除挂接
+     */
+    void set_notifier(QueueNotifier* notifier) {
+        notifier_.store(notifier, std::memory_order_release);
+    }
+
+#if defined(__linux__)
+    /**
+     * @brief 开启 eventfd 模式（占用通知器挂接位），须在生产者开始 push 之前调用
+     * @return eventfd 描述符，失败返回 -1
+     */
+    int enable_eventfd() {
+        if (!eventfd_) {
+            eventfd_ = std::make_unique<EventFdNotifier>();
+            if (!eventfd_->valid()) {
+                eventfd_.reset();
+                return -1;
+            }
+            bool non_empty = !empty();
+            set_notifier(eventfd_.get());
+            if (non_empty) eventfd_->signal();
+        }
+        return eventfd_->fd();
+    }
+
+    int fd() const { return eventfd_ ? eventfd_->fd() : -1; }
+
+    /**
+     * @brief 清除 eventfd 可读状态，须在 drain_into 之前调用
+     */
+    uint64_t consume_eventfd() { return eventfd_ ? eventfd_->consume() : 0; }
+#endif
+
+protected:
+    // 存储只有一部分常驻内存时（如溢出到磁盘），收缩策略按常驻部分计算
+    static constexpr bool kPartlyResident = requires(const storage_type& s) { s.resident_size(); };
+
+    // 以下均须持锁调用
+
+    // 有异步消费者在等时（此时队列必为空）直接交给最早的那个，返回 true；否则放进存储
+    template <typename... Args>
+    bool enqueue_locked(pending_type& handed, bool& was_empty, Args&&... args) {
+        if (async_.consumer_waiting()) {
+            async_.hand_off(T(std::forward<Args>(args)...), handed);
+            return true;
+        }
+        was_empty = storage_.empty();
+        storage_.emplace_back(std::forward<Args>(args)...);
+        shrink_.on_grow(resident_size_locked());
+        publish_locked();
+        return false;
+    }
+
+    T take_front_locked(std::optional<storage_type>& retired) {
+        T value = storage_.take_front();
+        const size_t resident = resident_size_locked();
+        if constexpr (kPartlyResident) shrink_.on_grow(resident); // 取空时存储可能刚读回一批
+        // drain_into 一次取多个时最多重建一次：已经换下过旧存储的，本次调用内不再重建，留到下次检查
+        if (shrink_.on_remove(resident) && auto_shrink_ && !retired) {
+            storage_.rebuild(retired);
+            shrink_.on_shrunk(resident_size_locked());
+        }
+        return value;
+    }
+
+    // 有界模式下出队腾出一个空位：优先接纳挂起的异步生产者，把它的元素放进存储
+    bool admit_locked(pending_type& admitted, bool& into_empty) {
+        if (capacity_ == 0) return false;
+        const bool was_empty = storage_.empty();
+        auto put = [this](T&& v) {
+            storage_.emplace_back(std::move(v));
+            shrink_.on_grow(resident_size_locked());
+        };
+        if (!async_.admit_producer(put, admitted)) return false;
+        into_empty = was_empty;
+        return true;
+    }
+
+    size_t resident_size_locked() const {
+        if constexpr (kPartlyResident) {
+            return storage_.resident_size();
+        } else {
+            return storage_.size();
+        }
+    }
+
+    void publish_locked() {
+        stats_.publish(storage_.size(), shrink_.high_mark(), shrink_.shrink_count());
+    }
+
+    // 以下在锁外调用
+
+    void after_enqueue(bool direct, bool was_empty, pending_type& handed) {
+        if (direct) {
+            handed.resume();
+            return;
+        }
+        not_empty_.notify_one();
+        notify_external(was_empty);
+    }
+
+    void after_slot_freed(bool admitted, bool into_empty, pending_type& resumed) {
+        if (capacity_ == 0) return;
+        if (admitted) {
+            // 被接纳的元素已进入队列，同样需要唤醒阻塞的 pop 和外部通知器
+            not_empty_.notify_one();
+            notify_external(into_empty);
+            resumed.resume();
+        } else {
+            not_full_.notify_one();
+        }
+    }
+
+    void notify_external(bool was_empty) {
+        if (QueueNotifier* n = notifier_.load(std::memory_order_acquire)) {
+            n->notify(was_empty);
+        }
+    }
+
+    // ---- 成员按访问方分组，每组从新的 cache line 开始：只读配置与通知器 / 锁内状态 / 两个等待者 / 快照 ----
+    alignas(kCacheLineSize) const size_t capacity_;
+    std::atomic<QueueNotifier*> notifier_{nullptr};
+#if defined(__linux__)
+    std::unique_ptr<EventFdNotifier> eventfd_;
+#endif
+
+    alignas(kCacheLineSize) mutable mutex_type mutex_;
+    storage_type storage_;
+    [[no_unique_address]] Shrink shrink_;
+    bool auto_shrink_ = true;
+    bool closed_ = false;
+    [[no_unique_address]] async_type async_;
+
+    alignas(kCacheLineSize) waiter_type not_empty_;
+    alignas(kCacheLineSize) waiter_type not_full_;
+
+    alignas(kCacheLineSize) [[no_unique_address]] Stats stats_;
+};
+
+/**
+ * @brief 只含同步接口的自动收缩队列：deque 存储 + 互斥锁 + 条件变量 + 计数触发收缩 + 无锁快照
+ * @note AutoShrinkBlockingQueue 即在这一组合上把存储换成可溢出的 deque、挂上协程等待者，并加上快照接口
+ */
+template <typename T>
+using AutoShrinkQueue = BasicQueue<T, DequeStorage, MutexLock, CondVarWait, ShrinkPolicy, SnapshotStats>;
@@ -5,6 +5,8 @@
 #include <vector>
 #include <thread>
 #include <chrono>
+#include <atomic>
+#include <cstdio>
 #include <spdlog/spdlog.h>
 #include "util.h"
 
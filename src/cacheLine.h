@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief 避免伪共享所需的对齐字节数
+ *
+ * 优先用 std::hardware_destructive_interference_size；GCC 会因该值随 -mtune 变化而给出
+ * -Winterference-size 警告（头文件里使用可能造成 ABI 不一致），所以 GCC 下固定取 64，
+ * 与 x86-64 / 大多数 ARM64 服务器的 cache line 一致。
+ */
+#if defined(__cpp_lib_hardware_interference_size) && !(defined(__GNUC__) && !defined(__clang__))
+inline constexpr size_t kCacheLineSize = std::hardware_destructive_interference_size;
+#else
+inline constexpr size_t kCacheLineSize = 64;
+#endif
+
+/**
+ * @brief 独占 cache line 的包装：不同线程各自频繁写的变量（计数器、游标）各包一个，互不失效
+ *
+ * 用法：CacheLinePadded<std::atomic<int64_t>> produced{0}; produced->fetch_add(1);
+ */
+template <typename T>
+struct alignas(kCacheLineSize) CacheLinePadded {
+    CacheLinePadded() = default;
+    template <typename U>
+        requires(std::is_constructible_v<T, U &&> && !std::is_same_v<std::remove_cvref_t<U>, CacheLinePadded>)
+    explicit CacheLinePadded(U&& init) : value(std::forward<U>(init)) {}
+
+    T* operator->() { return &value; }
+    const T* operator->() const { return &value; }
+    T& operator*() { return value; }
+    const T& operator*() const { return value; }
+
+    T value{};
+};
@@ -0,0 +1,413 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <forward_list>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <set>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief 单个容器实例的内存占用估算（字节）
+ *
+ * 只统计容器自身向分配器申请的内存（元素缓冲 / 块 / 桶数组 / 节点），不含元素内部再分配的内存，
+ * 也不含 malloc 的块头开销。数值按标准库实现的已知布局估算，用于排序和决策，不是精确计量。
+ */
+struct ContainerFootprint {
+    size_t elements = 0;        // 当前元素个数
+    size_t used_bytes = 0;      // 装下当前元素所需的最少字节
+    size_t allocated_bytes = 0; // 容器当前实际持有的字节
+    size_t reclaimable() const { return allocated_bytes > used_bytes ? allocated_bytes - used_bytes : 0; }
+};
+
+namespace retention_detail {
+
+// deque 每块元素个数，与各标准库实现保持一致
+template <typename T>
+constexpr size_t DequeBlockElems() {
+#if defined(_MSC_VER) && !defined(_LIBCPP_VERSION)
+    return sizeof(T) <= 1 ? 16 : sizeof(T) <= 2 ? 8 : sizeof(T) <= 4 ? 4 : sizeof(T) <= 8 ? 2 : 1;
+#elif defined(_LIBCPP_VERSION)
+    return sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+#else
+    return sizeof(T) < 512 ? 512 / sizeof(T) : 1;
+#endif
+}
+
+// deque 的块指针数组（map）：至少 8 个槽、按倍数增长、从不缩小
+inline size_t DequeMapBytes(size_t blocks) {
+    return std::bit_ceil(std::max<size_t>(8, blocks + 2)) * sizeof(void*);
+}
+
+inline size_t CeilDiv(size_t a, size_t b) { return (a + b - 1) / b; }
+
+// 节点式容器的单节点大小：链表 2 指针，红黑树 3 指针 + 颜色，哈希表 next 指针 + 缓存的哈希值
+template <typename V> constexpr size_t ListNodeBytes() { return sizeof(V) + 2 * sizeof(void*); }
+template <typename V> constexpr size_t ForwardListNodeBytes() { return sizeof(V) + sizeof(void*); }
+template <typename V> constexpr size_t TreeNodeBytes() { return sizeof(V) + 4 * sizeof(void*); }
+template <typename V> constexpr size_t HashNodeBytes() { return sizeof(V) + sizeof(void*) + sizeof(size_t); }
+
+template <typename C>
+ContainerFootprint NodeFootprint(const C& c, size_t node_bytes) {
+    // 节点式容器 erase 时逐个归还节点，自身不囤积内存
+    ContainerFootprint f;
+    f.elements = c.size();
+    f.used_bytes = f.allocated_bytes = c.size() * node_bytes;
+    return f;
+}
+
+template <typename C>
+ContainerFootprint HashFootprint(const C& c, size_t node_bytes) {
+    ContainerFootprint f;
+    f.elements = c.size();
+    size_t nodes = c.size() * node_bytes;
+    size_t needed_buckets = std::max<size_t>(1,
+        static_cast<size_t>(static_cast<double>(c.size()) / static_cast<double>(c.max_load_factor())) + 1);
+    f.used_bytes = nodes + std::min(needed_buckets, c.bucket_count()) * sizeof(void*);
+    f.allocated_bytes = nodes + c.bucket_count() * sizeof(void*);
+    return f;
+}
+
+template <typename C>
+void ShrinkHash(C& c) {
+#if defined(_MSC_VER) && !defined(_LIBCPP_VERSION)
+    // MSVC 的 rehash 不会把桶数组缩小，只能重建
+    C rebuilt(std::make_move_iterator(c.begin()), std::make_move_iterator(c.end()), 0,
+              c.hash_function(), c.key_eq(), c.get_allocator());
+    c.swap(rebuilt);
+#else
+    c.rehash(0);
+#endif
+}
+
+// 取 std::queue / std::stack 受保护的底层容器
+template <typename Adaptor>
+struct UnderlyingAccess : Adaptor {
+    static typename Adaptor::container_type& get(Adaptor& a) { return a.*(&UnderlyingAccess::c); }
+    static const typename Adaptor::container_type& get(const Adaptor& a) { return a.*(&UnderlyingAccess::c); }
+};
+
+} // namespace retention_detail
+
+// =================== 各容器的估算 / 收缩 / 类型名 ===================
+// high_water：观察到的历史最大元素数，只有 deque 这种"按历史峰值囤块"的容器会用到
+
+template <typename T, typename A>
+ContainerFootprint EstimateFootprint(const std::vector<T, A>& c, size_t /*high_water*/ = 0) {
+    ContainerFootprint f;
+    f.elements = c.size();
+    f.used_bytes = c.size() * sizeof(T);
+    f.allocated_bytes = c.capacity() * sizeof(T);
+    return f;
+}
+template <typename T, typename A>
+void ShrinkContainer(std::vector<T, A>& c) { c.shrink_to_fit(); }
+template <typename T, typename A>
+const char* ContainerKindName(const std::vector<T, A>&) { return "vector"; }
+
+template <typename Ch, typename Tr, typename A>
+ContainerFootprint EstimateFootprint(const std::basic_string<Ch, Tr, A>& c, size_t /*high_water*/ = 0) {
+    // 短字符串存在对象内部，不占堆
+    const size_t sso = std::basic_string<Ch, Tr, A>().capacity();
+    ContainerFootprint f;
+    f.elements = c.size();
+    f.used_bytes = c.size() > sso ? (c.size() + 1) * sizeof(Ch) : 0;
+    f.allocated_bytes = c.capacity() > sso ? (c.capacity() + 1) * sizeof(Ch) : 0;
+    return f;
+}
+template <typename Ch, typename Tr, typename A>
+void ShrinkContainer(std::basic_string<Ch, Tr, A>& c) { c.shrink_to_fit(); }
+template <typename Ch, typename Tr, typename A>
+const char* ContainerKindName(const std::basic_string<Ch, Tr, A>&) { return "string"; }
+
+/**
+ * @note libstdc++ 在块清空时立刻释放块，只有 map 按峰值保留；
+ *       MSVC / libc++ 会把空块留作复用，按历史峰值估算持有的块数
+ */
+template <typename T, typename A>
+ContainerFootprint EstimateFootprint(const std::deque<T, A>& c, size_t high_water = 0) {
+    using namespace retention_detail;
+    constexpr size_t B = DequeBlockElems<T>();
+    const size_t block_bytes = B * sizeof(T);
+#if defined(__GLIBCXX__)
+    const size_t used_blocks = std::max<size_t>(CeilDiv(c.size(), B), 1); // 空 deque 也持有一个块
+#else
+    const size_t used_blocks = CeilDiv(c.size(), B);
+#endif
+    const size_t peak_blocks = std::max(used_blocks, CeilDiv(std::max(high_water, c.size()), B));
+#if defined(__GLIBCXX__)
+    const size_t held_blocks = used_blocks;
+#else
+    const size_t held_blocks = peak_blocks;
+#endif
+    ContainerFootprint f;
+    f.elements = c.size();
+    f.used_bytes = used_blocks * block_bytes + DequeMapBytes(used_blocks);
+    f.allocated_bytes = held_blocks * block_bytes + DequeMapBytes(peak_blocks);
+    return f;
+}
+template <typename T, typename A>
+void ShrinkContainer(std::deque<T, A>& c) { c.shrink_to_fit(); }
+template <typename T, typename A>
+const char* ContainerKindName(const std::deque<T, A>&) { return "deque"; }
+
+template <typename T, typename A>
+ContainerFootprint EstimateFootprint(const std::list<T, A>& c, size_t /*high_water*/ = 0) {
+    return retention_detail::NodeFootprint(c, retention_detail::ListNodeBytes<T>());
+}
+template <typename T, typename A>
+void ShrinkContainer(std::list<T, A>&) {}
+template <typename T, typename A>
+const char* ContainerKindName(const std::list<T, A>&) { return "list"; }
+
+template <typename T, typename A>
+ContainerFootprint EstimateFootprint(const std::forward_list<T, A>& c, size_t /*high_water*/ = 0) {
+    ContainerFootprint f;
+    f.elements = static_cast<size_t>(std::distance(c.begin(), c.end()));
+    f.used_bytes = f.allocated_bytes = f.elements * retention_detail::ForwardListNodeBytes<T>();
+    return f;
+}
+template <typename T, typename A>
+void ShrinkContainer(std::forward_list<T, A>&) {}
+template <typename T, typename A>
+const char* ContainerKindName(const std::forward_list<T, A>&) { return "forward_list"; }
+
+template <typename K, typename V, typename Cmp, typename A>
+ContainerFootprint EstimateFootprint(const std::map<K, V, Cmp, A>& c, size_t /*high_water*/ = 0) {
+    return retention_detail::NodeFootprint(c, retention_detail::TreeNodeBytes<std::pair<const K, V>>());
+}
+template <typename K, typename V, typename Cmp, typename A>
+void ShrinkContainer(std::map<K, V, Cmp, A>&) {}
+template <typename K, typename V, typename Cmp, typename A>
+const char* ContainerKindName(const std::map<K, V, Cmp, A>&) { return "map"; }
+
+template <typename K, typename Cmp, typename A>
+ContainerFootprint EstimateFootprint(const std::set<K, Cmp, A>& c, size_t /*high_water*/ = 0) {
+    return retention_detail::NodeFootprint(c, retention_detail::TreeNodeBytes<K>());
+}
+template <typename K, typename Cmp, typename A>
+void ShrinkContainer(std::set<K, Cmp, A>&) {}
+template <typename K, typename Cmp, typename A>
+const char* ContainerKindName(const std::set<K, Cmp, A>&) { return "set"; }
+
+template <typename K, typename V, typename H, typename E, typename A>
+ContainerFootprint EstimateFootprint(const std::unordered_map<K, V, H, E, A>& c, size_t /*high_water*/ = 0) {
+    return retention_detail::HashFootprint(c, retention_detail::HashNodeBytes<std::pair<const K, V>>());
+}
+template <typename K, typename V, typename H, typename E, typename A>
+void ShrinkContainer(std::unordered_map<K, V, H, E, A>& c) { retention_detail::ShrinkHash(c); }
+template <typename K, typename V, typename H, typename E, typename A>
+const char* ContainerKindName(const std::unordered_map<K, V, H, E, A>&) { return "unordered_map"; }
+
+template <typename K, typename H, typename E, typename A>
+ContainerFootprint EstimateFootprint(const std::unordered_set<K, H, E, A>& c, size_t /*high_water*/ = 0) {
+    return retention_detail::HashFootprint(c, retention_detail::HashNodeBytes<K>());
+}
+template <typename K, typename H, typename E, typename A>
+void ShrinkContainer(std::unordered_set<K, H, E, A>& c) { retention_detail::ShrinkHash(c); }
+template <typename K, typename H, typename E, typename A>
+const char* ContainerKindName(const std::unordered_set<K, H, E, A>&) { return "unordered_set"; }
+
+template <typename T, typename C>
+ContainerFootprint EstimateFootprint(const std::queue<T, C>& q, size_t high_water = 0) {
+    return EstimateFootprint(retention_detail::UnderlyingAccess<std::queue<T, C>>::get(q), high_water);
+}
+template <typename T, typename C>
+void ShrinkContainer(std::queue<T, C>& q) { ShrinkContainer(retention_detail::UnderlyingAccess<std::queue<T, C>>::get(q)); }
+template <typename T, typename C>
+const char* ContainerKindName(const std::queue<T, C>&) { return "queue"; }
+
+template <typename T, typename C>
+ContainerFootprint EstimateFootprint(const std::stack<T, C>& s, size_t high_water = 0) {
+    return EstimateFootprint(retention_detail::UnderlyingAccess<std::stack<T, C>>::get(s), high_water);
+}
+template <typename T, typename C>
+void ShrinkContainer(std::stack<T, C>& s) { ShrinkContainer(retention_detail::UnderlyingAccess<std::stack<T, C>>::get(s)); }
+template <typename T, typename C>
+const char* ContainerKindName(const std::stack<T, C>&) { return "stack"; }
+
+// =================== 实例登记表 ===================
+
+struct RetentionReport {
+    std::string name;
+    const char* kind = "";
+    size_t high_water = 0;          // 登记以来扫描到的最大元素数
+    ContainerFootprint footprint;
+};
+
+/**
+ * @brief 容器实例登记表：登记业务中的容器，周期性扫描估算可回收字节，按浪费程度排序并定点收缩
+ *
+ * 典型用法：
+ *   auto h = ContainerRetentionRegistry::instance().track("order_cache", cache_, &cache_mutex_);
+ *   // 周期任务
+ *   for (auto& r : registry.top(10, 1 << 20)) SPDLOG_INFO(...);
+ *   registry.shrink_top(3, 16 << 20);
+ *
+ * @note 扫描/收缩会读写被登记的容器：传入 guard 时在其保护下进行，
+ *       不传 guard 则调用方须保证扫描时没有其它线程在改这个容器。
+ *       登记表须比所有 Handle 活得久（用 instance() 即可）。
+ */
+class ContainerRetentionRegistry {
+public:
+    /**
+     * @brief 登记句柄，析构时自动注销；只可移动
+     */
+    class Handle {
+    public:
+        Handle() = default;
+        Handle(ContainerRetentionRegistry* owner, uint64_t id) : owner_(owner), id_(id) {}
+        Handle(Handle&& other) noexcept : owner_(std::exchange(other.owner_, nullptr)), id_(other.id_) {}
+        Handle& operator=(Handle&& other) noexcept {
+            if (this != &other) {
+                reset();
+                owner_ = std::exchange(other.owner_, nullptr);
+                id_ = other.id_;
+            }
+            return *this;
+        }
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+        ~Handle() { reset(); }
+
+        void reset() {
+            if (owner_) owner_->untrack(id_);
+            owner_ = nullptr;
+        }
+        explicit operator bool() const { return owner_ != nullptr; }
+
+    private:
+        ContainerRetentionRegistry* owner_ = nullptr;
+        uint64_t id_ = 0;
+    };
+
+    static ContainerRetentionRegistry& instance() {
+        static ContainerRetentionRegistry registry;
+        return registry;
+    }
+
+    /**
+     * @param name  报告里显示的名字
+     * @param c     被登记的容器，须比返回的 Handle 活得久
+     * @param guard 保护该容器的互斥量，可为 nullptr
+     */
+    template <typename C>
+    [[nodiscard]] Handle track(std::string name, C& c, std::mutex* guard = nullptr) {
+        Entry e;
+        e.name = std::move(name);
+        e.kind = ContainerKindName(c);
+        e.guard = guard;
+        e.probe = [&c](size_t high_water) { return EstimateFootprint(c, high_water); };
+        e.shrink = [&c] { ShrinkContainer(c); };
+        std::lock_guard<std::mutex> lock(mutex_);
+        e.id = ++next_id_;
+        entries_.push_back(std::move(e));
+        return Handle(this, next_id_);
+    }
+
+    /**
+     * @brief 扫描全部登记的容器，按可回收字节降序返回
+     */
+    std::vector<RetentionReport> scan() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<RetentionReport> out;
+        out.reserve(entries_.size());
+        for (Entry& e : entries_) out.push_back(probe_locked(e));
+        std::stable_sort(out.begin(), out.end(), [](const RetentionReport& a, const RetentionReport& b) {
+            return a.footprint.reclaimable() > b.footprint.reclaimable();
+        });
+        return out;
+    }
+
+    /**
+     * @brief 可回收字节最多的前 n 个，且可回收字节不少于 min_reclaimable
+     */
+    std::vector<RetentionReport> top(size_t n, size_t min_reclaimable = 1) {
+        std::vector<RetentionReport> all = scan();
+        std::vector<RetentionReport> out;
+        for (RetentionReport& r : all) {
+            if (out.size() >= n || r.footprint.reclaimable() < min_reclaimable) break;
+            out.push_back(std::move(r));
+        }
+        return out;
+    }
+
+    /**
+     * @brief 对可回收字节最多的前 n 个（且不少于 min_reclaimable）执行收缩
+     * @return 收缩前后估算值之差的总和，即估算回收的字节数
+     */
+    size_t shrink_top(size_t n, size_t min_reclaimable = 1) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::pair<size_t, Entry*>> order;
+        order.reserve(entries_.size());
+        for (Entry& e : entries_) order.emplace_back(probe_locked(e).footprint.reclaimable(), &e);
+        std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        size_t reclaimed = 0;
+        for (size_t i = 0; i < order.size() && i < n; ++i) {
+            if (order[i].first < min_reclaimable) break;
+            Entry& e = *order[i].second;
+            ContainerFootprint before;
+            ContainerFootprint after;
+            {
+                std::unique_lock<std::mutex> guard_lock;
+                if (e.guard) guard_lock = std::unique_lock<std::mutex>(*e.guard);
+                before = e.probe(e.high_water);
+                e.shrink();
+                e.high_water = 0; // 收缩后历史峰值不再代表持有量
+                after = e.probe(0);
+                e.high_water = after.elements;
+            }
+            if (before.allocated_bytes > after.allocated_bytes) reclaimed += before.allocated_bytes - after.allocated_bytes;
+        }
+        return reclaimed;
+    }
+
+    size_t tracked() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+private:
+    struct Entry {
+        uint64_t id = 0;
+        std::string name;
+        const char* kind = "";
+        std::mutex* guard = nullptr;
+        size_t high_water = 0;
+        std::function<ContainerFootprint(size_t)> probe;
+        std::function<void()> shrink;
+    };
+
+    RetentionReport probe_locked(Entry& e) {
+        std::unique_lock<std::mutex> guard_lock;
+        if (e.guard) guard_lock = std::unique_lock<std::mutex>(*e.guard);
+        ContainerFootprint f = e.probe(e.high_water);
+        e.high_water = std::max(e.high_water, f.elements);
+        return RetentionReport{e.name, e.kind, e.high_water, f};
+    }
+
+    void untrack(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                      [id](const Entry& e) { return e.id == id; }),
+                       entries_.end());
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+    uint64_t next_id_ = 0;
+};
@@ -0,0 +1,65 @@
+#include "containerRetentionTest.h"
+#include "containerRetention.h"
+
+#include <deque>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "util.h"
+
+namespace {
+
+struct RetentionData {
+    char buf[1024]; // 1KB，与 DoTest 的 Data 一致
+};
+
+void LogTopWasteful(ContainerRetentionRegistry& registry, const std::string& context) {
+    constexpr double kMiB = 1024.0 * 1024.0;
+    SPDLOG_INFO("[Retention] {} tracked={}", context, registry.tracked());
+    for (const RetentionReport& r : registry.scan()) {
+        SPDLOG_INFO("[Retention]   {:<16} {:<14} size={:<8} high={:<8} used={:.2f} MiB held={:.2f} MiB reclaimable={:.2f} MiB",
+                    r.name, r.kind, r.footprint.elements, r.high_water,
+                    r.footprint.used_bytes / kMiB, r.footprint.allocated_bytes / kMiB,
+                    r.footprint.reclaimable() / kMiB);
+    }
+}
+
+} // namespace
+
+// 与 DoTest 相同的"填满再清空"过程，但不再看进程 RSS 猜，而是逐个容器估算谁在囤内存，并只收缩最浪费的几个
+void TestContainerRetention() {
+    ContainerRetentionRegistry& registry = ContainerRetentionRegistry::instance();
+
+    std::vector<RetentionData> v;
+    std::deque<RetentionData> dq;
+    std::list<RetentionData> l;
+    std::unordered_map<int, RetentionData> um;
+    auto hv = registry.track("vector", v);
+    auto hd = registry.track("deque", dq);
+    auto hl = registry.track("list", l);
+    auto hu = registry.track("unordered_map", um);
+
+    constexpr int kCount = 100000;
+    for (int i = 0; i < kCount; ++i) {
+        v.emplace_back();
+        dq.emplace_back();
+        l.emplace_back();
+        um.emplace(i, RetentionData{});
+    }
+    LogTopWasteful(registry, "after fill");
+    LogMemorySnapshot("retention: after fill");
+
+    while (!v.empty()) v.pop_back();
+    while (!dq.empty()) dq.pop_front();
+    l.clear();
+    for (int i = 0; i < kCount; ++i) um.erase(i);
+    LogTopWasteful(registry, "after drain");
+    LogMemorySnapshot("retention: after drain");
+
+    size_t reclaimed = registry.shrink_top(2, 1 << 20);
+    SPDLOG_INFO("[Retention] shrink_top(2, 1MiB) reclaimed ~{:.2f} MiB", reclaimed / (1024.0 * 1024.0));
+    LogTopWasteful(registry, "after shrink_top");
+    LogMemorySnapshot("retention: after shrink_top");
+}
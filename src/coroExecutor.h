@@ -0,0 +1,122 @@
+#pragma once
+
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+/**
+ * @brief 协程恢复执行器接口
+ *
+ * 队列在数据就绪时不再 notify 条件变量，而是把挂起的协程句柄 post 给执行器，
+ * 由执行器决定在哪个线程上 resume。这样一个线程即可承载成千上万个逻辑消费者。
+ */
+class CoroExecutor {
+public:
+    virtual ~CoroExecutor() = default;
+    virtual void post(std::coroutine_handle<> h) = 0;
+};
+
+/**
+ * @brief 就地执行：在调用 post 的线程（通常是生产者线程）上直接 resume
+ * @note 队列保证 post 总在释放队列锁之后调用，协程中再次访问同一队列不会死锁
+ */
+class InlineExecutor final : public CoroExecutor {
+public:
+    static InlineExecutor& instance() {
+        static InlineExecutor ex;
+        return ex;
+    }
+    void post(std::coroutine_handle<> h) override { h.resume(); }
+};
+
+/**
+ * @brief 单线程事件循环执行器
+ *
+ * 任意线程 post，run() 所在线程按 FIFO 批量 resume；stop() 后 run() 处理完剩余句柄返回
+ */
+class LoopExecutor final : public CoroExecutor {
+public:
+    LoopExecutor() = default;
+    LoopExecutor(const LoopExecutor&) = delete;
+    LoopExecutor& operator=(const LoopExecutor&) = delete;
+
+    void post(std::coroutine_handle<> h) override {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            ready_.push_back(h);
+        }
+        cond_.notify_one();
+    }
+
+    /**
+     * @brief 阻塞运行事件循环，直到 stop() 且没有待恢复的协程
+     */
+    void run() {
+        std::deque<std::coroutine_handle<>> batch;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cond_.wait(lock, [this]{ return !ready_.empty() || stopped_; });
+                if (ready_.empty()) return; // stopped_ 且已清空
+                batch.swap(ready_);
+            }
+            for (auto h : batch) h.resume();
+            batch.clear();
+        }
+    }
+
+    /**
+     * @brief 非阻塞：恢复当前所有已就绪的协程，返回本次恢复的个数（便于单测驱动）
+     */
+    size_t poll() {
+        std::deque<std::coroutine_handle<>> batch;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            batch.swap(ready_);
+        }
+        for (auto h : batch) h.resume();
+        return batch.size();
+    }
+
+    void stop() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            stopped_ = true;
+        }
+        cond_.notify_all();
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::coroutine_handle<>> ready_;
+    bool stopped_ = false;
+};
+
+/**
+ * @brief co_await schedule_on(ex) 把当前协程切换到执行器 ex 上继续执行
+ */
+inline auto schedule_on(CoroExecutor& ex) {
+    struct Awaiter {
+        CoroExecutor& ex;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) { ex.post(h); }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{ex};
+}
+
+/**
+ * @brief 最简单的"发射后不管"协程返回类型，协程结束时自动销毁帧
+ */
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
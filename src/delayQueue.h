@@ -0,0 +1,609 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "cacheLine.h"
+#include "queueClosedError.h"
+#include "shrinkPolicy.h"
+
+/**
+ * @brief 分层时间轮实现的线程安全延时队列：元素到期后才能出队，pop 阻塞到最近的到期时刻
+ *
+ * 用于海量重试超时这类"大多数会被取消、少数到期"的定时器：
+ *   - schedule_at / schedule_after O(1) 挂到时间轮槽位上，返回 TimerId；cancel(id) O(1) 从槽位链表摘除；
+ *   - 4 层 × 256 槽，最低层一格为一个 tick（构造时指定，默认 1ms），覆盖约 2^32 个 tick，更远的定时器挂在最高层，逐层下放；
+ *   - 推进时间时用每层的占用位图跳过空槽，空闲很久之后第一次 pop 也不会逐 tick 空转。
+ * 到期精度为一个 tick：元素不会早于 deadline 出队，最多晚一个 tick（加上线程唤醒延迟）；同一 tick 内按挂入顺序出队。
+ *
+ * 节点存储按 512 个一块分配，空闲节点串在空闲链表上复用。与 AutoShrinkBlockingQueue 相同，按 ShrinkPolicy
+ * （每 shrink_check_interval 次出队/取消检查一次，定时器数低于 high mark 的 shrink_factor）释放整块空闲的节点块，
+ * 一波突发定时器到期或取消之后内存随之归还，不像 std::priority_queue / std::map 那样一直停在峰值；释放在锁外进行。
+ * 仍有存活节点的块不会释放（TimerId 需要保持有效），长寿命定时器零散分布时能回收的块会变少。
+ *
+ * 阻塞与停机约定与 AutoShrinkBlockingQueue 一致：close() 之后 schedule 抛 QueueClosedError，阻塞中的 pop 全部唤醒；
+ * 已到期的元素仍可 pop/try_pop 取走，没有到期元素时 pop 抛 QueueClosedError；未到期的剩余元素用 drain(sink) 取走。
+ * T 必须可 move 构造。size/empty/last_high_mark/shrink_count 为原子快照，不能用于并发逻辑判断。
+ */
+template <typename T, typename Clock = std::chrono::steady_clock>
+class DelayQueue {
+    static_assert(std::is_move_constructible<T>::value, "DelayQueue: T must be move constructible");
+
+public:
+    using clock_type = Clock;
+    using time_point = typename Clock::time_point;
+    using duration = typename Clock::duration;
+
+    /**
+     * @brief 定时器句柄，用于 cancel；默认构造的句柄无效
+     */
+    struct TimerId {
+        uint32_t index = std::numeric_limits<uint32_t>::max();
+        uint64_t seq = 0; // 全局递增，节点复用或节点块释放后旧句柄不会误中新定时器
+        bool valid() const { return seq != 0; }
+    };
+
+    static constexpr size_t kLevels = 4;
+    static constexpr size_t kSlotBits = 8;
+    static constexpr size_t kSlots = size_t{1} << kSlotBits;
+    static constexpr size_t kChunkNodes = 512;
+
+    /**
+     * @param tick 最低层一格的时长，即到期精度
+     * @param shrink_check_interval 每多少次出队/取消检查一次是否需要释放空闲节点块
+     * @param shrink_factor 定时器数低于 high mark 的 shrink_factor 时释放（推荐 0.15~0.25）
+     */
+    explicit DelayQueue(std::chrono::nanoseconds tick = std::chrono::milliseconds(1),
+                        size_t shrink_check_interval = 150, float shrink_factor = 0.25f)
+        : tick_(std::max<std::chrono::nanoseconds>(tick, std::chrono::nanoseconds(1))),
+          origin_(Clock::now()),
+          shrink_policy_(shrink_check_interval, shrink_factor) {}
+
+    DelayQueue(const DelayQueue&) = delete;
+    DelayQueue& operator=(const DelayQueue&) = delete;
+
+    /**
+     * @brief 在 deadline 到期后可出队；deadline 已过时下一次 pop 即可取走
+     * @return 用于 cancel 的句柄
+     * @throw QueueClosedError 队列已关闭
+     */
+    TimerId schedule_at(time_point deadline, T value) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (closed_) throw QueueClosedError();
+        const uint32_t idx = allocate_locked();
+        Node& n = node(idx);
+        n.value.emplace(std::move(value));
+        n.expiry = tick_of(deadline);
+        n.seq = ++next_seq_;
+        ++live_;
+        shrink_policy_.on_grow(live_);
+        place_locked(idx);
+        const TimerId id{idx, n.seq};
+        // 只有比睡眠中的消费者约定的醒来时刻更早时才需要叫醒它们重新计算
+        const bool wake = sleeping_ != 0 && n.expiry < wait_tick_;
+        if (wake) wait_tick_ = kNever;
+        publish_locked();
+        lock.unlock();
+        if (wake) cond_.notify_all();
+        return id;
+    }
+
+    /**
+     * @brief 在 delay 之后可出队
+     * @throw QueueClosedError 队列已关闭
+     */
+    template <typename Rep, typename Period>
+    TimerId schedule_after(std::chrono::duration<Rep, Period> delay, T value) {
+        return schedule_at(Clock::now() + std::chrono::duration_cast<duration>(delay), std::move(value));
+    }
+
+    /**
+     * @brief 取消尚未出队的定时器（包括已到期但还没被取走的），O(1)
+     * @return 定时器已出队、已取消或句柄无效时返回 false
+     */
+    bool cancel(TimerId id) {
+        std::optional<T> dropped; // 元素在锁外析构
+        std::vector<std::unique_ptr<Chunk>> retired;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (!id.valid() || id.index / kChunkNodes >= chunks_.size() || !chunks_[id.index / kChunkNodes]) return false;
+            Node& n = node(id.index);
+            if (n.list == kFreeList || n.seq != id.seq) return false;
+            unlink_locked(id.index);
+            dropped = std::move(n.value);
+            release_locked(id.index);
+            auto_shrink(retired);
+            publish_locked();
+        }
+        return true;
+    }
+
+    /**
+     * @brief 阻塞直到有元素到期，线程安全
+     * @return 到期的元素
+     * @throw QueueClosedError 队列已关闭且当前没有到期元素
+     */
+    T pop() {
+        std::vector<std::unique_ptr<Chunk>> retired;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            advance_locked(Clock::now());
+            if (ready_.head != kNil) break;
+            if (closed_) throw QueueClosedError();
+            const uint64_t next = next_event_tick_locked();
+            if (next < wait_tick_) wait_tick_ = next;
+            ++sleeping_;
+            if (next == kNever) {
+                cond_.wait(lock);
+            } else {
+                cond_.wait_until(lock, time_of(next));
+            }
+            --sleeping_;
+            wait_tick_ = kNever; // 醒来的消费者各自重新计算，其余仍在睡眠的按自己的时刻醒来
+        }
+        T val = take_ready_locked(retired);
+        const bool more = ready_.head != kNil;
+        lock.unlock();
+        if (more) cond_.notify_one();
+        return val;
+    }
+
+    /**
+     * @brief 非阻塞尝试取出一个到期元素，线程安全
+     * @return 没有到期元素时返回空
+     */
+    std::optional<T> try_pop() {
+        std::vector<std::unique_ptr<Chunk>> retired;
+        std::unique_lock<std::mutex> lock(mutex_);
+        advance_locked(Clock::now());
+        if (ready_.head == kNil) return std::nullopt;
+        return take_ready_locked(retired);
+    }
+
+    /**
+     * @brief 非阻塞批量取出至多 max 个到期元素写入 out
+     * @return 实际取出的个数
+     */
+    template <typename OutputIt>
+    size_t drain_into(OutputIt out, size_t max = std::numeric_limits<size_t>::max()) {
+        std::vector<std::unique_ptr<Chunk>> retired;
+        std::unique_lock<std::mutex> lock(mutex_);
+        advance_locked(Clock::now());
+        size_t n = 0;
+        while (n < max && ready_.head != kNil) {
+            *out = take_ready_locked(retired);
+            ++out;
+            ++n;
+        }
+        return n;
+    }
+
+    /**
+     * @brief 不论是否到期，分批取出全部剩余元素交给 sink，用于有序停机
+     * @param sink 以 std::span<T> 调用，每批最多 batch 个元素，在锁外执行，可以把元素 move 走
+     * @return 交给 sink 的元素总数
+     * @note 已到期的元素在前；未到期的按时间轮由近及远的层次交出，层内不保证严格按 deadline 排序。
+     *       通常先 close() 再 drain，否则生产者持续 schedule 时 drain 不会结束
+     */
+    template <typename F>
+    size_t drain(F&& sink, size_t batch = 256) {
+        std::vector<T> buf;
+        buf.reserve(batch);
+        size_t total = 0;
+        for (;;) {
+            std::vector<std::unique_ptr<Chunk>> retired;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                advance_locked(Clock::now());
+                while (buf.size() < batch && live_ != 0) {
+                    if (ready_.head == kNil) expire_all_locked();
+                    buf.push_back(take_ready_locked(retired));
+                }
+            }
+            if (buf.empty()) break;
+            sink(std::span<T>(buf.data(), buf.size()));
+            total += buf.size();
+            buf.clear();
+        }
+        return total;
+    }
+
+    /**
+     * @brief 关闭队列：之后的 schedule 抛 QueueClosedError，阻塞中的 pop 全部唤醒
+     * @note 已到期的元素仍可取走，没有到期元素时 pop 抛 QueueClosedError；重复调用无副作用
+     */
+    void close() {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            if (closed_) return;
+            closed_ = true;
+        }
+        cond_.notify_all();
+    }
+
+    /**
+     * @brief 是否已 close()
+     */
+    bool closed() const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        return closed_;
+    }
+
+    /**
+     * @brief 最近一个需要处理的时刻（已有到期元素时为当前时刻），没有定时器时返回空
+     * @note 挂在高层槽位上的定时器按其下放时刻计算，可能早于真实 deadline，仅作为信息描述
+     */
+    std::optional<time_point> next_deadline() const {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (ready_.head != kNil) return Clock::now();
+        const uint64_t next = next_event_tick_locked();
+        if (next == kNever) return std::nullopt;
+        return time_of(next);
+    }
+
+    /**
+     * @brief 立即释放整块空闲的节点块（不等 shrink_check_interval）
+     * @return 释放的字节数
+     */
+    size_t shrink_to_fit() {
+        std::vector<std::unique_ptr<Chunk>> retired;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            release_empty_chunks_locked(retired);
+            publish_locked();
+        }
+        return retired.size() * sizeof(Chunk);
+    }
+
+    /**
+     * @brief 开关按出队/取消次数触发的自动收缩
+     */
+    void set_auto_shrink(bool enabled) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        auto_shrink_enabled_ = enabled;
+    }
+
+    /**
+     * @brief 尚未出队的定时器数（含已到期未取走的），原子快照
+     */
+    size_t size() const { return size_snapshot_.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief 历史最大定时器数，仅作为信息描述（原子快照，不加锁）
+     */
+    size_t last_high_mark() const { return high_mark_snapshot_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 累计真正执行 shrink 的次数，仅作为信息描述（原子快照，不加锁）
+     */
+    size_t shrink_count() const { return shrink_count_snapshot_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 当前已分配的节点数（节点块数 × kChunkNodes），原子快照
+     */
+    size_t node_capacity() const { return node_capacity_snapshot_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 单个节点块的字节数，用于估算 node_capacity() 对应的内存
+     */
+    static constexpr size_t chunk_bytes() { return sizeof(Chunk); }
+
+    std::chrono::nanoseconds tick() const { return tick_; }
+
+private:
+    static constexpr uint32_t kNil = std::numeric_limits<uint32_t>::max();
+    static constexpr uint64_t kNever = std::numeric_limits<uint64_t>::max();
+    static constexpr uint16_t kReadyList = kLevels * kSlots;
+    static constexpr uint16_t kFreeList = kReadyList + 1;
+    static constexpr uint64_t kMaxSpan = uint64_t{1} << (kLevels * kSlotBits); // 时间轮覆盖的 tick 数
+
+    struct Node {
+        std::optional<T> value;
+        uint64_t expiry = 0; // 到期 tick
+        uint64_t seq = 0;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint16_t list = kFreeList; // 所在链表：槽位编号 / kReadyList / kFreeList
+    };
+
+    struct Chunk {
+        std::array<Node, kChunkNodes> nodes;
+        size_t live = 0;
+    };
+
+    struct List {
+        uint32_t head = kNil;
+        uint32_t tail = kNil;
+    };
+
+    Node& node(uint32_t idx) { return chunks_[idx / kChunkNodes]->nodes[idx % kChunkNodes]; }
+
+    // ---- tick 与时间换算：到期 tick 向上取整，保证不会早于 deadline 出队 ----
+    uint64_t tick_of(time_point t) const {
+        if (t <= origin_) return 0;
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t - origin_).count();
+        const auto ticks = (ns + tick_.count() - 1) / tick_.count();
+        return static_cast<uint64_t>(ticks);
+    }
+    uint64_t elapsed_ticks(time_point now) const {
+        if (now <= origin_) return 0;
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(now - origin_).count();
+        return static_cast<uint64_t>(ns / tick_.count());
+    }
+    time_point time_of(uint64_t tick) const {
+        return origin_ + std::chrono::duration_cast<duration>(tick_ * static_cast<int64_t>(tick));
+    }
+
+    // ---- 节点分配：空闲链表后进先出复用（热节点优先，空下来的块才能整块释放），空了再申请新块 ----
+    uint32_t allocate_locked() {
+        if (free_.head == kNil) {
+            size_t slot = 0;
+            while (slot < chunks_.size() && chunks_[slot]) ++slot;
+            if (slot == chunks_.size()) chunks_.emplace_back();
+            chunks_[slot] = std::make_unique<Chunk>();
+            ++chunk_count_;
+            for (size_t i = 0; i < kChunkNodes; ++i) {
+                push_back_locked(free_, static_cast<uint32_t>(slot * kChunkNodes + i), kFreeList);
+            }
+        }
+        const uint32_t idx = free_.head;
+        unlink_locked(idx);
+        ++chunks_[idx / kChunkNodes]->live;
+        return idx;
+    }
+
+    void release_locked(uint32_t idx) {
+        Node& n = node(idx);
+        n.value.reset();
+        n.seq = 0;
+        n.list = kFreeList;
+        n.prev = kNil;
+        n.next = free_.head;
+        if (free_.head != kNil) {
+            node(free_.head).prev = idx;
+        } else {
+            free_.tail = idx;
+        }
+        free_.head = idx;
+        --chunks_[idx / kChunkNodes]->live;
+        --live_;
+    }
+
+    List& list_of(uint16_t id) {
+        if (id == kReadyList) return ready_;
+        if (id == kFreeList) return free_;
+        return slots_[id];
+    }
+
+    void push_back_locked(List& l, uint32_t idx, uint16_t id) {
+        Node& n = node(idx);
+        n.list = id;
+        n.prev = l.tail;
+        n.next = kNil;
+        if (l.tail != kNil) {
+            node(l.tail).next = idx;
+        } else {
+            l.head = idx;
+        }
+        l.tail = idx;
+        if (id < kReadyList) occupied_[id / kSlots][(id % kSlots) / 64] |= uint64_t{1} << (id % 64);
+    }
+
+    void unlink_locked(uint32_t idx) {
+        Node& n = node(idx);
+        List& l = list_of(n.list);
+        if (n.prev != kNil) {
+            node(n.prev).next = n.next;
+        } else {
+            l.head = n.next;
+        }
+        if (n.next != kNil) {
+            node(n.next).prev = n.prev;
+        } else {
+            l.tail = n.prev;
+        }
+        if (n.list < kReadyList && l.head == kNil) {
+            occupied_[n.list / kSlots][(n.list % kSlots) / 64] &= ~(uint64_t{1} << (n.list % 64));
+        }
+        n.prev = n.next = kNil;
+    }
+
+    // 按到期 tick 与当前 tick 的距离选层：距离 < 256^(k+1) 放第 k 层，槽位取 expiry 的第 k 组 8 位
+    void place_locked(uint32_t idx) {
+        const uint64_t e = node(idx).expiry;
+        if (e < current_) {
+            push_back_locked(ready_, idx, kReadyList);
+            return;
+        }
+        const uint64_t diff = e - current_;
+        uint64_t target = e;
+        size_t level = 0;
+        if (diff >= kMaxSpan) { // 超出覆盖范围：先挂在最高层最远的槽，下放时按真实 expiry 重新放置
+            level = kLevels - 1;
+            target = current_ + kMaxSpan - 1;
+        } else {
+            while (diff >= (uint64_t{1} << ((level + 1) * kSlotBits))) ++level;
+        }
+        const size_t slot = (target >> (level * kSlotBits)) & (kSlots - 1);
+        push_back_locked(slots_[level * kSlots + slot], idx, static_cast<uint16_t>(level * kSlots + slot));
+    }
+
+    // 把第 level 层 slot 槽里的定时器按当前 tick 重新放置（整体下放到低层）
+    void cascade_locked(size_t level, size_t slot) {
+        List& l = slots_[level * kSlots + slot];
+        uint32_t idx = l.head;
+        l.head = l.tail = kNil;
+        occupied_[level][slot / 64] &= ~(uint64_t{1} << (slot % 64));
+        while (idx != kNil) {
+            const uint32_t next = node(idx).next;
+            place_locked(idx);
+            idx = next;
+        }
+    }
+
+    // current_ 刚推进到 t：在每层的块边界上把该层当前槽下放（低层先，与内核时间轮一致）
+    void enter_tick_locked(uint64_t t) {
+        current_ = t;
+        for (size_t level = 1; level < kLevels; ++level) {
+            if ((t & ((uint64_t{1} << (level * kSlotBits)) - 1)) != 0) break;
+            cascade_locked(level, (t >> (level * kSlotBits)) & (kSlots - 1));
+        }
+    }
+
+    // 从 from 开始（含）环形查找第一个非空槽，返回距离，没有时返回 kSlots
+    size_t next_occupied(size_t level, size_t from) const {
+        size_t dist = 0;
+        while (dist < kSlots) {
+            const size_t pos = (from + dist) & (kSlots - 1);
+            const uint64_t bits = occupied_[level][pos / 64] >> (pos % 64);
+            if (bits != 0) return std::min(dist + static_cast<size_t>(std::countr_zero(bits)), kSlots);
+            dist += 64 - pos % 64;
+        }
+        return kSlots;
+    }
+
+    // 下一个需要处理的 tick：最低层为到期 tick，高层为该槽的下放 tick
+    uint64_t next_event_tick_locked() const {
+        if (live_ == 0) return kNever;
+        uint64_t best = kNever;
+        const size_t d0 = next_occupied(0, current_ & (kSlots - 1));
+        if (d0 < kSlots) best = current_ + d0;
+        for (size_t level = 1; level < kLevels; ++level) {
+            const uint64_t base = current_ >> (level * kSlotBits);
+            // 当前索引的槽已在进入本块时下放过，里面只可能是绕了一整圈的定时器
+            const size_t d = next_occupied(level, (base + 1) & (kSlots - 1));
+            if (d == kSlots) continue;
+            const uint64_t t = (base + d + 1) << (level * kSlotBits);
+            if (t < best) best = t;
+        }
+        return best;
+    }
+
+    // 推进到 now：所有到期 tick <= now 的定时器移入就绪链表；靠占用位图直接跳到下一个事件 tick
+    void advance_locked(time_point now) {
+        const uint64_t target = elapsed_ticks(now);
+        while (current_ <= target) {
+            const uint64_t next = next_event_tick_locked();
+            if (next > target) {
+                enter_tick_locked(target + 1);
+                break;
+            }
+            if (next != current_) enter_tick_locked(next);
+            const size_t slot = current_ & (kSlots - 1);
+            if (occupied_[0][slot / 64] & (uint64_t{1} << (slot % 64))) expire_slot_locked(slot);
+            enter_tick_locked(current_ + 1);
+        }
+    }
+
+    void expire_slot_locked(size_t slot) {
+        List& l = slots_[slot];
+        while (l.head != kNil) {
+            const uint32_t idx = l.head;
+            unlink_locked(idx);
+            push_back_locked(ready_, idx, kReadyList);
+        }
+    }
+
+    // 停机时把所有未到期定时器按层由低到高、槽由近及远移入就绪链表
+    void expire_all_locked() {
+        for (size_t level = 0; level < kLevels; ++level) {
+            const size_t from = (current_ >> (level * kSlotBits)) & (kSlots - 1);
+            for (size_t i = 0; i < kSlots; ++i) {
+                List& l = slots_[level * kSlots + ((from + i) & (kSlots - 1))];
+                while (l.head != kNil) {
+                    const uint32_t idx = l.head;
+                    unlink_locked(idx);
+                    push_back_locked(ready_, idx, kReadyList);
+                }
+            }
+        }
+    }
+
+    T take_ready_locked(std::vector<std::unique_ptr<Chunk>>& retired) {
+        const uint32_t idx = ready_.head;
+        unlink_locked(idx);
+        T val = std::move(*node(idx).value);
+        release_locked(idx);
+        auto_shrink(retired);
+        publish_locked();
+        return val;
+    }
+
+    void auto_shrink(std::vector<std::unique_ptr<Chunk>>& retired) {
+        if (shrink_policy_.on_remove(live_) && auto_shrink_enabled_) {
+            release_empty_chunks_locked(retired);
+        }
+    }
+
+    // 摘走所有无存活节点的块（由调用方在锁外析构），并从空闲链表里去掉这些块的节点
+    void release_empty_chunks_locked(std::vector<std::unique_ptr<Chunk>>& retired) {
+        bool any = false;
+        for (auto& c : chunks_) any = any || (c && c->live == 0);
+        if (any) {
+            uint32_t idx = free_.head;
+            List kept;
+            while (idx != kNil) {
+                const uint32_t next = node(idx).next;
+                if (chunks_[idx / kChunkNodes]->live != 0) push_back_locked(kept, idx, kFreeList);
+                idx = next;
+            }
+            free_ = kept;
+            for (auto& c : chunks_) {
+                if (c && c->live == 0) retired.push_back(std::move(c));
+            }
+            chunk_count_ -= retired.size();
+            while (!chunks_.empty() && !chunks_.back()) chunks_.pop_back();
+        }
+        shrink_policy_.on_shrunk(live_);
+    }
+
+    void publish_locked() {
+        size_snapshot_.store(live_, std::memory_order_relaxed);
+        high_mark_snapshot_.store(shrink_policy_.high_mark(), std::memory_order_relaxed);
+        shrink_count_snapshot_.store(shrink_policy_.shrink_count(), std::memory_order_relaxed);
+        node_capacity_snapshot_.store(chunk_count_ * kChunkNodes, std::memory_order_relaxed);
+    }
+
+    // 只读配置
+    const std::chrono::nanoseconds tick_;
+    const time_point origin_;
+
+    // 锁及锁保护的状态
+    alignas(kCacheLineSize) mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<Chunk>> chunks_; // 释放后的位置留空，节点编号 = 块位置 × kChunkNodes + 块内下标
+    std::array<List, kLevels * kSlots> slots_{};
+    std::array<std::array<uint64_t, kSlots / 64>, kLevels> occupied_{};
+    List ready_;
+    List free_;
+    uint64_t current_ = 0;     // 下一个待处理的 tick，之前的 tick 均已处理
+    uint64_t wait_tick_ = kNever; // 睡眠中的消费者约定的最早醒来 tick
+    uint64_t next_seq_ = 0;
+    size_t live_ = 0;
+    size_t chunk_count_ = 0;
+    size_t sleeping_ = 0;      // 阻塞在 cond_ 上的消费者数
+    ShrinkPolicy shrink_policy_;
+    bool auto_shrink_enabled_ = true;
+    bool closed_ = false;
+
+    alignas(kCacheLineSize) std::condition_variable cond_;
+
+    // 无锁读取的快照
+    alignas(kCacheLineSize) std::atomic<size_t> size_snapshot_{0};
+    std::atomic<size_t> high_mark_snapshot_{0};
+    std::atomic<size_t> shrink_count_snapshot_{0};
+    std::atomic<size_t> node_capacity_snapshot_{0};
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdint>
+#include <cerrno>
+
+#include "queueNotifier.h"
+
+/**
+ * @brief 基于 eventfd 的队列通知器，便于把队列接入 epoll 事件循环（仅 Linux）
+ *
+ * 只在 空→非空 的转变时写 eventfd，且在 reactor 调用 consume() 之前多次转变只写一次（合并唤醒）。
+ * 典型用法（fd 以 EPOLLIN 注册）：
+ *   可读 -> q.consume_eventfd() -> q.drain_into(out, batch) -> 处理 out
+ * consume 必须先于 drain，否则可能丢失 drain 之后到达元素的唤醒。
+ */
+class EventFdNotifier final : public QueueNotifier {
+public:
+    EventFdNotifier() : fd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) {}
+    ~EventFdNotifier() override {
+        if (fd_ >= 0) ::close(fd_);
+    }
+    EventFdNotifier(const EventFdNotifier&) = delete;
+    EventFdNotifier& operator=(const EventFdNotifier&) = delete;
+
+    bool valid() const { return fd_ >= 0; }
+    int fd() const { return fd_; }
+
+    void notify(bool was_empty) noexcept override {
+        if (was_empty) signal();
+    }
+
+    /**
+     * @brief 使 fd 变为可读；已处于已触发未消费状态时不重复写
+     */
+    void signal() noexcept {
+        if (signaled_.exchange(true, std::memory_order_acq_rel)) return;
+        uint64_t one = 1;
+        ssize_t n;
+        do {
+            n = ::write(fd_, &one, sizeof(one));
+        } while (n < 0 && errno == EINTR);
+    }
+
+    /**
+     * @brief reactor 侧清除可读状态
+     * @return 自上次 consume 以来写入的次数（合并后通常为 1），未触发时为 0
+     * @note 先读空 eventfd 再清标志：若反过来，清标志与 read 之间到达的 signal 写入会被这次 read 吞掉，
+     *       标志却停在 true，之后的 signal 全部被合并掉，fd 再也不会可读。
+     *       按现在的顺序，read 与清标志之间到达的 signal 会被合并跳过，它的元素由紧随其后的 drain 取走。
+     */
+    uint64_t consume() noexcept {
+        uint64_t value = 0;
+        ssize_t n;
+        do {
+            n = ::read(fd_, &value, sizeof(value));
+        } while (n < 0 && errno == EINTR);
+        signaled_.store(false, std::memory_order_release);
+        return n == sizeof(value) ? value : 0;
+    }
+
+private:
+    int fd_;
+    std::atomic<bool> signaled_{false};
+};
+
+#endif // __linux__
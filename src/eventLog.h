@@ -0,0 +1,536 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <spdlog/fmt/fmt.h>
+
+#include "cacheLine.h"
+#include "mappedFile.h"
+
+/**
+ * @brief 二进制事件记录，定长 32 字节
+ *
+ * 热路径上只写原始数值（事件号 + 两个参数），格式化推迟到 EventLogReader 离线完成。
+ */
+struct EventRecord {
+    uint64_t ts_ns;     // steady_clock 纳秒
+    uint64_t a;
+    uint64_t b;
+    uint32_t thread;    // EventLog 内部分配的线程序号，从 1 开始
+    uint16_t event;     // register_event 返回的事件号
+    uint16_t reserved;
+};
+static_assert(sizeof(EventRecord) == 32, "EventRecord must stay 32 bytes");
+
+namespace event_log_detail {
+
+constexpr char kMagic[8] = {'Q', 'E', 'V', 'L', 'O', 'G', '0', '1'};
+constexpr uint32_t kVersion = 1;
+
+// 文件头，固定 64 字节；后面紧跟 record_count 条 EventRecord，再后面是事件字典
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t start_steady_ns;   // 会话开始时的 steady_clock，解码时据此输出相对时间
+    int64_t start_system_ns;    // 会话开始时的 system_clock，用于换算成墙钟时间
+    uint64_t record_count;      // 每批刷盘后更新，进程崩溃时已刷入的记录仍然可读
+    uint64_t dropped;
+    uint64_t dict_offset;       // 事件字典偏移，stop() 时写入；0 表示没有字典
+    uint64_t dict_count;
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader must stay 64 bytes");
+
+inline uint64_t SteadyNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief 单生产者（所属线程）单消费者（刷盘线程）的定长环形缓冲
+ *
+ * 满时直接丢弃并计数，绝不阻塞热路径。生产者缓存消费者位置，大部分 push 不读共享的 tail。
+ */
+class EventRing {
+public:
+    EventRing(size_t capacity, uint32_t thread)
+        : capacity_(capacity), mask_(capacity - 1), thread_(thread),
+          buffer_(std::make_unique<EventRecord[]>(capacity)) {}
+
+    bool try_push(const EventRecord& rec) {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ >= capacity_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ >= capacity_) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        buffer_[head & mask_] = rec;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief 消费者侧：把当前可读的记录按连续片段交给 sink(const EventRecord*, size_t)
+     * @return 读出的记录数
+     */
+    template <typename Sink>
+    size_t drain(Sink&& sink) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        uint64_t head = head_.load(std::memory_order_acquire);
+        size_t total = 0;
+        while (tail < head) {
+            size_t offset = static_cast<size_t>(tail & mask_);
+            size_t n = std::min(static_cast<size_t>(head - tail), capacity_ - offset);
+            sink(buffer_.get() + offset, n);
+            tail += n;
+            total += n;
+        }
+        tail_.store(tail, std::memory_order_release);
+        return total;
+    }
+
+    bool empty() const {
+        return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire);
+    }
+
+    uint32_t thread() const { return thread_; }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // 所属线程退出后置位，刷盘线程读空后摘除
+    std::atomic<bool> retired{false};
+
+private:
+    const size_t capacity_;
+    const size_t mask_;
+    const uint32_t thread_;
+    std::unique_ptr<EventRecord[]> buffer_;
+
+    alignas(kCacheLineSize) std::atomic<uint64_t> head_{0};
+    uint64_t cached_tail_ = 0;
+    std::atomic<uint64_t> dropped_{0};
+    alignas(kCacheLineSize) std::atomic<uint64_t> tail_{0};
+};
+
+// 线程退出时把本线程持有的所有 ring 标记为 retired
+struct ThreadRings {
+    struct Entry {
+        uint64_t session;
+        std::shared_ptr<EventRing> ring;
+    };
+    ~ThreadRings() {
+        for (auto& e : entries) e.ring->retired.store(true, std::memory_order_release);
+    }
+    std::vector<Entry> entries;
+    uint64_t cached_session = 0;
+    EventRing* cached_ring = nullptr;
+};
+
+inline ThreadRings& LocalRings() {
+    thread_local ThreadRings rings;
+    return rings;
+}
+
+inline std::atomic<uint64_t>& SessionCounter() {
+    static std::atomic<uint64_t> counter{0};
+    return counter;
+}
+
+} // namespace event_log_detail
+
+/**
+ * @brief 热路径埋点用的低开销二进制事件日志
+ *
+ * 每个写线程首次 record 时分到一个自己的 SPSC 环形缓冲，record 只做一次时钟读取和一次 32 字节拷贝，
+ * 没有锁、没有格式化、没有系统调用。后台线程按 flush_interval 批量把各环形缓冲搬进内存映射文件，
+ * 文件按 file_grow_bytes 分段扩展，stop() 时写入事件字典并截到实际长度。
+ * 格式化推迟到 EventLogReader 离线完成，测量区间内不再混入 spdlog 的格式化与 flush I/O。
+ * 缓冲满时丢弃并计入 dropped()，不会阻塞调用者；未 start 时 record 只有一次原子读。
+ *
+ * 用法：
+ *   auto& log = EventLog::instance();
+ *   uint16_t ev_push = log.register_event("push", "size={} high_mark={}");
+ *   log.start("queue.evlog");
+ *   log.record(ev_push, q.size(), q.last_high_mark());
+ *   log.stop();
+ *   EventLogReader reader; reader.open("queue.evlog"); reader.dump(std::cout);
+ */
+class EventLog {
+public:
+    struct Options {
+        size_t ring_capacity = 16384;                       // 每线程缓冲的记录数，向上取整为 2 的幂
+        std::chrono::milliseconds flush_interval{2};         // 刷盘线程的批量间隔
+        size_t file_grow_bytes = 64 * 1024 * 1024;           // 映射文件每次扩展的字节数
+    };
+
+    EventLog() = default;
+    ~EventLog() { stop(); }
+
+    EventLog(const EventLog&) = delete;
+    EventLog& operator=(const EventLog&) = delete;
+
+    static EventLog& instance() {
+        static EventLog log;
+        return log;
+    }
+
+    // register_event 失败时返回的事件号，record 对它直接返回 false
+    static constexpr uint16_t kInvalidEvent = UINT16_MAX;
+
+    /**
+     * @brief 注册事件，线程安全，可在 start 前后调用；同名事件返回已有的事件号
+     * @param format fmt 格式串，最多引用两个参数（a、b），如 "size={} high_mark={}"
+     * @return 事件号；已注册满 kInvalidEvent 个事件，或 name/format 超过 UINT16_MAX 字节（字典里按 uint16 存长度）时返回 kInvalidEvent
+     */
+    uint16_t register_event(const std::string& name, const std::string& format = "{} {}") {
+        std::lock_guard<std::mutex> lock(dict_mutex_);
+        if (auto it = dict_index_.find(name); it != dict_index_.end()) return it->second;
+        if (dict_.size() >= kInvalidEvent || name.size() > UINT16_MAX || format.size() > UINT16_MAX) {
+            return kInvalidEvent;
+        }
+        const uint16_t id = static_cast<uint16_t>(dict_.size());
+        dict_.emplace_back(name, format);
+        dict_index_.emplace(name, id);
+        return id;
+    }
+
+    /**
+     * @brief 新建事件文件并启动刷盘线程
+     * @return 已在运行或文件创建失败时返回 false
+     */
+    bool start(const std::string& path, Options options) {
+        std::lock_guard<std::mutex> control(control_mutex_);
+        if (running_.load(std::memory_order_relaxed)) return false;
+        options_ = options;
+        options_.ring_capacity = std::bit_ceil(std::max<size_t>(options_.ring_capacity, 64));
+        options_.file_grow_bytes = std::max(options_.file_grow_bytes, sizeof(event_log_detail::FileHeader) + 4096);
+        if (!file_.create(path, options_.file_grow_bytes)) return false;
+
+        auto* h = header();
+        std::memset(h, 0, sizeof(*h));
+        std::memcpy(h->magic, event_log_detail::kMagic, sizeof(h->magic));
+        h->version = event_log_detail::kVersion;
+        h->record_size = sizeof(EventRecord);
+        h->start_steady_ns = event_log_detail::SteadyNowNs();
+        h->start_system_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        write_offset_ = sizeof(event_log_detail::FileHeader);
+
+        flushed_.store(0, std::memory_order_relaxed);
+        batches_.store(0, std::memory_order_relaxed);
+        retired_dropped_ = 0;
+        next_thread_ = 0;
+        stop_requested_ = false;
+        session_.store(event_log_detail::SessionCounter().fetch_add(1, std::memory_order_relaxed) + 1,
+                       std::memory_order_relaxed);
+        running_.store(true, std::memory_order_release);
+        flusher_ = std::thread([this] { flush_loop(); });
+        return true;
+    }
+    bool start(const std::string& path) { return start(path, Options{}); }
+
+    /**
+     * @brief 停止刷盘线程，读空所有缓冲，写入事件字典并把文件截到实际长度
+     * @note 与 stop 并发的 record 可能落在最后一次读空之后而丢失
+     */
+    void stop() {
+        std::lock_guard<std::mutex> control(control_mutex_);
+        if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+        {
+            std::lock_guard<std::mutex> lock(flush_mutex_);
+            stop_requested_ = true;
+        }
+        flush_cv_.notify_one();
+        flusher_.join();
+        write_dictionary();
+        file_.flush();
+        file_.close(write_offset_);
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.clear();
+    }
+
+    /**
+     * @brief 热路径埋点：记录一条事件
+     * @return 未运行、本线程缓冲已满或 event 为 kInvalidEvent 时返回 false
+     */
+    bool record(uint16_t event, uint64_t a = 0, uint64_t b = 0) {
+        if (event == kInvalidEvent || !running_.load(std::memory_order_acquire)) return false;
+        auto& local = event_log_detail::LocalRings();
+        uint64_t session = session_.load(std::memory_order_relaxed);
+        EventRing* ring = local.cached_session == session ? local.cached_ring : attach(local, session);
+        return ring->try_push(EventRecord{event_log_detail::SteadyNowNs(), a, b, ring->thread(), event, 0});
+    }
+
+    /**
+     * @brief 唤醒刷盘线程立即搬运一批，并等待这一批完成（测试和阶段切换时使用）
+     */
+    void flush() {
+        if (!running_.load(std::memory_order_acquire)) return;
+        std::unique_lock<std::mutex> lock(flush_mutex_);
+        uint64_t target = ++flush_requested_;
+        flush_cv_.notify_one();
+        flush_done_cv_.wait(lock, [&] { return flush_completed_ >= target || stop_requested_; });
+    }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief 已写入文件的记录数，仅作为信息描述
+     */
+    uint64_t flushed_records() const { return flushed_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 刷盘线程执行的批次数，仅作为信息描述
+     */
+    uint64_t flush_batches() const { return batches_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief 因缓冲满被丢弃的记录数（本次会话），仅作为信息描述
+     */
+    uint64_t dropped() const {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        uint64_t n = retired_dropped_;
+        for (auto& r : rings_) n += r->dropped();
+        return n;
+    }
+
+private:
+    using EventRing = event_log_detail::EventRing;
+
+    // 映射丢失（扩展失败且无法恢复原映射）时为 nullptr，调用方跳过文件头更新
+    event_log_detail::FileHeader* header() {
+        return reinterpret_cast<event_log_detail::FileHeader*>(file_.data());
+    }
+
+    // 本线程在当前会话的第一次 record：查找或新建 ring 并登记到刷盘线程
+    EventRing* attach(event_log_detail::ThreadRings& local, uint64_t session) {
+        auto& entries = local.entries;
+        // 顺手清掉已结束会话留下的 ring
+        std::erase_if(entries, [](const auto& e) { return e.ring.use_count() == 1; });
+        EventRing* ring = nullptr;
+        for (auto& e : entries) {
+            if (e.session == session) ring = e.ring.get();
+        }
+        if (!ring) {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            auto r = std::make_shared<EventRing>(options_.ring_capacity, ++next_thread_);
+            rings_.push_back(r);
+            entries.push_back({session, r});
+            ring = r.get();
+        }
+        local.cached_session = session;
+        local.cached_ring = ring;
+        return ring;
+    }
+
+    void flush_loop() {
+        std::unique_lock<std::mutex> lock(flush_mutex_);
+        for (;;) {
+            flush_cv_.wait_for(lock, options_.flush_interval,
+                               [&] { return stop_requested_ || flush_requested_ > flush_completed_; });
+            bool stopping = stop_requested_;
+            uint64_t requested = flush_requested_;
+            lock.unlock();
+            drain_all();
+            lock.lock();
+            flush_completed_ = requested;
+            flush_done_cv_.notify_all();
+            if (stopping) break;
+        }
+    }
+
+    // 把所有线程缓冲中的记录追加到映射文件，并摘除已退出且读空的线程缓冲
+    void drain_all() {
+        std::vector<std::shared_ptr<EventRing>> rings;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings = rings_;
+        }
+        uint64_t written = 0;
+        for (auto& r : rings) {
+            r->drain([&](const EventRecord* recs, size_t n) {
+                if (append(recs, n * sizeof(EventRecord))) written += n;
+            });
+        }
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            std::erase_if(rings_, [&](const std::shared_ptr<EventRing>& r) {
+                if (!r->retired.load(std::memory_order_acquire) || !r->empty()) return false;
+                retired_dropped_ += r->dropped();
+                return true;
+            });
+            if (auto* h = header()) {
+                h->dropped = retired_dropped_;
+                for (auto& r : rings_) h->dropped += r->dropped();
+            }
+        }
+        if (written == 0) return;
+        flushed_.fetch_add(written, std::memory_order_relaxed);
+        batches_.fetch_add(1, std::memory_order_relaxed);
+        if (auto* h = header()) h->record_count = flushed_.load(std::memory_order_relaxed);
+    }
+
+    // 文件扩展失败时丢弃这一段，返回 false（MappedFile::resize 失败时保留原映射，之前写入的内容不受影响）
+    bool append(const void* src, size_t bytes) {
+        if (!file_.data()) return false;
+        if (write_offset_ + bytes > file_.size()) {
+            size_t need = write_offset_ + bytes - file_.size();
+            if (!file_.resize(file_.size() + std::max(options_.file_grow_bytes, need))) return false;
+        }
+        std::memcpy(file_.data() + write_offset_, src, bytes);
+        write_offset_ += bytes;
+        return true;
+    }
+
+    // 字典格式：每项 [uint16 name_len][uint16 format_len][name][format]
+    // 任何一段写入失败都不发布字典（dict_count 保持 0），并退回写入位置，文件截断后不留半截字典
+    void write_dictionary() {
+        std::lock_guard<std::mutex> lock(dict_mutex_);
+        const size_t offset = write_offset_;
+        bool ok = true;
+        for (auto& [name, format] : dict_) {
+            uint16_t lens[2] = {static_cast<uint16_t>(name.size()), static_cast<uint16_t>(format.size())};
+            ok = ok && append(lens, sizeof(lens)) && append(name.data(), name.size()) &&
+                 append(format.data(), format.size());
+        }
+        auto* h = header();
+        if (!ok || !h) {
+            write_offset_ = offset;
+            return;
+        }
+        h->dict_offset = offset;
+        h->dict_count = dict_.size();
+    }
+
+    Options options_;
+    MappedFile file_;
+    size_t write_offset_ = 0;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> session_{0};
+
+    std::mutex control_mutex_;          // 串行化 start/stop
+
+    std::mutex flush_mutex_;
+    std::condition_variable flush_cv_;
+    std::condition_variable flush_done_cv_;
+    bool stop_requested_ = false;
+    uint64_t flush_requested_ = 0;
+    uint64_t flush_completed_ = 0;
+    std::thread flusher_;
+
+    mutable std::mutex rings_mutex_;
+    std::vector<std::shared_ptr<EventRing>> rings_;
+    uint32_t next_thread_ = 0;
+    uint64_t retired_dropped_ = 0;
+
+    std::mutex dict_mutex_;
+    std::vector<std::pair<std::string, std::string>> dict_;     // 下标即事件号
+    std::unordered_map<std::string, uint16_t> dict_index_;
+
+    std::atomic<uint64_t> flushed_{0};
+    std::atomic<uint64_t> batches_{0};
+};
+
+/**
+ * @brief 离线读取 EventLog 文件并做延后的格式化
+ *
+ * 文件只读映射，records() 直接返回映射内的记录数组，不拷贝。
+ * 未正常 stop 的文件（进程崩溃）没有事件字典，格式化时退化为 "event#N a b"。
+ */
+class EventLogReader {
+public:
+    struct EventInfo {
+        std::string name;
+        std::string format;
+    };
+
+    bool open(const std::string& path) {
+        events_.clear();
+        if (!file_.open_read(path) || file_.size() < sizeof(event_log_detail::FileHeader)) return false;
+        std::memcpy(&header_, file_.data(), sizeof(header_));
+        if (std::memcmp(header_.magic, event_log_detail::kMagic, sizeof(header_.magic)) != 0 ||
+            header_.record_size != sizeof(EventRecord)) {
+            return false;
+        }
+        size_t max_records = (file_.size() - sizeof(header_)) / sizeof(EventRecord);
+        record_count_ = static_cast<size_t>(std::min<uint64_t>(header_.record_count, max_records));
+        read_dictionary();
+        return true;
+    }
+
+    const EventRecord* records() const {
+        return reinterpret_cast<const EventRecord*>(file_.data() + sizeof(event_log_detail::FileHeader));
+    }
+    size_t record_count() const { return record_count_; }
+    uint64_t dropped() const { return header_.dropped; }
+    uint64_t start_steady_ns() const { return header_.start_steady_ns; }
+    const std::vector<EventInfo>& events() const { return events_; }
+
+    const char* event_name(uint16_t event) const {
+        return event < events_.size() ? events_[event].name.c_str() : "";
+    }
+
+    /**
+     * @brief 格式化单条记录的参数部分
+     */
+    std::string format_args(const EventRecord& rec) const {
+        if (rec.event >= events_.size()) return fmt::format("event#{} {} {}", rec.event, rec.a, rec.b);
+        try {
+            return fmt::vformat(events_[rec.event].format, fmt::make_format_args(rec.a, rec.b));
+        } catch (const fmt::format_error&) {
+            return fmt::format("{} {}", rec.a, rec.b);
+        }
+    }
+
+    /**
+     * @brief 按 "+相对微秒 T线程 事件名 参数" 的格式输出全部记录（按各线程写入顺序，不做全局排序）
+     * @param limit 最多输出的条数，0 表示不限
+     */
+    void dump(std::ostream& os, size_t limit = 0) const {
+        size_t n = limit == 0 ? record_count_ : std::min(limit, record_count_);
+        const EventRecord* recs = records();
+        for (size_t i = 0; i < n; ++i) {
+            const EventRecord& r = recs[i];
+            double us = static_cast<double>(r.ts_ns - header_.start_steady_ns) / 1000.0;
+            os << fmt::format("+{:.3f}us T{} {} {}\n", us, r.thread, event_name(r.event), format_args(r));
+        }
+    }
+
+private:
+    void read_dictionary() {
+        if (header_.dict_offset == 0) return;
+        size_t pos = static_cast<size_t>(header_.dict_offset);
+        for (uint64_t i = 0; i < header_.dict_count; ++i) {
+            uint16_t lens[2];
+            if (pos + sizeof(lens) > file_.size()) break;
+            std::memcpy(lens, file_.data() + pos, sizeof(lens));
+            pos += sizeof(lens);
+            if (pos + lens[0] + lens[1] > file_.size()) break;
+            EventInfo info;
+            info.name.assign(file_.data() + pos, lens[0]);
+            info.format.assign(file_.data() + pos + lens[0], lens[1]);
+            pos += lens[0] + lens[1];
+            events_.push_back(std::move(info));
+        }
+    }
+
+    MappedFile file_;
+    event_log_detail::FileHeader header_{};
+    size_t record_count_ = 0;
+    std::vector<EventInfo> events_;
+};
@@ -0,0 +1,61 @@
+#include "eventLogTest.h"
+#include "eventLog.h"
+#include "adapterQueue.h"
+
+#include <chrono>
+#include <filesystem>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <spdlog/spdlog.h>
+
+// 多生产者压 AutoShrinkBlockingQueue，push/pop 全程用 EventLog 埋点，结束后离线解码
+void TestEventLog() {
+    SPDLOG_INFO("[Begin] Part:event log test===========");
+    const std::string path = (std::filesystem::temp_directory_path() / "queue_events.evlog").string();
+
+    auto& log = EventLog::instance();
+    const uint16_t ev_push = log.register_event("push", "size={}");
+    const uint16_t ev_pop = log.register_event("pop", "size={} high_mark={}");
+    if (!log.start(path)) {
+        SPDLOG_ERROR("event log start failed: {}", path);
+        return;
+    }
+
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 250000;
+    AutoShrinkBlockingQueue<int> q;
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                q.push(i);
+                log.record(ev_push, q.size());
+            }
+        });
+    }
+    std::thread consumer([&] {
+        for (int i = 0; i < kProducers * kPerProducer; ++i) {
+            q.pop();
+            log.record(ev_pop, q.size(), q.last_high_mark());
+        }
+    });
+    for (auto& t : producers) t.join();
+    consumer.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    log.stop();
+
+    EventLogReader reader;
+    if (!reader.open(path)) {
+        SPDLOG_ERROR("event log open failed: {}", path);
+        return;
+    }
+    SPDLOG_INFO("event log: {} records ({} dropped) in {:.3f}s, {:.1f}M events/s, file={}",
+                reader.record_count(), reader.dropped(), secs,
+                reader.record_count() / secs / 1e6, path);
+    std::ostringstream os;
+    reader.dump(os, 10);
+    SPDLOG_INFO("first records:\n{}", os.str());
+    SPDLOG_INFO("[End] Part:event log test===========");
+}
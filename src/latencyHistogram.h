@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+/**
+ * @brief 对数-线性分桶的延迟直方图（HdrHistogram 思路的简化版）
+ *
+ * 每个 2 的幂区间再等分 16 个子桶，相对误差约 6%，固定 1K 个桶、无动态分配，
+ * record 只有一次 bit_width 和一次数组自增，可在热路径上直接使用。单线程使用，多线程各持一个再 merge。
+ */
+class LatencyHistogram {
+public:
+    void record(uint64_t value) {
+        ++buckets_[index_of(value)];
+        ++count_;
+        sum_ += value;
+        if (value > max_) max_ = value;
+        if (value < min_) min_ = value;
+    }
+
+    void merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < kBuckets; ++i) buckets_[i] += other.buckets_[i];
+        count_ += other.count_;
+        sum_ += other.sum_;
+        max_ = std::max(max_, other.max_);
+        min_ = std::min(min_, other.min_);
+    }
+
+    void reset() { *this = LatencyHistogram(); }
+
+    /**
+     * @param p 百分位，取值 [0, 100]，如 99.9
+     * @return 对应桶的上界（不超过记录到的最大值），无数据时返回 0
+     */
+    uint64_t percentile(double p) const {
+        if (count_ == 0) return 0;
+        uint64_t target = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(count_)));
+        if (target == 0) target = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i) {
+            seen += buckets_[i];
+            if (seen >= target) return std::min(upper_bound_of(i), max_);
+        }
+        return max_;
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    uint64_t min() const { return count_ ? min_ : 0; }
+    double mean() const { return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+private:
+    static constexpr unsigned kSubBits = 4;                 // 每个 2 的幂区间 16 个子桶
+    static constexpr uint64_t kHalf = 1ull << kSubBits;     // 16
+    static constexpr uint64_t kLinear = kHalf * 2;          // 小于 32 的值逐一计数
+    static constexpr size_t kBuckets = kLinear + (64 - kSubBits) * kHalf;
+
+    static size_t index_of(uint64_t v) {
+        if (v < kLinear) return static_cast<size_t>(v);
+        unsigned shift = static_cast<unsigned>(std::bit_width(v)) - 1 - kSubBits; // v >> shift 落在 [16, 31]
+        return static_cast<size_t>(kLinear + (shift - 1) * kHalf + ((v >> shift) - kHalf));
+    }
+
+    static uint64_t upper_bound_of(size_t idx) {
+        if (idx < kLinear) return idx;
+        uint64_t shift = (idx - kLinear) / kHalf + 1;
+        uint64_t m = (idx - kLinear) % kHalf + kHalf;
+        return ((m + 1) << shift) - 1;
+    }
+
+    std::array<uint64_t, kBuckets> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t max_ = 0;
+    uint64_t min_ = UINT64_MAX;
+};
@@ -0,0 +1,336 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "latencyHistogram.h"
+
+/**
+ * @brief 确定性的负载回放：按到达时间/服务时间轨迹驱动任意队列，统计吞吐、延迟分位、内存与 shrink 次数
+ *
+ * 轨迹既可以从文件读取，也可以用固定种子从 Poisson / 突发 / 昼夜模型生成；
+ * 相同种子在任何平台上生成完全相同的轨迹（不依赖 std:: 分布的实现），便于作为 shrink 参数调优的回归门禁。
+ */
+
+// 轨迹中的一个请求：相对起点的到达时间 + 消费者处理它所需的服务时间
+struct ReplayEvent {
+    uint64_t arrival_ns;
+    uint64_t service_ns;
+};
+
+using ReplayTrace = std::vector<ReplayEvent>;
+
+// ========================== 轨迹文件 ==========================
+
+/**
+ * @brief 读取文本轨迹：每行 "到达时间(us) 服务时间(us)"，# 开头为注释；到达时间须非递减
+ * @return 文件无法打开或格式错误时返回空
+ */
+inline std::optional<ReplayTrace> LoadReplayTrace(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) return std::nullopt;
+    ReplayTrace trace;
+    std::string line;
+    uint64_t last_arrival = 0;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream ls(line);
+        double arrival_us = 0, service_us = 0;
+        if (!(ls >> arrival_us >> service_us) || arrival_us < 0 || service_us < 0) return std::nullopt;
+        uint64_t arrival = static_cast<uint64_t>(arrival_us * 1000.0);
+        if (arrival < last_arrival) return std::nullopt;
+        last_arrival = arrival;
+        trace.push_back({arrival, static_cast<uint64_t>(service_us * 1000.0)});
+    }
+    return trace;
+}
+
+inline bool SaveReplayTrace(const ReplayTrace& trace, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "# arrival_us service_us\n";
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    for (const auto& e : trace) {
+        out << static_cast<double>(e.arrival_ns) / 1000.0 << ' '
+            << static_cast<double>(e.service_ns) / 1000.0 << '\n';
+    }
+    return static_cast<bool>(out);
+}
+
+// ========================== 轨迹生成 ==========================
+
+namespace replay_detail {
+
+// mt19937_64 的输出序列由标准完全规定；这里自己做逆变换采样，保证跨平台逐位一致
+class DeterministicRng {
+public:
+    explicit DeterministicRng(uint64_t seed) : engine_(seed) {}
+
+    // [0, 1)
+    double uniform() { return static_cast<double>(engine_() >> 11) * 0x1.0p-53; }
+
+    double exponential(double mean) { return -std::log(1.0 - uniform()) * mean; }
+
+private:
+    std::mt19937_64 engine_;
+};
+
+// 非齐次 Poisson 过程（thinning 法）：rate_at(t_ns) 为 t 时刻的到达率（每秒），max_rate 为其上界
+template <typename RateFn>
+ReplayTrace GenerateByThinning(RateFn rate_at, double max_rate, std::chrono::nanoseconds duration,
+                               std::chrono::nanoseconds mean_service, uint64_t seed) {
+    DeterministicRng rng(seed);
+    ReplayTrace trace;
+    const double horizon = static_cast<double>(duration.count());
+    const double mean_gap_ns = 1e9 / max_rate;
+    double t = 0;
+    for (;;) {
+        t += rng.exponential(mean_gap_ns);
+        if (t >= horizon) break;
+        double accept = rng.uniform();
+        if (accept * max_rate > rate_at(static_cast<uint64_t>(t))) continue;
+        double service = mean_service.count() > 0 ? rng.exponential(static_cast<double>(mean_service.count())) : 0.0;
+        trace.push_back({static_cast<uint64_t>(t), static_cast<uint64_t>(service)});
+    }
+    return trace;
+}
+
+} // namespace replay_detail
+
+/**
+ * @brief 齐次 Poisson 到达，服务时间服从指数分布
+ * @param rate_per_sec 平均到达率（个/秒）
+ */
+inline ReplayTrace GeneratePoissonTrace(double rate_per_sec, std::chrono::nanoseconds duration,
+                                        std::chrono::nanoseconds mean_service, uint64_t seed) {
+    return replay_detail::GenerateByThinning([&](uint64_t) { return rate_per_sec; },
+                                             rate_per_sec, duration, mean_service, seed);
+}
+
+/**
+ * @brief 突发模型：每个 period 的前 burst_length 内到达率为 burst_rate，其余时间为 base_rate
+ */
+inline ReplayTrace GenerateBurstyTrace(double base_rate, double burst_rate,
+                                       std::chrono::nanoseconds period, std::chrono::nanoseconds burst_length,
+                                       std::chrono::nanoseconds duration,
+                                       std::chrono::nanoseconds mean_service, uint64_t seed) {
+    const uint64_t p = static_cast<uint64_t>(period.count());
+    const uint64_t b = static_cast<uint64_t>(burst_length.count());
+    return replay_detail::GenerateByThinning(
+        [&](uint64_t t) { return (t % p) < b ? burst_rate : base_rate; },
+        std::max(base_rate, burst_rate), duration, mean_service, seed);
+}
+
+/**
+ * @brief 昼夜模型：到达率按正弦变化 mean_rate * (1 + amplitude * sin(2πt/period))，amplitude 取 [0, 1]
+ * @note 回放时通常把"一天"压缩成几秒的 period
+ */
+inline ReplayTrace GenerateDiurnalTrace(double mean_rate, double amplitude, std::chrono::nanoseconds period,
+                                        std::chrono::nanoseconds duration,
+                                        std::chrono::nanoseconds mean_service, uint64_t seed) {
+    const double two_pi_over_period = 2.0 * 3.14159265358979323846 / static_cast<double>(period.count());
+    return replay_detail::GenerateByThinning(
+        [&](uint64_t t) { return mean_rate * (1.0 + amplitude * std::sin(two_pi_over_period * static_cast<double>(t))); },
+        mean_rate * (1.0 + amplitude), duration, mean_service, seed);
+}
+
+// ========================== 回放 ==========================
+
+/**
+ * @brief 回放中在队列里流动的元素，Payload 模拟真实消息大小以体现内存占用
+ */
+template <size_t PayloadBytes = 1024>
+struct ReplayItem {
+    int64_t enqueue_ns = 0;
+    uint64_t service_ns = 0;
+    char payload[PayloadBytes];
+};
+
+struct ReplayOptions {
+    size_t producers = 1;  // 轨迹按轮转拆给多个生产者，每个生产者仍按绝对时间到达
+    size_t consumers = 1;
+    // 进程 RSS 采样函数（字节），为空时不统计内存
+    std::function<size_t()> rss_probe;
+    std::chrono::milliseconds sample_interval{5};
+    // 回放结束、队列清空后再等待多久读取"稳定后"的 RSS
+    std::chrono::milliseconds settle_time{200};
+};
+
+struct ReplayResult {
+    uint64_t elements = 0;
+    double elapsed_sec = 0;
+    double throughput = 0;        // 个/秒
+    LatencyHistogram latency_ns;  // push -> 开始处理 的排队延迟
+    uint64_t max_schedule_lag_ns = 0; // 生产者落后于轨迹的最大时间，过大说明回放机跟不上轨迹
+    size_t baseline_rss = 0;
+    size_t peak_rss = 0;
+    size_t settled_rss = 0;
+    size_t shrink_count = 0;
+};
+
+/**
+ * @brief 回归门禁阈值，0 表示不检查该项
+ */
+struct ReplayBudget {
+    uint64_t max_p99_ns = 0;
+    uint64_t max_p999_ns = 0;
+    size_t max_peak_rss_delta = 0;    // 相对 baseline
+    size_t max_settled_rss_delta = 0; // 相对 baseline
+    double min_throughput = 0;
+};
+
+/**
+ * @return 每一项超标的描述，为空表示通过
+ */
+inline std::vector<std::string> CheckReplayBudget(const ReplayResult& r, const ReplayBudget& b) {
+    std::vector<std::string> failures;
+    auto delta = [&](size_t v) { return v > r.baseline_rss ? v - r.baseline_rss : 0; };
+    if (b.max_p99_ns && r.latency_ns.percentile(99) > b.max_p99_ns)
+        failures.push_back("p99 " + std::to_string(r.latency_ns.percentile(99)) + "ns > " + std::to_string(b.max_p99_ns) + "ns");
+    if (b.max_p999_ns && r.latency_ns.percentile(99.9) > b.max_p999_ns)
+        failures.push_back("p99.9 " + std::to_string(r.latency_ns.percentile(99.9)) + "ns > " + std::to_string(b.max_p999_ns) + "ns");
+    if (b.max_peak_rss_delta && delta(r.peak_rss) > b.max_peak_rss_delta)
+        failures.push_back("peak rss delta " + std::to_string(delta(r.peak_rss)) + " > " + std::to_string(b.max_peak_rss_delta));
+    if (b.max_settled_rss_delta && delta(r.settled_rss) > b.max_settled_rss_delta)
+        failures.push_back("settled rss delta " + std::to_string(delta(r.settled_rss)) + " > " + std::to_string(b.max_settled_rss_delta));
+    if (b.min_throughput > 0 && r.throughput < b.min_throughput)
+        failures.push_back("throughput " + std::to_string(r.throughput) + " < " + std::to_string(b.min_throughput));
+    return failures;
+}
+
+namespace replay_detail {
+
+inline int64_t NowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 睡到接近目标再自旋，兼顾 CPU 占用与到达时间精度
+inline void WaitUntilNs(int64_t target_ns) {
+    constexpr int64_t kSpinWindow = 200'000;
+    int64_t now = NowNs();
+    if (target_ns - now > kSpinWindow) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(target_ns - now - kSpinWindow / 2));
+    }
+    while (NowNs() < target_ns) {}
+}
+
+inline void BusyFor(uint64_t ns) {
+    if (ns == 0) return;
+    int64_t end = NowNs() + static_cast<int64_t>(ns);
+    while (NowNs() < end) {}
+}
+
+constexpr uint64_t kStopMarker = UINT64_MAX;
+
+} // namespace replay_detail
+
+/**
+ * @brief 在队列 q 上回放轨迹
+ *
+ * Queue 需提供 push(Item) 与 pop()（阻塞）或 try_pop()（返回 std::optional<Item>）；
+ * 若提供 shrink_count() 则一并统计。元素的 service_ns 由消费者忙等模拟处理耗时。
+ */
+template <typename Item, typename Queue>
+ReplayResult RunReplay(Queue& q, const ReplayTrace& trace, const ReplayOptions& opt = {}) {
+    using namespace replay_detail;
+    ReplayResult result;
+    const size_t n_producers = std::max<size_t>(1, opt.producers);
+    const size_t n_consumers = std::max<size_t>(1, opt.consumers);
+
+    auto probe = [&]() -> size_t { return opt.rss_probe ? opt.rss_probe() : 0; };
+    result.baseline_rss = probe();
+    size_t shrinks_before = 0;
+    if constexpr (requires { q.shrink_count(); }) shrinks_before = q.shrink_count();
+
+    std::atomic<bool> sampling{true};
+    std::atomic<size_t> peak{result.baseline_rss};
+    std::thread sampler;
+    if (opt.rss_probe) {
+        sampler = std::thread([&]{
+            while (sampling.load(std::memory_order_relaxed)) {
+                size_t v = probe();
+                if (v > peak.load(std::memory_order_relaxed)) peak.store(v, std::memory_order_relaxed);
+                std::this_thread::sleep_for(opt.sample_interval);
+            }
+        });
+    }
+
+    auto pop_one = [&]() -> Item {
+        if constexpr (requires { { q.pop() } -> std::convertible_to<Item>; }) {
+            return q.pop();
+        } else {
+            for (;;) {
+                if (auto v = q.try_pop()) return std::move(*v);
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    std::vector<LatencyHistogram> histograms(n_consumers);
+    std::vector<std::thread> consumers;
+    for (size_t c = 0; c < n_consumers; ++c) {
+        consumers.emplace_back([&, c]{
+            for (;;) {
+                Item item = pop_one();
+                if (item.service_ns == kStopMarker) break;
+                int64_t now = NowNs();
+                histograms[c].record(static_cast<uint64_t>(std::max<int64_t>(0, now - item.enqueue_ns)));
+                BusyFor(item.service_ns);
+            }
+        });
+    }
+
+    std::vector<uint64_t> lags(n_producers, 0);
+    const int64_t start = NowNs() + 1'000'000; // 留 1ms 让所有线程就位
+    std::vector<std::thread> producers;
+    for (size_t p = 0; p < n_producers; ++p) {
+        producers.emplace_back([&, p]{
+            for (size_t i = p; i < trace.size(); i += n_producers) {
+                int64_t target = start + static_cast<int64_t>(trace[i].arrival_ns);
+                WaitUntilNs(target);
+                Item item;
+                item.enqueue_ns = NowNs();
+                item.service_ns = trace[i].service_ns;
+                lags[p] = std::max<uint64_t>(lags[p], static_cast<uint64_t>(item.enqueue_ns - target));
+                q.push(std::move(item));
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    for (size_t c = 0; c < n_consumers; ++c) {
+        Item stop;
+        stop.service_ns = kStopMarker;
+        q.push(std::move(stop));
+    }
+    for (auto& t : consumers) t.join();
+    const int64_t end = NowNs();
+
+    std::this_thread::sleep_for(opt.settle_time);
+    // 先停采样线程再读取，rss_probe 不要求线程安全
+    sampling = false;
+    if (sampler.joinable()) sampler.join();
+    result.settled_rss = probe();
+    result.peak_rss = std::max(peak.load(), result.settled_rss);
+
+    for (auto& h : histograms) result.latency_ns.merge(h);
+    for (uint64_t lag : lags) result.max_schedule_lag_ns = std::max(result.max_schedule_lag_ns, lag);
+    result.elements = trace.size();
+    result.elapsed_sec = static_cast<double>(end - start) / 1e9;
+    result.throughput = result.elapsed_sec > 0 ? static_cast<double>(result.elements) / result.elapsed_sec : 0;
+    if constexpr (requires { q.shrink_count(); }) result.shrink_count = q.shrink_count() - shrinks_before;
+    return result;
+}
@@ -0,0 +1,75 @@
+#include "loadReplayTest.h"
+#include "loadReplay.h"
+#include "adapterQueue.h"
+#include "threadSafeQueue.h"
+
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <spdlog/spdlog.h>
+#include "util.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+using Item = ReplayItem<1024>;
+
+ReplayOptions MakeOptions() {
+    ReplayOptions opt;
+    opt.producers = 4;
+    opt.consumers = 1;
+    opt.rss_probe = [] { return GetProcessRssBytes(); };
+    return opt;
+}
+
+void LogResult(const std::string& scenario, const std::string& queue, const ReplayResult& r) {
+    constexpr double kMiB = 1024.0 * 1024.0;
+    SPDLOG_INFO("[Replay] {:<10} {:<24} n={} thr={:.0f}/s p50={}us p99={}us p99.9={}us max={}us "
+                "lag={}us rss(base/peak/settled)={:.1f}/{:.1f}/{:.1f} MiB shrinks={}",
+                scenario, queue, r.elements, r.throughput,
+                r.latency_ns.percentile(50) / 1000, r.latency_ns.percentile(99) / 1000,
+                r.latency_ns.percentile(99.9) / 1000, r.latency_ns.max() / 1000,
+                r.max_schedule_lag_ns / 1000,
+                r.baseline_rss / kMiB, r.peak_rss / kMiB, r.settled_rss / kMiB, r.shrink_count);
+}
+
+// 同一条轨迹依次回放到不同队列/不同 shrink 参数上
+void ReplayAgainstAllQueues(const std::string& scenario, const ReplayTrace& trace) {
+    struct ShrinkParam { size_t interval; float factor; };
+    const std::vector<ShrinkParam> params = {{150, 0.25f}, {500, 0.2f}, {1000, 0.2f}};
+    for (const auto& p : params) {
+        AutoShrinkBlockingQueue<Item> q(p.interval, p.factor);
+        auto r = RunReplay<Item>(q, trace, MakeOptions());
+        LogResult(scenario, fmt::format("ASBQ({},{:.2f})", p.interval, p.factor), r);
+    }
+    {
+        ThreadSafeQueue<Item> q;
+        auto r = RunReplay<Item>(q, trace, MakeOptions());
+        LogResult(scenario, "ThreadSafeQueue", r);
+    }
+}
+
+} // namespace
+
+void TestLoadReplay()
+{
+    // 指定 REPLAY_TRACE 环境变量时回放真实流量轨迹（格式见 LoadReplayTrace）
+    if (const char* path = std::getenv("REPLAY_TRACE")) {
+        auto trace = LoadReplayTrace(path);
+        if (!trace) {
+            SPDLOG_ERROR("[Replay] failed to load trace file: {}", path);
+            return;
+        }
+        ReplayAgainstAllQueues("file", *trace);
+        return;
+    }
+
+    constexpr uint64_t kSeed = 20240601;
+    // 平均 50k/s，消费者平均服务 15us（约 75% 利用率）
+    ReplayAgainstAllQueues("poisson", GeneratePoissonTrace(50'000, 2s, 15us, kSeed));
+    // 每 500ms 有 100ms 的 200k/s 突发，消费者跟不上，队列先堆积后回落
+    ReplayAgainstAllQueues("bursty", GenerateBurstyTrace(20'000, 200'000, 500ms, 100ms, 2s, 15us, kSeed));
+    // 一个"昼夜"压缩为 1s，峰值时段接近饱和
+    ReplayAgainstAllQueues("diurnal", GenerateDiurnalTrace(40'000, 0.9, 1s, 2s, 15us, kSeed));
+}
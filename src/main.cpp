@@ -7,12 +7,14 @@
 #include <thread>
 #include <deque>
 #include <queue>
+#include <vector>
+#include <list>
+#include <map>
+#include <unordered_map>
 #include <iostream>
 #include <string>
 
 
-#include <windows.h>
-#include <shlwapi.h>
 #include <filesystem>
 #include <spdlog/spdlog.h>
 #include <spdlog/async.h>
@@ -23,6 +25,10 @@
 #include "util.h"
 #include "boost-lock-free-queue.h"
 #include "adapterQueueTest.h"
+#include "loadReplayTest.h"
+#include "containerRetentionTest.h"
+#include "slabAllocatorTest.h"
+#include "eventLogTest.h"
 
 struct Data {
     char buf[1024]; // 1KB
@@ -314,6 +320,14 @@ int main(){
 
     TestAdapterQueue();
 
+    //TestLoadReplay();
+
+    //TestContainerRetention();
+
+    //TestSlabAllocator();
+
+    //TestEventLog();
+
     //while loop
     // std::string line;
     // while (std::getline(std::cin, line)) {
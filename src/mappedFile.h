@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @brief 内存映射文件（RAII，只可移动）
+ *
+ * create() 以读写方式新建/截断文件并映射指定大小，写满后用 resize() 扩大（会重新映射，旧指针失效）；
+ * open_read() 以只读方式映射已有文件。close() 时可把文件截到实际写入的长度。
+ * 写入只落到页缓存，由内核回写；需要落盘保证时调用 flush(true)。
+ * 失败统一返回 false，不抛异常；非线程安全。
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept { take(other); }
+    MappedFile& operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            close();
+            take(other);
+        }
+        return *this;
+    }
+
+    /**
+     * @brief 新建（已存在则截断）并以读写方式映射
+     * @param size 初始映射大小（字节），必须大于 0
+     * @param preallocate 为 true 时预先分配磁盘块（Linux posix_fallocate），磁盘空间不足时在这里失败，
+     *                    而不是之后写映射时收到 SIGBUS；Windows 的 SetEndOfFile 本身就会分配
+     */
+    bool create(const std::string& path, size_t size, bool preallocate = false) {
+        close();
+        if (size == 0) return false;
+#if defined(_WIN32)
+        file_ = ::CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return false;
+#else
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) return false;
+#endif
+        writable_ = true;
+#if !defined(_WIN32)
+        if (preallocate && ::posix_fallocate(fd_, 0, static_cast<off_t>(size)) != 0) {
+            close();
+            return false;
+        }
+#else
+        (void)preallocate;
+#endif
+        if (!set_file_size(size) || !map(size)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 以只读方式映射已有文件；空文件也算打开成功，此时 data() 为 nullptr
+     */
+    bool open_read(const std::string& path) {
+        close();
+#if defined(_WIN32)
+        file_ = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER len;
+        if (!::GetFileSizeEx(file_, &len)) {
+            close();
+            return false;
+        }
+        size_t size = static_cast<size_t>(len.QuadPart);
+#else
+        fd_ = ::open(path.c_str(), O_RDONLY);
+        if (fd_ < 0) return false;
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) {
+            close();
+            return false;
+        }
+        size_t size = static_cast<size_t>(st.st_size);
+#endif
+        writable_ = false;
+        if (size > 0 && !map(size)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief 调整文件和映射大小（仅读写模式）；成功后 data() 可能变化
+     * @note 失败时（磁盘满、配额、文件大小上限）恢复原来的文件长度与映射，data()/size() 仍指向原内容
+     */
+    bool resize(size_t new_size) {
+        if (!writable_ || new_size == 0) return false;
+        const size_t old_size = size_;
+        unmap();
+        if (set_file_size(new_size) && map(new_size)) return true;
+        if (old_size != 0 && set_file_size(old_size)) map(old_size);
+        return false;
+    }
+
+    /**
+     * @brief 把映射内容交给内核回写
+     * @param wait true 时等到写入存储设备才返回
+     */
+    void flush(bool wait = false) {
+        if (!data_ || !writable_) return;
+#if defined(_WIN32)
+        ::FlushViewOfFile(data_, 0);
+        if (wait) ::FlushFileBuffers(file_);
+#else
+        ::msync(data_, size_, wait ? MS_SYNC : MS_ASYNC);
+#endif
+    }
+
+    /**
+     * @brief 把 [offset, offset+len) 内的整页移出本进程的常驻集，内容保留在页缓存/文件中，再次访问时缺页读回
+     * @note 用于顺序写/顺序读大文件时压住 RSS；区间按页向内取整，不足一页的部分不处理
+     */
+    void release_pages(size_t offset, size_t len) {
+        if (!data_ || offset >= size_) return;
+        const size_t page = page_size();
+        size_t begin = (offset + page - 1) / page * page;
+        size_t end = std::min(offset + len, size_) / page * page;
+        if (begin >= end) return;
+        char* p = static_cast<char*>(data_) + begin;
+#if defined(_WIN32)
+        ::VirtualUnlock(p, end - begin); // 对未锁定的页调用会把它们移出工作集
+#else
+        ::madvise(p, end - begin, MADV_DONTNEED); // MAP_SHARED 映射下脏页仍在页缓存里，不会丢
+#endif
+    }
+
+    /**
+     * @brief 解除映射并关闭文件
+     * @param final_size 读写模式下把文件截到该长度（默认保持映射大小）
+     */
+    void close(size_t final_size = npos) {
+        unmap();
+        if (writable_ && final_size != npos && is_open()) set_file_size(final_size);
+#if defined(_WIN32)
+        if (file_ != INVALID_HANDLE_VALUE) ::CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+#else
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+#endif
+        writable_ = false;
+    }
+
+    bool is_open() const {
+#if defined(_WIN32)
+        return file_ != INVALID_HANDLE_VALUE;
+#else
+        return fd_ >= 0;
+#endif
+    }
+
+    char* data() { return static_cast<char*>(data_); }
+    const char* data() const { return static_cast<const char*>(data_); }
+    size_t size() const { return size_; }
+    bool writable() const { return writable_; }
+
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    static size_t page_size() {
+#if defined(_WIN32)
+        SYSTEM_INFO si;
+        ::GetSystemInfo(&si);
+        return si.dwPageSize;
+#else
+        return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+#endif
+    }
+
+    bool set_file_size(size_t size) {
+#if defined(_WIN32)
+        LARGE_INTEGER pos;
+        pos.QuadPart = static_cast<LONGLONG>(size);
+        return ::SetFilePointerEx(file_, pos, nullptr, FILE_BEGIN) && ::SetEndOfFile(file_);
+#else
+        return ::ftruncate(fd_, static_cast<off_t>(size)) == 0;
+#endif
+    }
+
+    bool map(size_t size) {
+#if defined(_WIN32)
+        LARGE_INTEGER len;
+        len.QuadPart = static_cast<LONGLONG>(size);
+        mapping_ = ::CreateFileMappingA(file_, nullptr, writable_ ? PAGE_READWRITE : PAGE_READONLY,
+                                        len.HighPart, len.LowPart, nullptr);
+        if (!mapping_) return false;
+        data_ = ::MapViewOfFile(mapping_, writable_ ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+        if (!data_) {
+            ::CloseHandle(mapping_);
+            mapping_ = nullptr;
+            return false;
+        }
+#else
+        void* p = ::mmap(nullptr, size, writable_ ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) return false;
+        data_ = p;
+#endif
+        size_ = size;
+        return true;
+    }
+
+    void unmap() {
+        if (!data_) return;
+#if defined(_WIN32)
+        ::UnmapViewOfFile(data_);
+        ::CloseHandle(mapping_);
+        mapping_ = nullptr;
+#else
+        ::munmap(data_, size_);
+#endif
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    void take(MappedFile& other) {
+#if defined(_WIN32)
+        file_ = std::exchange(other.file_, INVALID_HANDLE_VALUE);
+        mapping_ = std::exchange(other.mapping_, nullptr);
+#else
+        fd_ = std::exchange(other.fd_, -1);
+#endif
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        writable_ = std::exchange(other.writable_, false);
+    }
+
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    bool writable_ = false;
+};
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+// 内存统计结构体
+// 各平台后端：memoryStats_windows.cpp（GetProcessMemoryInfo）、memoryStats_linux.cpp（/proc/self）
+struct MemoryStats {
+    double rss_mib = 0.0;    // Resident Set Size (工作集)
+    double commit_mib = 0.0; // Committed Memory (提交内存)
+    size_t page_faults = 0;  // 页面错误计数
+    size_t peak_working_set = 0; // 峰值工作集大小
+};
+
+// 获取内存统计信息
+MemoryStats GetMemoryStats();
+
+// 当前进程 RSS（字节），供负载回放、benchmark 等需要高频数值采样的场景使用
+size_t GetProcessRssBytes();
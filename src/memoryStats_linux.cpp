@@ -0,0 +1,76 @@
+#if defined(__linux__)
+
+#include "memoryStats.h"
+#include <sys/resource.h>
+#include <unistd.h>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <spdlog/spdlog.h>
+
+namespace {
+
+// 从 /proc/self/status 读取形如 "VmRSS:     1234 kB" 的字段，返回 KiB；不存在时返回 0
+struct ProcStatus {
+    size_t vm_rss_kib = 0;   // 常驻内存，对应 Windows 工作集
+    size_t vm_hwm_kib = 0;   // 常驻内存峰值，对应 PeakWorkingSetSize
+    size_t rss_anon_kib = 0; // 匿名常驻页（堆/栈），不含共享库和文件映射
+    size_t vm_swap_kib = 0;  // 被换出的匿名页
+};
+
+bool ReadProcStatus(ProcStatus& out) {
+    FILE* f = std::fopen("/proc/self/status", "r");
+    if (!f) return false;
+    char line[256];
+    while (std::fgets(line, sizeof(line), f)) {
+        size_t value = 0;
+        if (std::sscanf(line, "VmRSS: %zu kB", &value) == 1) out.vm_rss_kib = value;
+        else if (std::sscanf(line, "VmHWM: %zu kB", &value) == 1) out.vm_hwm_kib = value;
+        else if (std::sscanf(line, "RssAnon: %zu kB", &value) == 1) out.rss_anon_kib = value;
+        else if (std::sscanf(line, "VmSwap: %zu kB", &value) == 1) out.vm_swap_kib = value;
+    }
+    std::fclose(f);
+    return true;
+}
+
+} // namespace
+
+// 获取内存统计信息
+MemoryStats GetMemoryStats() {
+    MemoryStats stats;
+
+    ProcStatus status;
+    if (ReadProcStatus(status)) {
+        // 进程当前驻留物理内存（包括共享库等），对应 Windows 工作集 / top 的 RES
+        stats.rss_mib = static_cast<double>(status.vm_rss_kib) / 1024;
+
+        // Linux 没有 Windows 意义上的"提交大小"；进程私有且已实际分配的内存 = 匿名常驻页 + 被换出的匿名页，
+        // 与 PrivateUsage 最接近（不含 mmap 预留但未触碰的虚拟地址）
+        stats.commit_mib = static_cast<double>(status.rss_anon_kib + status.vm_swap_kib) / 1024;
+
+        // 峰值常驻内存
+        stats.peak_working_set = status.vm_hwm_kib / 1024; // MiB
+    } else {
+        SPDLOG_ERROR("read /proc/self/status failed. errno: {}", errno);
+    }
+
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        stats.page_faults = static_cast<size_t>(usage.ru_minflt + usage.ru_majflt);
+    }
+
+    return stats;
+}
+
+size_t GetProcessRssBytes() {
+    // statm 第二列为常驻页数，比解析 status 便宜，适合高频采样
+    FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    size_t total_pages = 0, resident_pages = 0;
+    int n = std::fscanf(f, "%zu %zu", &total_pages, &resident_pages);
+    std::fclose(f);
+    if (n != 2) return 0;
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+#endif // __linux__
@@ -0,0 +1,52 @@
+#if defined(_WIN32)
+
+#include "memoryStats.h"
+#include <windows.h>
+#include <psapi.h>
+#include <spdlog/spdlog.h>
+
+// 获取内存统计信息
+MemoryStats GetMemoryStats() {
+    MemoryStats stats;
+    
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), 
+                           reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), 
+                           sizeof(pmc))) {
+        // 基础内存信息
+        // 进程当前使用的物理内存（包括共享 DLL 等）
+            // 对应：
+            // mimalloc: rss
+            // 任务管理器: 工作集（Working Set）
+        stats.rss_mib = static_cast<double>(pmc.WorkingSetSize) / (1024 * 1024);
+
+        //  进程私有的虚拟内存（实际已经提交的部分）
+            // 对应：
+            // mimalloc: commit
+            // 任务管理器: 提交大小（Commit Size）
+  
+        // 注意：不是专用工作集，也不是保留虚拟内存，而是实际 已提交使用的虚拟内存。
+        stats.commit_mib = static_cast<double>(pmc.PrivateUsage) / (1024 * 1024);
+        
+        // 附加内存指标
+        stats.page_faults = pmc.PageFaultCount;
+
+        // 峰值工作集大小, 进程生命周期中曾经达到的最大工作集大小
+        stats.peak_working_set = pmc.PeakWorkingSetSize / (1024 * 1024); // MiB
+    } else {
+        DWORD error = GetLastError();
+        SPDLOG_ERROR("GetProcessMemoryInfo failed. Error code: {}", error);
+    }
+    
+    return stats;
+}
+
+size_t GetProcessRssBytes() {
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) {
+        return pmc.WorkingSetSize;
+    }
+    return 0;
+}
+
+#endif // _WIN32
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <stdexcept>
+
+/**
+ * @brief 队列 close() 之后的入队、以及在已关闭且为空的队列上阻塞出队时抛出
+ *
+ * 非阻塞接口（try_pop / drain_into / drain）不抛此异常，关闭后照常取走剩余元素，取空时返回空 / 0。
+ */
+class QueueClosedError : public std::runtime_error {
+public:
+    QueueClosedError() : std::runtime_error("queue closed") {}
+};
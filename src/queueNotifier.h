@@ -0,0 +1,17 @@
+#pragma once
+
+/**
+ * @brief 队列入队事件的外部通知接口
+ *
+ * 队列在元素入队并释放队列锁之后回调 notify，实现方不得在回调中再访问同一队列的加锁接口以外的内部状态。
+ * 回调运行在生产者线程上，必须足够轻量且不抛异常。
+ */
+class QueueNotifier {
+public:
+    virtual ~QueueNotifier() = default;
+
+    /**
+     * @param was_empty 本次入队是否为 空→非空 的转变，可用于合并唤醒
+     */
+    virtual void notify(bool was_empty) noexcept = 0;
+};
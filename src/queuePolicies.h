@@ -0,0 +1,302 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "containerRetention.h"
+
+/**
+ * @brief BasicQueue 的编译期策略（存储 / 锁 / 等待 / 收缩 / 统计 / 异步等待），组合方式见 basicQueue.h
+ *
+ * 各策略都是普通类型，BasicQueue 直接持有并内联调用，不经过虚函数；空策略用 [[no_unique_address]] 不占空间，
+ * NoShrink / NoStats 的调用在编译期即被消去。收缩策略直接复用 shrinkPolicy.h 的 ShrinkPolicy 接口。
+ */
+
+// =================== 存储策略 ===================
+// 提供 template <typename T> class container，接口：
+//   emplace_back(args...)      队尾构造
+//   T take_front()             取出队首（调用方保证非空）
+//   empty() / size()
+//   rebuild(std::optional<container>& retired)  把元素搬进紧凑的新存储，旧存储交给 retired，由调用方在锁外析构
+//   allocated_bytes(high_mark) 底层已分配字节的估算
+//   可选 resident_size()       常驻内存的元素数（部分元素放在别处时，如磁盘溢出），收缩策略按它计算；默认即 size()
+
+/**
+ * @brief std::deque 存储：按块增长，收缩时整体重建（与 AutoShrinkBlockingQueue 相同）
+ */
+struct DequeStorage {
+    template <typename T>
+    class container {
+    public:
+        template <typename... Args>
+        void emplace_back(Args&&... args) { d_.emplace_back(std::forward<Args>(args)...); }
+        T take_front() {
+            T v = std::move(d_.front());
+            d_.pop_front();
+            return v;
+        }
+        bool empty() const { return d_.empty(); }
+        size_t size() const { return d_.size(); }
+        void rebuild(std::optional<container>& retired) {
+            retired.emplace();
+            retired->d_ = std::deque<T>(std::make_move_iterator(d_.begin()), std::make_move_iterator(d_.end()));
+            d_.swap(retired->d_);
+        }
+        size_t allocated_bytes(size_t high_mark) const { return EstimateFootprint(d_, high_mark).allocated_bytes; }
+
+    private:
+        std::deque<T> d_;
+    };
+};
+
+/**
+ * @brief 2 的幂容量的环形数组存储：元素连续存放，满时翻倍；收缩时按当前元素数重新分配
+ * @note 稳态下入队/出队不分配内存，适合元素个数波动不大、对分配次数敏感的场景
+ */
+struct RingStorage {
+    template <typename T>
+    class container {
+    public:
+        container() = default;
+        container(container&& o) noexcept
+            : buf_(std::exchange(o.buf_, nullptr)), cap_(std::exchange(o.cap_, 0)),
+              head_(std::exchange(o.head_, 0)), size_(std::exchange(o.size_, 0)) {}
+        container& operator=(container&& o) noexcept {
+            if (this != &o) {
+                clear();
+                buf_ = std::exchange(o.buf_, nullptr);
+                cap_ = std::exchange(o.cap_, 0);
+                head_ = std::exchange(o.head_, 0);
+                size_ = std::exchange(o.size_, 0);
+            }
+            return *this;
+        }
+        ~container() { clear(); }
+
+        template <typename... Args>
+        void emplace_back(Args&&... args) {
+            if (size_ == cap_) reallocate(cap_ == 0 ? kMinCapacity : cap_ * 2);
+            std::construct_at(buf_ + ((head_ + size_) & (cap_ - 1)), std::forward<Args>(args)...);
+            ++size_;
+        }
+        T take_front() {
+            T* p = buf_ + head_;
+            T v = std::move(*p);
+            std::destroy_at(p);
+            head_ = (head_ + 1) & (cap_ - 1);
+            --size_;
+            return v;
+        }
+        bool empty() const { return size_ == 0; }
+        size_t size() const { return size_; }
+        void rebuild(std::optional<container>& retired) {
+            container fresh;
+            if (size_ != 0) fresh.reallocate_from(*this, std::bit_ceil(std::max(size_, kMinCapacity)));
+            retired.emplace(std::move(*this));
+            *this = std::move(fresh);
+        }
+        size_t allocated_bytes(size_t) const { return cap_ * sizeof(T); }
+
+    private:
+        static constexpr size_t kMinCapacity = 16;
+
+        void reallocate(size_t cap) {
+            container fresh;
+            fresh.reallocate_from(*this, cap);
+            *this = std::move(fresh);
+        }
+
+        // 分配 cap 个槽位，把 src 的元素按顺序搬过来（src 随之清空）
+        void reallocate_from(container& src, size_t cap) {
+            buf_ = std::allocator<T>().allocate(cap);
+            cap_ = cap;
+            head_ = 0;
+            while (!src.empty()) {
+                std::construct_at(buf_ + size_, src.take_front());
+                ++size_;
+            }
+        }
+
+        void clear() {
+            while (size_ != 0) (void)take_front();
+            if (buf_) std::allocator<T>().deallocate(buf_, cap_);
+            buf_ = nullptr;
+            cap_ = head_ = 0;
+        }
+
+        T* buf_ = nullptr;
+        size_t cap_ = 0;
+        size_t head_ = 0;
+        size_t size_ = 0;
+    };
+};
+
+// =================== 锁策略 ===================
+// 提供 mutex_type（满足 Lockable）
+
+/**
+ * @brief std::mutex，竞争时在内核里睡眠
+ */
+struct MutexLock {
+    using mutex_type = std::mutex;
+};
+
+/**
+ * @brief TTAS 自旋锁：临界区极短、线程数不超过核数时省掉 futex 往返；自旋若干次后让出 CPU，单核上也不会空转一整个时间片
+ */
+class SpinMutex {
+public:
+    void lock() noexcept {
+        for (;;) {
+            if (!locked_.exchange(true, std::memory_order_acquire)) return;
+            for (int spins = 0; locked_.load(std::memory_order_relaxed); ++spins) {
+                if (spins >= kSpinsBeforeYield) {
+                    std::this_thread::yield();
+                    spins = 0;
+                }
+            }
+        }
+    }
+    bool try_lock() noexcept {
+        return !locked_.load(std::memory_order_relaxed) && !locked_.exchange(true, std::memory_order_acquire);
+    }
+    void unlock() noexcept { locked_.store(false, std::memory_order_release); }
+
+private:
+    static constexpr int kSpinsBeforeYield = 64;
+    std::atomic<bool> locked_{false};
+};
+
+struct SpinLock {
+    using mutex_type = SpinMutex;
+};
+
+// =================== 等待策略 ===================
+// 提供 template <typename Mutex> class waiter，接口：
+//   wait(std::unique_lock<Mutex>&, pred)   阻塞直到 pred() 为真（调用时持锁，返回时持锁）
+//   notify_one() / notify_all()           在锁外调用
+
+/**
+ * @brief 条件变量：std::mutex 配 std::condition_variable，其它锁配 std::condition_variable_any
+ */
+struct CondVarWait {
+    template <typename Mutex>
+    class waiter {
+        using cv_type = std::conditional_t<std::is_same_v<Mutex, std::mutex>, std::condition_variable,
+                                           std::condition_variable_any>;
+
+    public:
+        template <typename Pred>
+        void wait(std::unique_lock<Mutex>& lock, Pred pred) { cv_.wait(lock, pred); }
+        void notify_one() noexcept { cv_.notify_one(); }
+        void notify_all() noexcept { cv_.notify_all(); }
+
+    private:
+        cv_type cv_;
+    };
+};
+
+/**
+ * @brief 放锁 + yield 轮询：通知是空操作，生产者不付任何唤醒开销；消费者等待期间持续占用 CPU
+ * @note 适合消费者独占核心的低延迟场景，通常与 SpinLock 搭配
+ */
+struct YieldWait {
+    template <typename Mutex>
+    class waiter {
+    public:
+        template <typename Pred>
+        void wait(std::unique_lock<Mutex>& lock, Pred pred) {
+            while (!pred()) {
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+        }
+        void notify_one() noexcept {}
+        void notify_all() noexcept {}
+    };
+};
+
+// =================== 收缩策略 ===================
+// 接口与 ShrinkPolicy 相同：on_grow / on_remove / on_shrunk / high_mark / shrink_count
+
+/**
+ * @brief 不收缩：全部为空操作，on_remove 恒为 false，收缩分支在编译期被消去
+ */
+struct NoShrink {
+    constexpr void on_grow(size_t) noexcept {}
+    constexpr bool on_remove(size_t, size_t = 1) noexcept { return false; }
+    constexpr void on_shrunk(size_t) noexcept {}
+    constexpr size_t high_mark() const noexcept { return 0; }
+    constexpr size_t shrink_count() const noexcept { return 0; }
+};
+
+// =================== 统计策略 ===================
+// 提供 kLockFree 与 publish(size, high_mark, shrink_count)（锁内调用）；
+// kLockFree 为 true 时还需提供 size() / high_mark() / shrink_count()，BasicQueue 的同名接口直接读取，不加锁
+
+/**
+ * @brief 锁内把计数发布到原子快照，size/last_high_mark/shrink_count 无锁读取（监控线程高频轮询不争锁）
+ */
+struct SnapshotStats {
+    static constexpr bool kLockFree = true;
+    void publish(size_t size, size_t high_mark, size_t shrinks) noexcept {
+        size_.store(size, std::memory_order_relaxed);
+        high_mark_.store(high_mark, std::memory_order_relaxed);
+        shrink_count_.store(shrinks, std::memory_order_relaxed);
+    }
+    size_t size() const noexcept { return size_.load(std::memory_order_relaxed); }
+    size_t high_mark() const noexcept { return high_mark_.load(std::memory_order_relaxed); }
+    size_t shrink_count() const noexcept { return shrink_count_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<size_t> size_{0};
+    std::atomic<size_t> high_mark_{0};
+    std::atomic<size_t> shrink_count_{0};
+};
+
+/**
+ * @brief 不维护快照：入队/出队少三次原子写，size 等查询改为加锁读取
+ */
+struct NoStats {
+    static constexpr bool kLockFree = false;
+    constexpr void publish(size_t, size_t, size_t) noexcept {}
+};
+
+// =================== 异步等待策略 ===================
+// 在 Wait 策略阻塞的线程之外挂接另一类等待者（如挂起的协程），提供 template <typename T> class waiters，接口：
+//   pending                          锁内登记、锁外唤醒的一批等待者，resume() 在锁外调用
+//   bool consumer_waiting() const    有等待元素的消费者；此时队列必为空，入队的元素直接交给它而不进存储
+//   void hand_off(T&&, pending&)     把元素交给最早的消费者
+//   bool admit_producer(put, pending&)  有界模式下腾出空位时接纳最早的挂起生产者：以其元素调用 put(T&&) 放进存储
+//   void close(pending&)             摘下全部等待者：消费者落空、生产者被拒绝
+// 以上除 resume() 外都在锁内调用
+
+/**
+ * @brief 没有异步等待者：全部为空操作，相关分支在编译期被消去
+ */
+struct NoAsyncWaiters {
+    template <typename T>
+    class waiters {
+    public:
+        struct pending {
+            constexpr void resume() noexcept {}
+        };
+        constexpr bool consumer_waiting() const noexcept { return false; }
+        constexpr void hand_off(T&&, pending&) noexcept {}
+        template <typename Put>
+        constexpr bool admit_producer(Put&&, pending&) noexcept { return false; }
+        constexpr void close(pending&) noexcept {}
+    };
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <optional>
+#include <chrono>
+#include <cstdint>
+
+#include "adapterQueue.h"
+#include "queueClosedError.h"
+#include "queueNotifier.h"
+
+/**
+ * @brief 多个队列共享的唤醒信号
+ *
+ * 生产者侧只做一次原子自增；仅当有消费者真正睡眠时才加锁 notify，
+ * 替代对每个队列各自的条件变量轮询。
+ */
+class SelectSignal final : public QueueNotifier {
+public:
+    void notify(bool /*was_empty*/) noexcept override {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cond_.notify_all();
+        }
+    }
+
+    /**
+     * @brief 当前信号纪元，扫描前读取，扫描无果后以此为基准等待
+     */
+    uint64_t epoch() const { return epoch_.load(std::memory_order_seq_cst); }
+
+    /**
+     * @brief 阻塞直到纪元不等于 seen
+     */
+    void wait(uint64_t seen) {
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [&]{ return epoch_.load(std::memory_order_seq_cst) != seen; });
+        }
+        sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    /**
+     * @return 纪元在超时前发生变化返回 true
+     */
+    template <typename Clock, typename Duration>
+    bool wait_until(uint64_t seen, const std::chrono::time_point<Clock, Duration>& deadline) {
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        bool changed;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            changed = cond_.wait_until(lock, deadline,
+                [&]{ return epoch_.load(std::memory_order_seq_cst) != seen; });
+        }
+        sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+        return changed;
+    }
+
+private:
+    std::atomic<uint64_t> epoch_{0};
+    std::atomic<int> sleepers_{0};
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+/**
+ * @brief 在多个 AutoShrinkBlockingQueue 上"select"：一次阻塞调用等待任意队列有数据
+ *
+ * 按权重做加权轮询：当前队列连续最多取 weight 个元素后轮到下一个队列，空队列直接跳过，
+ * 既避免高流量队列饿死其它队列，也可以给重要队列更高的份额。
+ * 全部队列都已 close() 且取空后，select / select_for 抛 QueueClosedError，阻塞中的 select 随最后一次 close 醒来。
+ * 注意：add() 必须在开始 select 之前完成；QueueSet 析构时会解除各队列上的通知器挂接，
+ *       因此队列的生命周期必须长于 QueueSet，且析构前各生产者应已停止 push。
+ */
+template <typename T>
+class QueueSet {
+public:
+    using Queue = AutoShrinkBlockingQueue<T>;
+
+    struct Selected {
+        size_t index; // add() 返回的队列序号
+        T value;
+    };
+
+    QueueSet() = default;
+    QueueSet(const QueueSet&) = delete;
+    QueueSet& operator=(const QueueSet&) = delete;
+
+    ~QueueSet() {
+        for (auto& e : entries_) e.queue->set_notifier(nullptr);
+    }
+
+    /**
+     * @brief 注册队列
+     * @param weight 每轮最多连续取走的元素个数，最小为 1
+     * @return 队列序号，select 结果中以此标识来源
+     */
+    size_t add(Queue& q, unsigned weight = 1) {
+        std::lock_guard<std::mutex> lock(sched_mutex_);
+        entries_.push_back(Entry{&q, weight == 0 ? 1u : weight});
+        if (entries_.size() == 1) credit_ = entries_[0].weight;
+        q.set_notifier(&signal_);
+        return entries_.size() - 1;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(sched_mutex_);
+        return entries_.size();
+    }
+
+    /**
+     * @brief 非阻塞：按加权轮询顺序尝试从任一队列取一个元素
+     */
+    std::optional<Selected> try_select() {
+        return scan();
+    }
+
+    /**
+     * @brief 阻塞直到任一队列有数据
+     * @throw QueueClosedError 全部队列都已关闭且已取空
+     */
+    Selected select() {
+        for (;;) {
+            uint64_t seen = signal_.epoch();
+            if (auto r = scan()) return std::move(*r);
+            if (all_closed_and_empty()) throw QueueClosedError();
+            signal_.wait(seen);
+        }
+    }
+
+    /**
+     * @brief 带超时的 select，超时返回空
+     * @throw QueueClosedError 全部队列都已关闭且已取空
+     */
+    template <typename Rep, typename Period>
+    std::optional<Selected> select_for(const std::chrono::duration<Rep, Period>& timeout) {
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;) {
+            uint64_t seen = signal_.epoch();
+            if (auto r = scan()) return r;
+            if (all_closed_and_empty()) throw QueueClosedError();
+            if (!signal_.wait_until(seen, deadline)) return scan();
+        }
+    }
+
+private:
+    struct Entry {
+        Queue* queue;
+        unsigned weight;
+    };
+
+    std::optional<Selected> scan() {
+        std::lock_guard<std::mutex> lock(sched_mutex_);
+        const size_t n = entries_.size();
+        for (size_t k = 0; k < n; ++k) {
+            size_t i = cursor_;
+            if (auto v = entries_[i].queue->try_pop()) {
+                if (--credit_ == 0) advance();
+                return Selected{i, std::move(*v)};
+            }
+            advance();
+        }
+        return std::nullopt;
+    }
+
+    // 关闭的队列不会再有新元素，先看 closed 再看 empty，一旦成立便不会再变；
+    // close() 会触发共享信号，扫描前读到的纪元保证最后一次 close 不会被错过
+    bool all_closed_and_empty() const {
+        std::lock_guard<std::mutex> lock(sched_mutex_);
+        if (entries_.empty()) return false;
+        for (const Entry& e : entries_) {
+            if (!e.queue->closed() || !e.queue->empty()) return false;
+        }
+        return true;
+    }
+
+    void advance() {
+        cursor_ = (cursor_ + 1) % entries_.size();
+        credit_ = entries_[cursor_].weight;
+    }
+
+    std::vector<Entry> entries_;
+    mutable std::mutex sched_mutex_;
+    size_t cursor_ = 0;
+    unsigned credit_ = 0;
+    SelectSignal signal_;
+};
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "mappedFile.h"
+#include "spillStore.h"
+
+/**
+ * @brief 队列快照文件格式与读写工具（AutoShrinkBlockingQueue::snapshot_to / restore_from 使用）
+ *
+ * 文件 = 32 字节头 + 按队列顺序排列的记录；每条记录为 [u32 长度][SpillCodec 编码内容]，与磁盘溢出段的记录格式相同，
+ * 溢出区里的记录可以原样拷贝进快照。
+ * 写：先写 <path>.tmp，攒满 4MB 缓冲再整块 fwrite，最后回填头部并 rename，崩溃时不会留下半个快照。
+ * 读：整个文件 mmap 只读映射，顺序解码。
+ */
+namespace queue_snapshot_detail {
+
+struct FileHeader {
+    char magic[8];          // "QSNAP001"
+    uint32_t version;
+    uint32_t header_size;   // sizeof(FileHeader)
+    uint64_t record_count;
+    uint64_t payload_bytes; // 头部之后的字节数
+};
+static_assert(sizeof(FileHeader) == 32, "snapshot header must stay 32 bytes");
+
+inline constexpr char kMagic[8] = {'Q', 'S', 'N', 'A', 'P', '0', '0', '1'};
+inline constexpr uint32_t kVersion = 1;
+
+/**
+ * @brief 带大块缓冲的顺序写入器，失败后后续调用全部无效，由 commit() 统一报告
+ */
+class SnapshotWriter {
+public:
+    static constexpr size_t kBufferBytes = 4u << 20;
+
+    explicit SnapshotWriter(std::string path) : path_(std::move(path)), tmp_path_(path_ + ".tmp") {
+        file_ = std::fopen(tmp_path_.c_str(), "wb");
+        ok_ = file_ != nullptr;
+        if (ok_) {
+            std::setvbuf(file_, nullptr, _IONBF, 0); // 自己攒块，绕开 stdio 的小缓冲
+            buffer_.reset(new char[kBufferBytes]);
+            FileHeader placeholder{};
+            write_bytes(&placeholder, sizeof(placeholder));
+        }
+    }
+
+    ~SnapshotWriter() {
+        if (file_) {
+            std::fclose(file_);
+            std::error_code ec;
+            std::filesystem::remove(tmp_path_, ec);
+        }
+    }
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    template <typename T>
+    void append(const T& value) {
+        if (!ok_) return; // 打开失败时没有缓冲，写失败后也不必再编码
+        const size_t len = SpillCodec<T>::size(value);
+        if (len > UINT32_MAX) {
+            ok_ = false;
+            return;
+        }
+        const uint32_t len32 = static_cast<uint32_t>(len);
+        write_bytes(&len32, sizeof(len32));
+        if (len > kBufferBytes - used_) flush_buffer();
+        if (len <= kBufferBytes) {
+            SpillCodec<T>::encode(value, buffer_.get() + used_);
+            used_ += len;
+            written_ += len;
+        } else {
+            std::vector<char> tmp(len); // 超大元素单独编码
+            SpillCodec<T>::encode(value, tmp.data());
+            write_bytes(tmp.data(), len);
+        }
+        ++records_;
+    }
+
+    /**
+     * @brief 追加已经是记录格式的连续字节（如溢出段里的一段），含 records 条记录
+     */
+    void append_raw(const char* data, size_t bytes, size_t records) {
+        write_bytes(data, bytes);
+        records_ += records;
+    }
+
+    /**
+     * @brief 刷出缓冲、回填头部、rename 到目标路径
+     */
+    bool commit() {
+        if (!file_) return false;
+        flush_buffer();
+        FileHeader h{};
+        std::memcpy(h.magic, kMagic, sizeof(kMagic));
+        h.version = kVersion;
+        h.header_size = sizeof(FileHeader);
+        h.record_count = records_;
+        h.payload_bytes = written_ - sizeof(FileHeader);
+        ok_ = ok_ && std::fseek(file_, 0, SEEK_SET) == 0 && std::fwrite(&h, sizeof(h), 1, file_) == 1;
+        ok_ = std::fclose(file_) == 0 && ok_;
+        file_ = nullptr;
+        std::error_code ec;
+        if (ok_) std::filesystem::rename(tmp_path_, path_, ec);
+        if (!ok_ || ec) {
+            std::filesystem::remove(tmp_path_, ec);
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t records() const { return records_; }
+
+    /**
+     * @brief 目前为止是否都写成功；临时文件打不开时构造后即为 false，调用方可以直接放弃
+     */
+    bool ok() const { return ok_; }
+
+private:
+    void write_bytes(const void* data, size_t bytes) {
+        if (!ok_) return;
+        const char* p = static_cast<const char*>(data);
+        written_ += bytes;
+        while (bytes != 0) {
+            if (used_ == kBufferBytes) flush_buffer();
+            size_t n = std::min(bytes, kBufferBytes - used_);
+            if (used_ == 0 && bytes >= kBufferBytes) { // 大块直接写，不过缓冲
+                n = bytes - bytes % kBufferBytes;
+                ok_ = ok_ && std::fwrite(p, 1, n, file_) == n;
+            } else {
+                std::memcpy(buffer_.get() + used_, p, n);
+                used_ += n;
+            }
+            p += n;
+            bytes -= n;
+        }
+    }
+
+    void flush_buffer() {
+        if (used_ != 0 && ok_) ok_ = std::fwrite(buffer_.get(), 1, used_, file_) == used_;
+        used_ = 0;
+    }
+
+    std::string path_;
+    std::string tmp_path_;
+    std::FILE* file_ = nullptr;
+    std::unique_ptr<char[]> buffer_;
+    size_t used_ = 0;
+    uint64_t written_ = 0;
+    uint64_t records_ = 0;
+    bool ok_ = false;
+};
+
+/**
+ * @brief mmap 读取快照并按顺序解码到 out 尾部
+ * @return 文件不存在、头部不符、记录越界或记录长度不合 codec 要求时返回 false，此时 out 可能已追加了部分元素
+ */
+template <typename T, typename Out>
+bool ReadSnapshot(const std::string& path, Out& out) {
+    MappedFile file;
+    if (!file.open_read(path) || file.size() < sizeof(FileHeader)) return false;
+    FileHeader h;
+    std::memcpy(&h, file.data(), sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.version != kVersion ||
+        h.header_size != sizeof(FileHeader) || h.payload_bytes != file.size() - sizeof(FileHeader)) {
+        return false;
+    }
+    const char* p = file.data() + sizeof(FileHeader);
+    const char* end = file.data() + file.size();
+    for (uint64_t i = 0; i < h.record_count; ++i) {
+        uint32_t len;
+        if (static_cast<size_t>(end - p) < sizeof(len)) return false;
+        std::memcpy(&len, p, sizeof(len));
+        p += sizeof(len);
+        if (static_cast<size_t>(end - p) < len || !SpillLengthValid<T>(len)) return false;
+        out.push_back(SpillCodec<T>::decode(p, len));
+        p += len;
+    }
+    return p == end;
+}
+
+} // namespace queue_snapshot_detail
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+/**
+ * @brief 带序号戳的元素：(生产者 id, 生产者内序号) + 可选的全局序号
+ *
+ * 用于验证队列实现是否保持"单生产者内 FIFO"，对任何队列类型都适用（只是换一下元素类型）。
+ */
+template <typename T>
+struct Stamped {
+    uint32_t producer_id = 0;
+    uint64_t seq = 0;        // 生产者内序号，从 0 开始连续递增
+    uint64_t global_seq = 0; // 全局入队序号，未开启全局计数时为 0
+    T value{};
+};
+
+/**
+ * @brief 单个生产者使用的打戳器，非线程安全（每个生产者线程各持一个）
+ *
+ * 全局序号需要所有生产者共享一个原子计数器，会引入一次共享 fetch_add，按需开启。
+ */
+class SequenceStamper {
+public:
+    explicit SequenceStamper(uint32_t producer_id, std::atomic<uint64_t>* global_counter = nullptr)
+        : producer_id_(producer_id), global_counter_(global_counter) {}
+
+    template <typename T>
+    Stamped<std::decay_t<T>> stamp(T&& value) {
+        uint64_t global_seq = global_counter_
+            ? global_counter_->fetch_add(1, std::memory_order_relaxed) : 0;
+        return Stamped<std::decay_t<T>>{producer_id_, next_seq_++, global_seq, std::forward<T>(value)};
+    }
+
+    uint32_t producer_id() const { return producer_id_; }
+    uint64_t stamped() const { return next_seq_; }
+
+private:
+    uint32_t producer_id_;
+    uint64_t next_seq_ = 0;
+    std::atomic<uint64_t>* global_counter_;
+};
+
+/**
+ * @brief 消费者侧的单生产者 FIFO 校验器，非线程安全（每个消费者线程各持一个）
+ *
+ * 每次校验只有一次数组读写和一次比较，可常驻压测代码中。
+ * 多消费者时每个消费者看到的同一生产者序号只需严格递增（中间的元素可能被其它消费者取走）；
+ * 单消费者时可开启 contiguous，要求序号连续，从而同时发现丢失。
+ * 结束后把各消费者的校验器 merge 到一起，再用 complete() 检查无丢失、无重复。
+ */
+class FifoOrderChecker {
+public:
+    explicit FifoOrderChecker(size_t max_producers, bool contiguous = false)
+        : next_(max_producers, 0), received_(max_producers, 0), contiguous_(contiguous) {}
+
+    /**
+     * @return 顺序正确返回 true；乱序/重复（以及 contiguous 模式下的跳号）返回 false 并计数
+     */
+    bool check(uint32_t producer_id, uint64_t seq) noexcept {
+        if (producer_id >= next_.size()) {
+            ++violations_;
+            return false;
+        }
+        uint64_t& expected = next_[producer_id];
+        ++received_[producer_id];
+        bool ok = contiguous_ ? seq == expected : seq >= expected;
+        if (!ok) {
+            if (violations_ == 0) {
+                first_violation_producer_ = producer_id;
+                first_violation_expected_ = expected;
+                first_violation_seq_ = seq;
+            }
+            ++violations_;
+        }
+        if (seq + 1 > expected) expected = seq + 1;
+        return ok;
+    }
+
+    template <typename T>
+    bool check(const Stamped<T>& s) noexcept {
+        return check(s.producer_id, s.seq);
+    }
+
+    /**
+     * @brief 合并另一个消费者的统计（仅合并计数与违规，不合并顺序状态）
+     */
+    void merge(const FifoOrderChecker& other) {
+        if (other.received_.size() > received_.size()) {
+            received_.resize(other.received_.size(), 0);
+            next_.resize(other.next_.size(), 0);
+        }
+        for (size_t i = 0; i < other.received_.size(); ++i) received_[i] += other.received_[i];
+        if (violations_ == 0 && other.violations_ != 0) {
+            first_violation_producer_ = other.first_violation_producer_;
+            first_violation_expected_ = other.first_violation_expected_;
+            first_violation_seq_ = other.first_violation_seq_;
+        }
+        violations_ += other.violations_;
+    }
+
+    /**
+     * @brief 每个生产者都恰好收到 per_producer 个元素且无顺序违规
+     */
+    bool complete(uint64_t per_producer) const {
+        if (violations_ != 0) return false;
+        for (uint64_t r : received_) {
+            if (r != per_producer) return false;
+        }
+        return true;
+    }
+
+    uint64_t violations() const { return violations_; }
+    uint64_t received(uint32_t producer_id) const { return received_[producer_id]; }
+    uint32_t first_violation_producer() const { return first_violation_producer_; }
+    uint64_t first_violation_expected() const { return first_violation_expected_; }
+    uint64_t first_violation_seq() const { return first_violation_seq_; }
+
+private:
+    std::vector<uint64_t> next_;
+    std::vector<uint64_t> received_;
+    bool contiguous_;
+    uint64_t violations_ = 0;
+    uint32_t first_violation_producer_ = 0;
+    uint64_t first_violation_expected_ = 0;
+    uint64_t first_violation_seq_ = 0;
+};
@@ -0,0 +1,414 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "shrinkPolicy.h"
+
+namespace shm_queue_detail {
+
+inline constexpr char kMagic[8] = {'S', 'H', 'M', 'Q', 'U', 'E', '0', '1'};
+inline constexpr uint32_t kVersion = 1;
+// 共享内存布局要在不同进程、不同编译选项之间一致，不跟随 kCacheLineSize，固定按 64 字节分组
+inline constexpr size_t kLineSize = 64;
+// tail 的最高位：消费者收缩期间冻结新的槽位预约
+inline constexpr uint64_t kTailFrozen = uint64_t{1} << 63;
+
+// 跨进程 futex：不能用 FUTEX_PRIVATE_FLAG
+inline int FutexWait(std::atomic<uint32_t>* addr, uint32_t expected, const timespec* timeout) {
+    return static_cast<int>(::syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAIT, expected, timeout,
+                                      nullptr, 0));
+}
+
+inline void FutexWake(std::atomic<uint32_t>* addr, int count) {
+    ::syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), FUTEX_WAKE, count, nullptr, nullptr, 0);
+}
+
+inline size_t PageSize() {
+    return static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+}
+
+inline size_t RoundUp(size_t v, size_t align) {
+    return (v + align - 1) / align * align;
+}
+
+/**
+ * @brief 共享内存头部，所有字段按偏移访问，不含指针；生产者/消费者各自改写的字段分在不同 cache line
+ */
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_size;
+    uint64_t capacity;     // 槽位数，2 的幂
+    uint64_t seq_offset;   // 槽位序号数组相对映射起点的偏移
+    uint64_t data_offset;  // 槽位数据区相对映射起点的偏移（按页对齐，可以整页打洞）
+    uint64_t total_bytes;
+    std::atomic<uint32_t> ready;
+
+    // 生产者侧：预约位置（MPSC 下多个生产者 CAS）
+    alignas(kLineSize) std::atomic<uint64_t> tail;
+    std::atomic<uint32_t> space_version;    // 消费者每腾出空位递增，满时生产者在上面 futex 等待
+    std::atomic<uint32_t> producers_waiting;
+
+    // 消费者侧
+    alignas(kLineSize) std::atomic<uint64_t> head;
+    std::atomic<uint32_t> data_version;     // 生产者每发布一个元素递增，空时消费者在上面 futex 等待
+    std::atomic<uint32_t> consumer_waiting;
+
+    // 信息快照
+    alignas(kLineSize) std::atomic<uint64_t> high_mark;
+    std::atomic<uint64_t> shrink_count;
+    std::atomic<uint64_t> punched_bytes;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free,
+              "ShmQueue needs address-free lock-free atomics");
+
+} // namespace shm_queue_detail
+
+/**
+ * @brief 放在 POSIX 共享内存里的跨进程有界队列（MPSC：任意多个生产者进程/线程，单个消费者），语义与自动收缩队列一致
+ *
+ * 同机上的生产者进程和消费者进程之间零拷贝交接元素，不再绕一趟 socket：
+ *   - 一方 create(name, capacity) 建立 shm_open + mmap 的区域，其它进程 open(name) 映射同一块内存；
+ *   - 环形缓冲按 Vyukov 的槽位序号协议实现，生产者 CAS 预约 tail，单消费者独占 head，全部用偏移寻址；
+ *   - 空/满时在共享内存中的 futex 字上阻塞（非 PRIVATE futex，跨进程有效），只有对端确实在等待时才发 wake 系统调用。
+ * 收缩：槽位数据区按页对齐，与序号数组分开；一次突发把数据区的页全部摸过以后，这些 tmpfs 页会一直占着内存，
+ * 消费者按 ShrinkPolicy（每 shrink_check_interval 次出队检查，低于 high mark 的 shrink_factor）对当前空闲的槽位区间
+ * fallocate(PUNCH_HOLE) 打洞归还；打洞期间通过 tail 的冻结位暂停新的预约，已预约的槽位不在空闲区间里，不受影响。
+ *
+ * T 必须可平凡复制（按字节放进共享内存）。pop/try_pop/shrink_to_fit 只能由唯一的消费者调用。
+ * 生产者进程在预约槽位之后、发布之前崩溃，会让消费者停在该槽位上；需要容错时由上层按 pop_for 超时判定并重建队列。
+ * 不再使用的名字需要 ShmQueue::remove(name) 删除（shm_unlink），已映射的进程不受影响。
+ * 失败统一返回 false，不抛异常；size/empty/last_high_mark 仅为快照。
+ */
+template <typename T>
+class ShmQueue {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>,
+                  "ShmQueue: T must be trivially copyable and default constructible");
+    using Header = shm_queue_detail::Header;
+
+public:
+    ShmQueue() = default;
+    ~ShmQueue() { close(); }
+
+    ShmQueue(const ShmQueue&) = delete;
+    ShmQueue& operator=(const ShmQueue&) = delete;
+
+    /**
+     * @brief 新建共享内存队列（同名已存在则失败）
+     * @param name shm 对象名，形如 "/orders"
+     * @param capacity 槽位数，向上取整到 2 的幂
+     * @param shrink_check_interval 每多少次出队检查一次是否需要收缩
+     * @param shrink_factor 当前队长低于 high mark 的 shrink_factor 时对空闲槽位打洞
+     */
+    bool create(const std::string& name, size_t capacity, size_t shrink_check_interval = 150,
+                float shrink_factor = 0.25f) {
+        close();
+        if (capacity == 0) return false;
+        size_t cap = 1;
+        while (cap < capacity) cap <<= 1;
+        const size_t page = shm_queue_detail::PageSize();
+        const size_t seq_offset = shm_queue_detail::RoundUp(sizeof(Header), shm_queue_detail::kLineSize);
+        const size_t data_offset = shm_queue_detail::RoundUp(seq_offset + cap * sizeof(std::atomic<uint64_t>), page);
+        const size_t total = shm_queue_detail::RoundUp(data_offset + cap * sizeof(T), page);
+
+        fd_ = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+        if (fd_ < 0) return false;
+        if (::ftruncate(fd_, static_cast<off_t>(total)) != 0 || !map(total)) {
+            close();
+            ::shm_unlink(name.c_str());
+            return false;
+        }
+        // ftruncate 出来的内存全 0，原子量的全 0 即初值
+        Header* h = header();
+        std::memcpy(h->magic, shm_queue_detail::kMagic, sizeof(h->magic));
+        h->version = shm_queue_detail::kVersion;
+        h->slot_size = sizeof(T);
+        h->capacity = cap;
+        h->seq_offset = seq_offset;
+        h->data_offset = data_offset;
+        h->total_bytes = total;
+        for (size_t i = 0; i < cap; ++i) seqs()[i].store(i, std::memory_order_relaxed);
+        h->ready.store(1, std::memory_order_release);
+        policy_ = ShrinkPolicy(shrink_check_interval, shrink_factor);
+        return true;
+    }
+
+    /**
+     * @brief 映射已有的共享内存队列；元素大小或格式不符时失败
+     */
+    bool open(const std::string& name, size_t shrink_check_interval = 150, float shrink_factor = 0.25f) {
+        close();
+        fd_ = ::shm_open(name.c_str(), O_RDWR, 0);
+        if (fd_ < 0) return false;
+        struct stat st;
+        if (::fstat(fd_, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header) ||
+            !map(static_cast<size_t>(st.st_size))) {
+            close();
+            return false;
+        }
+        const Header* h = header();
+        if (std::memcmp(h->magic, shm_queue_detail::kMagic, sizeof(h->magic)) != 0 ||
+            h->ready.load(std::memory_order_acquire) != 1 || h->version != shm_queue_detail::kVersion ||
+            h->slot_size != sizeof(T) || h->total_bytes != size_) {
+            close();
+            return false;
+        }
+        policy_ = ShrinkPolicy(shrink_check_interval, shrink_factor);
+        return true;
+    }
+
+    /**
+     * @brief 解除映射（共享内存对象本身保留，见 remove）
+     */
+    void close() {
+        if (base_) ::munmap(base_, size_);
+        base_ = nullptr;
+        size_ = 0;
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+    /**
+     * @brief 删除共享内存对象名（shm_unlink）
+     */
+    static bool remove(const std::string& name) {
+        return ::shm_unlink(name.c_str()) == 0;
+    }
+
+    bool is_open() const { return base_ != nullptr; }
+
+    /**
+     * @brief 非阻塞入队，满时返回 false；任意进程/线程可调用
+     */
+    bool try_push(const T& value) {
+        Header* h = header();
+        const uint64_t mask = h->capacity - 1;
+        uint64_t pos = h->tail.load(std::memory_order_relaxed);
+        for (;;) {
+            if (pos & shm_queue_detail::kTailFrozen) { // 消费者正在打洞，稍后重试
+                std::this_thread::yield();
+                pos = h->tail.load(std::memory_order_relaxed);
+                continue;
+            }
+            const uint64_t seq = seqs()[pos & mask].load(std::memory_order_acquire);
+            const int64_t dif = static_cast<int64_t>(seq) - static_cast<int64_t>(pos);
+            if (dif == 0) {
+                if (h->tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+            } else if (dif < 0) {
+                return false; // 满
+            } else {
+                pos = h->tail.load(std::memory_order_relaxed);
+            }
+        }
+        std::memcpy(static_cast<void*>(data() + (pos & mask)), &value, sizeof(T));
+        seqs()[pos & mask].store(pos + 1, std::memory_order_release);
+        raise_high_mark(pos + 1 - h->head.load(std::memory_order_relaxed));
+        h->data_version.fetch_add(1, std::memory_order_seq_cst);
+        if (h->consumer_waiting.load(std::memory_order_seq_cst) != 0) {
+            shm_queue_detail::FutexWake(&h->data_version, 1);
+        }
+        return true;
+    }
+
+    /**
+     * @brief 入队，满时在 futex 上阻塞直到消费者腾出空位
+     */
+    void push(const T& value) {
+        Header* h = header();
+        while (!try_push(value)) {
+            const uint32_t v = h->space_version.load(std::memory_order_seq_cst);
+            h->producers_waiting.fetch_add(1, std::memory_order_seq_cst);
+            if (full()) shm_queue_detail::FutexWait(&h->space_version, v, nullptr);
+            h->producers_waiting.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    /**
+     * @brief 非阻塞出队，仅限唯一的消费者调用
+     */
+    std::optional<T> try_pop() {
+        Header* h = header();
+        const uint64_t mask = h->capacity - 1;
+        const uint64_t pos = h->head.load(std::memory_order_relaxed);
+        if (seqs()[pos & mask].load(std::memory_order_acquire) != pos + 1) return std::nullopt;
+        T value;
+        std::memcpy(&value, data() + (pos & mask), sizeof(T));
+        seqs()[pos & mask].store(pos + h->capacity, std::memory_order_release);
+        h->head.store(pos + 1, std::memory_order_release);
+        h->space_version.fetch_add(1, std::memory_order_seq_cst);
+        if (h->producers_waiting.load(std::memory_order_seq_cst) != 0) {
+            shm_queue_detail::FutexWake(&h->space_version, INT_MAX);
+        }
+        auto_shrink(pos + 1);
+        return value;
+    }
+
+    /**
+     * @brief 阻塞出队，仅限唯一的消费者调用
+     */
+    T pop() {
+        for (;;) {
+            if (auto v = try_pop()) return *v;
+            wait_not_empty(nullptr);
+        }
+    }
+
+    /**
+     * @brief 限时阻塞出队，超时返回空，仅限唯一的消费者调用
+     */
+    template <typename Rep, typename Period>
+    std::optional<T> pop_for(std::chrono::duration<Rep, Period> timeout) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        for (;;) {
+            if (auto v = try_pop()) return v;
+            auto left = deadline - std::chrono::steady_clock::now();
+            if (left <= decltype(left)::zero()) return std::nullopt;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(left).count();
+            timespec ts{static_cast<time_t>(ns / 1000000000), static_cast<long>(ns % 1000000000)};
+            wait_not_empty(&ts);
+        }
+    }
+
+    /**
+     * @brief 立即对当前空闲槽位所占的整页打洞，归还共享内存，仅限消费者调用
+     * @return 本次打洞的字节数（按页向内取整）
+     */
+    size_t shrink_to_fit() {
+        Header* h = header();
+        const uint64_t cap = h->capacity;
+        // 冻结预约：此后 [tail, head + cap) 区间内的槽位不会有人写
+        const uint64_t tail = h->tail.fetch_or(shm_queue_detail::kTailFrozen, std::memory_order_acq_rel);
+        const uint64_t head = h->head.load(std::memory_order_relaxed);
+        size_t punched = 0;
+        if (tail - head < cap) {
+            const uint64_t begin = tail & (cap - 1);
+            const uint64_t free_slots = cap - (tail - head);
+            if (begin + free_slots <= cap) {
+                punched += punch_slots(begin, begin + free_slots);
+            } else {
+                punched += punch_slots(begin, cap);
+                punched += punch_slots(0, begin + free_slots - cap);
+            }
+        }
+        h->tail.fetch_and(~shm_queue_detail::kTailFrozen, std::memory_order_release);
+        const size_t current = static_cast<size_t>(tail - head);
+        policy_.on_shrunk(current);
+        h->high_mark.store(current, std::memory_order_relaxed);
+        h->shrink_count.fetch_add(1, std::memory_order_relaxed);
+        h->punched_bytes.fetch_add(punched, std::memory_order_relaxed);
+        return punched;
+    }
+
+    /**
+     * @brief 共享内存对象当前实际占用的字节（tmpfs 已分配的页），仅作为信息描述
+     */
+    size_t allocated_bytes() const {
+        struct stat st;
+        if (fd_ < 0 || ::fstat(fd_, &st) != 0) return 0;
+        return static_cast<size_t>(st.st_blocks) * 512;
+    }
+
+    size_t size() const {
+        const Header* h = header();
+        const uint64_t head = h->head.load(std::memory_order_relaxed);
+        const uint64_t tail = h->tail.load(std::memory_order_relaxed) & ~shm_queue_detail::kTailFrozen;
+        return tail > head ? static_cast<size_t>(tail - head) : 0;
+    }
+    bool empty() const { return size() == 0; }
+    size_t capacity() const { return static_cast<size_t>(header()->capacity); }
+    size_t last_high_mark() const { return static_cast<size_t>(header()->high_mark.load(std::memory_order_relaxed)); }
+    size_t shrink_count() const { return static_cast<size_t>(header()->shrink_count.load(std::memory_order_relaxed)); }
+
+private:
+    Header* header() { return static_cast<Header*>(base_); }
+    const Header* header() const { return static_cast<const Header*>(base_); }
+    std::atomic<uint64_t>* seqs() {
+        return reinterpret_cast<std::atomic<uint64_t>*>(static_cast<char*>(base_) + header()->seq_offset);
+    }
+    T* data() { return reinterpret_cast<T*>(static_cast<char*>(base_) + header()->data_offset); }
+
+    bool map(size_t size) {
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) return false;
+        base_ = p;
+        size_ = size;
+        return true;
+    }
+
+    bool full() const {
+        return size() >= capacity();
+    }
+
+    void wait_not_empty(const timespec* timeout) {
+        Header* h = header();
+        h->consumer_waiting.store(1, std::memory_order_seq_cst);
+        const uint32_t v = h->data_version.load(std::memory_order_seq_cst);
+        const uint64_t pos = h->head.load(std::memory_order_relaxed);
+        if (seqs()[pos & (h->capacity - 1)].load(std::memory_order_acquire) != pos + 1) {
+            shm_queue_detail::FutexWait(&h->data_version, v, timeout);
+        }
+        h->consumer_waiting.store(0, std::memory_order_relaxed);
+    }
+
+    // 对槽位 [first, last) 覆盖的整页打洞；区间两端不足一页的部分保留
+    size_t punch_slots(uint64_t first, uint64_t last) {
+        const size_t page = shm_queue_detail::PageSize();
+        const size_t base = static_cast<size_t>(header()->data_offset);
+        size_t begin = shm_queue_detail::RoundUp(base + first * sizeof(T), page);
+        size_t end = (base + last * sizeof(T)) / page * page;
+        if (begin >= end) return 0;
+        if (::fallocate(fd_, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(begin),
+                        static_cast<off_t>(end - begin)) != 0) {
+            // 老内核的 tmpfs 不支持 fallocate 打洞时退回 MADV_REMOVE
+            if (::madvise(static_cast<char*>(base_) + begin, end - begin, MADV_REMOVE) != 0) return 0;
+        }
+        return end - begin;
+    }
+
+    // 生产者在发布后抬高高水位；只有超过旧值时才写
+    void raise_high_mark(uint64_t size) {
+        Header* h = header();
+        uint64_t cur = h->high_mark.load(std::memory_order_relaxed);
+        while (size > cur && size <= h->capacity &&
+               !h->high_mark.compare_exchange_weak(cur, size, std::memory_order_relaxed)) {
+        }
+    }
+
+    void auto_shrink(uint64_t new_head) {
+        Header* h = header();
+        const uint64_t tail = h->tail.load(std::memory_order_relaxed) & ~shm_queue_detail::kTailFrozen;
+        const size_t after = tail > new_head ? static_cast<size_t>(tail - new_head) : 0;
+        // 高水位由生产者写在共享头部里，消费者检查前同步到本地策略
+        policy_.on_grow(static_cast<size_t>(h->high_mark.load(std::memory_order_relaxed)));
+        if (policy_.on_remove(after)) shrink_to_fit();
+    }
+
+    int fd_ = -1;
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    // 消费者本地的收缩策略（只有消费者调用 on_grow/on_remove）
+    ShrinkPolicy policy_;
+};
+
+#endif // __linux__
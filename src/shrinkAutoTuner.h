@@ -0,0 +1,144 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief 在线调参的约束与步长，各项含义见 ShrinkAutoTuner
+ */
+struct ShrinkTuning {
+    double cpu_budget = 0.01;                          // 收缩耗时占墙钟时间的上限
+    double max_regrow_ratio = 0.25;                    // 收缩后又长回去的次数占收缩次数的上限
+    std::chrono::nanoseconds window = std::chrono::seconds(1); // 每个评估窗口的长度
+    size_t min_check_interval = 16;
+    size_t max_check_interval = size_t(1) << 20;
+    float min_shrink_factor = 0.05f;
+    float max_shrink_factor = 0.5f;
+};
+
+/**
+ * @brief 调参器的统计快照，仅作为信息描述
+ */
+struct ShrinkTunerStats {
+    size_t windows = 0;          // 已评估的窗口数
+    size_t adjustments = 0;      // 实际改动过参数的窗口数
+    double last_cpu_ratio = 0;   // 最近一个窗口的收缩耗时占比
+    double last_regrow_ratio = 0; // 最近一个窗口的回涨比例
+};
+
+/**
+ * @brief ShrinkPolicy 的在线调参器：按窗口观察收缩代价，自动调整 check_interval 与 shrink_factor
+ *
+ * 每个窗口统计两件事：
+ *   - 收缩耗时占比：on_remove 要求收缩到 on_shrunk 之间的时间（即调用方重建存储的时间）之和 / 窗口墙钟时间；
+ *   - 回涨比例：被回涨抵消的收缩次数 / 收缩次数。收缩后元素数又回到收缩前高水位的一半以上即为回涨，
+ *     说明刚释放的内存马上又要重新分配，期间连续的几次收缩一并算作被抵消。
+ *     收缩与回涨往往落在不同窗口，这两个计数跨窗口按 1/2 衰减而不是清零。
+ * 窗口结束时：
+ *   - 耗时超出 cpu_budget 或回涨比例超出 max_regrow_ratio：退让，check_interval 翻倍、shrink_factor 减半；
+ *   - 否则若窗口内有检查因未达阈值而放过了过半的空闲内存，且耗时低于预算的 1/4、回涨比例低于上限的一半：
+ *     收紧，check_interval 减半、shrink_factor 乘 1.25，更早归还内存。
+ * 调整结果限制在 [min, max] 内，从下一次检查起生效。
+ * 只统计由 on_remove 触发的收缩；shrink_to_fit 等手动收缩只让高水位归位，不计入代价。
+ * 时间只在每次检查与每次收缩时读取，入队/出队的热路径上只多一次比较。
+ * 非线程安全，由 ShrinkPolicy 所属容器的锁保护。
+ */
+class ShrinkAutoTuner {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit ShrinkAutoTuner(const ShrinkTuning& tuning = ShrinkTuning())
+        : tuning_(tuning), window_start_(Clock::now()) {}
+
+    /**
+     * @param size 增长后的元素数
+     */
+    void on_grow(size_t size) noexcept {
+        if (regrow_watch_ != 0 && size >= regrow_watch_) {
+            regrowths_ += static_cast<double>(watched_shrinks_);
+            watched_shrinks_ = 0;
+            regrow_watch_ = 0;
+        }
+    }
+
+    /**
+     * @brief 每次删除时调用：上一次要求的收缩若没有被执行（调用方关闭了自动收缩等），不再计时
+     */
+    void on_remove() noexcept { shrink_pending_ = false; }
+
+    /**
+     * @brief 每次检查时调用；窗口到期时就地调整 interval 与 factor
+     * @param size 当前元素数
+     * @param high_mark 当前高水位
+     * @param shrink 本次检查是否要求收缩
+     */
+    void on_check(size_t size, size_t high_mark, bool shrink, size_t& interval, float& factor) noexcept {
+        const Clock::time_point now = Clock::now();
+        if (shrink) {
+            shrink_start_ = now;
+            shrink_pending_ = true;
+        } else if (size < high_mark / 2) {
+            ++win_retained_;
+        }
+        if (now - window_start_ >= tuning_.window) retune(now, interval, factor);
+    }
+
+    /**
+     * @param high_mark 收缩前的高水位
+     * @param size 收缩后的元素数
+     */
+    void on_shrunk(size_t high_mark, size_t size) noexcept {
+        if (!shrink_pending_) return;
+        shrink_pending_ = false;
+        win_shrink_time_ += Clock::now() - shrink_start_;
+        shrinks_ += 1;
+        // 连续收缩时沿用最早那次的回涨线：越过它即说明这一串收缩释放的内存又被要了回去
+        if (high_mark / 2 > size) {
+            regrow_watch_ = std::max(regrow_watch_, high_mark / 2);
+            ++watched_shrinks_;
+        }
+    }
+
+    const ShrinkTuning& tuning() const noexcept { return tuning_; }
+    const ShrinkTunerStats& stats() const noexcept { return stats_; }
+
+private:
+    void retune(Clock::time_point now, size_t& interval, float& factor) noexcept {
+        const double elapsed = static_cast<double>(std::max<int64_t>((now - window_start_).count(), 1));
+        const double cpu = static_cast<double>(win_shrink_time_.count()) / elapsed;
+        const double regrow = shrinks_ > 0 ? regrowths_ / shrinks_ : 0.0;
+        const size_t old_interval = interval;
+        const float old_factor = factor;
+        if (cpu > tuning_.cpu_budget || regrow > tuning_.max_regrow_ratio) {
+            interval = std::min(std::max(interval, size_t(1)) * 2, tuning_.max_check_interval);
+            factor = std::max(factor * 0.5f, tuning_.min_shrink_factor);
+        } else if (win_retained_ != 0 && cpu < tuning_.cpu_budget / 4 && regrow <= tuning_.max_regrow_ratio / 2) {
+            interval = std::max(interval / 2, tuning_.min_check_interval);
+            factor = std::min(factor * 1.25f, tuning_.max_shrink_factor);
+        }
+        ++stats_.windows;
+        if (interval != old_interval || factor != old_factor) ++stats_.adjustments;
+        stats_.last_cpu_ratio = cpu;
+        stats_.last_regrow_ratio = regrow;
+
+        window_start_ = now;
+        win_shrink_time_ = Clock::duration::zero();
+        win_retained_ = 0;
+        shrinks_ *= 0.5;
+        regrowths_ *= 0.5;
+    }
+
+    ShrinkTuning tuning_;
+    ShrinkTunerStats stats_;
+    Clock::time_point window_start_;
+    Clock::time_point shrink_start_{};
+    Clock::duration win_shrink_time_ = Clock::duration::zero();
+    size_t win_retained_ = 0;
+    double shrinks_ = 0;   // 跨窗口衰减的收缩次数
+    double regrowths_ = 0; // 跨窗口衰减的被抵消收缩次数
+    size_t regrow_watch_ = 0; // 非 0 时：元素数回到该值即记一次回涨
+    size_t watched_shrinks_ = 0;
+    bool shrink_pending_ = false;
+};
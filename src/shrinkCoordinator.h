@@ -0,0 +1,336 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__GLIBC__) || defined(_WIN32)
+#include <malloc.h>
+#endif
+
+namespace shrink_coordinator_detail {
+
+/**
+ * @brief 把 malloc 空闲内存归还系统（glibc: malloc_trim；MSVC CRT: _heapmin）
+ * @return 平台支持且确有归还时返回 true
+ */
+inline bool TrimMallocArena() {
+#if defined(__GLIBC__)
+    return ::malloc_trim(0) != 0;
+#elif defined(_WIN32)
+    return ::_heapmin() == 0;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief 读取 PSI 文件中 "some avg10=" 的值（过去 10 秒内有任务因内存受阻的时间占比，百分数）
+ * @return 文件不存在或格式不符时返回 -1
+ */
+inline double ReadPsiSomeAvg10(const std::string& path) {
+    if (path.empty()) return -1.0;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("some ", 0) != 0) continue;
+        size_t pos = line.find("avg10=");
+        if (pos == std::string::npos) return -1.0;
+        try {
+            return std::stod(line.substr(pos + 6));
+        } catch (...) {
+            return -1.0;
+        }
+    }
+    return -1.0;
+}
+
+/**
+ * @brief 默认的 PSI 来源：优先本进程所在 cgroup v2 的 memory.pressure，其次系统级 /proc/pressure/memory
+ * @return 都不可用（非 Linux、内核未开 PSI）时返回空串
+ */
+inline std::string DefaultPsiPath() {
+#if defined(__linux__)
+    std::ifstream cg("/proc/self/cgroup");
+    std::string line;
+    while (std::getline(cg, line)) {
+        if (line.rfind("0::", 0) != 0) continue; // cgroup v2 统一层级
+        std::string path = "/sys/fs/cgroup" + line.substr(3) + "/memory.pressure";
+        if (ReadPsiSomeAvg10(path) >= 0) return path;
+    }
+    if (ReadPsiSomeAvg10("/proc/pressure/memory") >= 0) return "/proc/pressure/memory";
+#endif
+    return {};
+}
+
+} // namespace shrink_coordinator_detail
+
+/**
+ * @brief 一轮全局收缩的结果
+ */
+struct ShrinkRoundReport {
+    const char* reason = "";        // "manual" / "rss" / "psi"，空串表示本轮未触发
+    size_t members = 0;             // 参与排序的成员数
+    size_t shrunk = 0;              // 实际收缩的成员数
+    size_t estimated_bytes = 0;     // 各成员上报的估算回收字节之和
+    bool malloc_trimmed = false;    // malloc_trim 是否确有归还
+    size_t rss_before = 0;          // 未配置 RSS 来源时为 0
+    size_t rss_after = 0;
+};
+
+/**
+ * @brief 进程级的收缩协调器：按内存压力统一决定何时、先收缩哪些队列
+ *
+ * 每个 AutoShrinkBlockingQueue 各自按 pop 次数收缩，几百个队列在内存充裕时也会反复 O(n) 重建，白白耗 CPU。
+ * 加入协调器的队列默认关闭自己的自动收缩（仍记录高水位），改由协调器在以下时机统一收缩：
+ *   - 显式调用 trim_all()；
+ *   - poll()/后台线程发现 RSS 超过 rss_soft_limit，或 PSI some avg10 超过 psi_some_avg10。
+ * 每轮按估算可回收字节从大到小排序，最多收缩 max_targets_per_round 个，
+ * 有成员真正收缩后再调用一次 malloc_trim，把 malloc 空闲链上的内存还给系统。
+ * 收缩时持有协调器锁，成员离开（Handle 析构）会等待本轮结束，因此 Handle 须先于队列析构。
+ */
+class ShrinkCoordinator {
+public:
+    struct Config {
+        size_t rss_soft_limit = 0;              // RSS 超过该字节数视为有压力，0 表示不看 RSS
+        double psi_some_avg10 = 0.0;            // PSI some avg10 超过该百分比视为有压力，0 表示不看 PSI
+        size_t max_targets_per_round = 16;      // 压力触发时每轮最多收缩的成员数（trim_all 不受限）
+        size_t min_reclaimable = 64 * 1024;     // 估算可回收字节低于该值的成员不收缩
+        bool trim_malloc = true;                // 收缩后是否调用 malloc_trim
+        std::function<size_t()> rss_bytes;      // RSS 来源，通常传 GetProcessRssBytes；为空时 RSS 阈值不生效
+        std::string psi_path;                   // PSI 文件，为空时用 DefaultPsiPath()
+    };
+
+    /**
+     * @brief 成员登记句柄，析构时退出协调器并恢复队列自己的自动收缩；只可移动
+     */
+    class Handle {
+    public:
+        Handle() = default;
+        Handle(ShrinkCoordinator* owner, uint64_t id) : owner_(owner), id_(id) {}
+        Handle(Handle&& other) noexcept : owner_(std::exchange(other.owner_, nullptr)), id_(other.id_) {}
+        Handle& operator=(Handle&& other) noexcept {
+            if (this != &other) {
+                reset();
+                owner_ = std::exchange(other.owner_, nullptr);
+                id_ = other.id_;
+            }
+            return *this;
+        }
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+        ~Handle() { reset(); }
+
+        void reset() {
+            if (owner_) owner_->leave(id_);
+            owner_ = nullptr;
+        }
+        explicit operator bool() const { return owner_ != nullptr; }
+
+    private:
+        ShrinkCoordinator* owner_ = nullptr;
+        uint64_t id_ = 0;
+    };
+
+    struct MemberReport {
+        std::string name;
+        size_t reclaimable = 0;
+    };
+
+    ShrinkCoordinator() : ShrinkCoordinator(Config{}) {}
+    explicit ShrinkCoordinator(Config config) { configure(std::move(config)); }
+    ~ShrinkCoordinator() { stop(); }
+
+    ShrinkCoordinator(const ShrinkCoordinator&) = delete;
+    ShrinkCoordinator& operator=(const ShrinkCoordinator&) = delete;
+
+    static ShrinkCoordinator& instance() {
+        static ShrinkCoordinator coordinator;
+        return coordinator;
+    }
+
+    void configure(Config config) {
+        if (config.psi_path.empty()) config.psi_path = shrink_coordinator_detail::DefaultPsiPath();
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_ = std::move(config);
+    }
+
+    /**
+     * @brief 队列加入协调器
+     * @param q 需提供 reclaimable_bytes() / shrink_to_fit() / set_auto_shrink(bool)，须比返回的 Handle 活得久
+     * @param take_over true 时关闭队列自己的自动收缩，完全由协调器决定
+     */
+    template <typename Q>
+    [[nodiscard]] Handle join(std::string name, Q& q, bool take_over = true) {
+        if (take_over) q.set_auto_shrink(false);
+        return join_custom(std::move(name),
+                           [&q] { return q.reclaimable_bytes(); },
+                           [&q] { return q.shrink_to_fit(); },
+                           take_over ? std::function<void()>([&q] { q.set_auto_shrink(true); }) : nullptr);
+    }
+
+    /**
+     * @brief 以回调形式加入（非队列的缓存、池等）
+     * @param reclaimable 返回估算可回收字节，须自行保证线程安全
+     * @param shrink 执行收缩并返回估算回收字节
+     * @param on_leave 退出协调器时调用，可为空
+     */
+    [[nodiscard]] Handle join_custom(std::string name, std::function<size_t()> reclaimable,
+                                     std::function<size_t()> shrink, std::function<void()> on_leave = nullptr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        members_.push_back(Member{++next_id_, std::move(name), std::move(reclaimable), std::move(shrink),
+                                  std::move(on_leave)});
+        return Handle(this, next_id_);
+    }
+
+    /**
+     * @brief 立即收缩所有可回收字节不低于 min_reclaimable 的成员（从大到小），随后 malloc_trim
+     */
+    ShrinkRoundReport trim_all() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return run_round_locked("manual", members_.size());
+    }
+
+    /**
+     * @brief 检查一次内存压力，有压力时收缩可回收字节最多的前 max_targets_per_round 个成员
+     * @return reason 为空串表示没有压力、本轮未收缩
+     */
+    ShrinkRoundReport poll() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const char* reason = pressure_reason_locked();
+        if (!*reason) return {};
+        return run_round_locked(reason, config_.max_targets_per_round);
+    }
+
+    /**
+     * @brief 当前是否有内存压力（RSS 或 PSI 超阈值）
+     */
+    bool under_pressure() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return *pressure_reason_locked() != '\0';
+    }
+
+    /**
+     * @brief 各成员当前的估算可回收字节，降序，仅作为信息描述
+     */
+    std::vector<MemberReport> scan() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<MemberReport> out;
+        out.reserve(members_.size());
+        for (Member& m : members_) out.push_back(MemberReport{m.name, m.reclaimable()});
+        std::stable_sort(out.begin(), out.end(),
+                         [](const MemberReport& a, const MemberReport& b) { return a.reclaimable > b.reclaimable; });
+        return out;
+    }
+
+    /**
+     * @brief 启动后台线程，每隔 interval 调用一次 poll()
+     */
+    void start(std::chrono::milliseconds interval) {
+        std::lock_guard<std::mutex> lock(thread_mutex_);
+        if (worker_.joinable()) return;
+        stop_requested_ = false;
+        worker_ = std::thread([this, interval] {
+            std::unique_lock<std::mutex> lk(thread_mutex_);
+            while (!thread_cv_.wait_for(lk, interval, [this] { return stop_requested_; })) {
+                lk.unlock();
+                poll();
+                rounds_.fetch_add(1, std::memory_order_relaxed);
+                lk.lock();
+            }
+        });
+    }
+
+    void stop() {
+        std::thread worker;
+        {
+            std::lock_guard<std::mutex> lock(thread_mutex_);
+            stop_requested_ = true;
+            worker = std::move(worker_);
+        }
+        thread_cv_.notify_all();
+        if (worker.joinable()) worker.join();
+    }
+
+    size_t members() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return members_.size();
+    }
+
+    /**
+     * @brief 后台线程已执行的 poll 次数，仅作为信息描述
+     */
+    uint64_t background_polls() const { return rounds_.load(std::memory_order_relaxed); }
+
+private:
+    struct Member {
+        uint64_t id;
+        std::string name;
+        std::function<size_t()> reclaimable;
+        std::function<size_t()> shrink;
+        std::function<void()> on_leave;
+    };
+
+    const char* pressure_reason_locked() {
+        if (config_.rss_soft_limit != 0 && config_.rss_bytes && config_.rss_bytes() > config_.rss_soft_limit) {
+            return "rss";
+        }
+        if (config_.psi_some_avg10 > 0.0 &&
+            shrink_coordinator_detail::ReadPsiSomeAvg10(config_.psi_path) > config_.psi_some_avg10) {
+            return "psi";
+        }
+        return "";
+    }
+
+    ShrinkRoundReport run_round_locked(const char* reason, size_t max_targets) {
+        ShrinkRoundReport report;
+        report.reason = reason;
+        report.members = members_.size();
+        if (config_.rss_bytes) report.rss_before = config_.rss_bytes();
+
+        std::vector<std::pair<size_t, Member*>> order;
+        order.reserve(members_.size());
+        for (Member& m : members_) order.emplace_back(m.reclaimable(), &m);
+        std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+        for (size_t i = 0; i < order.size() && report.shrunk < max_targets; ++i) {
+            if (order[i].first < config_.min_reclaimable || order[i].first == 0) break;
+            report.estimated_bytes += order[i].second->shrink();
+            ++report.shrunk;
+        }
+        if (config_.trim_malloc && report.shrunk != 0) {
+            report.malloc_trimmed = shrink_coordinator_detail::TrimMallocArena();
+        }
+        if (config_.rss_bytes) report.rss_after = config_.rss_bytes();
+        return report;
+    }
+
+    void leave(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = std::find_if(members_.begin(), members_.end(), [id](const Member& m) { return m.id == id; });
+        if (it == members_.end()) return;
+        if (it->on_leave) it->on_leave();
+        members_.erase(it);
+    }
+
+    mutable std::mutex mutex_;
+    Config config_;
+    std::vector<Member> members_;
+    uint64_t next_id_ = 0;
+
+    std::mutex thread_mutex_;
+    std::condition_variable thread_cv_;
+    bool stop_requested_ = false;
+    std::thread worker_;
+    std::atomic<uint64_t> rounds_{0};
+};
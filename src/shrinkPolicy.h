@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+
+#include "shrinkAutoTuner.h"
+
+/**
+ * @brief 高水位 + 收缩因子的自动收缩策略（AutoShrinkBlockingQueue 与各 AutoShrink 容器共用）
+ *
+ * 容器每次变大时上报 on_grow，每次删除元素时上报 on_remove；
+ * 累计删除 check_interval 个元素后检查一次：当前元素数低于 high mark 的 shrink_factor（或为空）时要求收缩，
+ * 调用方收缩完成后调用 on_shrunk，high mark 随之降到当前元素数。
+ * 收缩本身是 O(n) 的，按删除次数摊还，不会在热路径上频繁触发。
+ * 参数可在运行时修改（set_check_interval / set_shrink_factor），也可交给 ShrinkAutoTuner 在线调整（enable_tuning）；
+ * 调参器按需分配，未开启时只多一个空指针，热路径上只多一次判空。
+ * 非线程安全，由所属容器的锁保护。
+ *
+ * 自定义策略只需提供同名的 on_grow / on_remove / on_shrunk / high_mark / shrink_count 接口，
+ * 作为模板参数传给 AutoShrinkVector / AutoShrinkUnorderedMap。
+ */
+class ShrinkPolicy {
+public:
+    /**
+     * @param check_interval 每删除多少个元素检查一次是否需要 shrink
+     * @param shrink_factor 当前元素数低于 high mark 的 shrink_factor 时触发 shrink（推荐 0.15~0.25）
+     */
+    explicit ShrinkPolicy(size_t check_interval = 150, float shrink_factor = 0.25f)
+        : check_interval_(check_interval), shrink_factor_(shrink_factor) {}
+
+    ShrinkPolicy(const ShrinkPolicy& o)
+        : check_interval_(o.check_interval_), shrink_factor_(o.shrink_factor_), op_count_(o.op_count_),
+          high_mark_(o.high_mark_), shrink_count_(o.shrink_count_),
+          tuner_(o.tuner_ ? std::make_unique<ShrinkAutoTuner>(*o.tuner_) : nullptr) {}
+    ShrinkPolicy(ShrinkPolicy&&) noexcept = default;
+    ShrinkPolicy& operator=(const ShrinkPolicy& o) {
+        if (this != &o) *this = ShrinkPolicy(o);
+        return *this;
+    }
+    ShrinkPolicy& operator=(ShrinkPolicy&&) noexcept = default;
+
+    void on_grow(size_t size) noexcept {
+        if (size > high_mark_) high_mark_ = size;
+        if (tuner_) tuner_->on_grow(size);
+    }
+
+    /**
+     * @param size 删除后的元素数
+     * @param removed 本次删除的元素个数（批量删除时一次性计入）
+     * @return true 表示调用方应当立即收缩
+     */
+    bool on_remove(size_t size, size_t removed = 1) noexcept {
+        if (tuner_) tuner_->on_remove();
+        op_count_ += removed;
+        if (op_count_ < check_interval_) return false;
+        op_count_ = 0;
+        // 空容器也允许 shrink，这样内存和 high_mark 也能归零
+        const bool shrink = size == 0 || size < high_mark_ * shrink_factor_;
+        if (tuner_) tuner_->on_check(size, high_mark_, shrink, check_interval_, shrink_factor_);
+        return shrink;
+    }
+
+    void on_shrunk(size_t size) noexcept {
+        if (tuner_) tuner_->on_shrunk(high_mark_, size);
+        high_mark_ = size;
+        ++shrink_count_;
+    }
+
+    size_t high_mark() const noexcept { return high_mark_; }
+    size_t shrink_count() const noexcept { return shrink_count_; }
+    size_t check_interval() const noexcept { return check_interval_; }
+    float shrink_factor() const noexcept { return shrink_factor_; }
+
+    /**
+     * @brief 运行时修改检查间隔，下一次删除起生效（0 按 1 处理）
+     */
+    void set_check_interval(size_t check_interval) noexcept { check_interval_ = std::max<size_t>(check_interval, 1); }
+
+    /**
+     * @brief 运行时修改收缩因子，下一次检查起生效（限制在 [0, 1]）
+     */
+    void set_shrink_factor(float shrink_factor) noexcept { shrink_factor_ = std::clamp(shrink_factor, 0.0f, 1.0f); }
+
+    /**
+     * @brief 开启在线调参，之后 check_interval / shrink_factor 由调参器按窗口调整；重复调用会以新约束重新开始
+     */
+    void enable_tuning(const ShrinkTuning& tuning = ShrinkTuning()) { tuner_ = std::make_unique<ShrinkAutoTuner>(tuning); }
+
+    /**
+     * @brief 关闭在线调参，参数停在当前值
+     */
+    void disable_tuning() noexcept { tuner_.reset(); }
+
+    /**
+     * @return 未开启调参时为 nullptr
+     */
+    const ShrinkAutoTuner* tuner() const noexcept { return tuner_.get(); }
+
+private:
+    size_t check_interval_;
+    float shrink_factor_;
+    size_t op_count_ = 0;
+    size_t high_mark_ = 0;
+    size_t shrink_count_ = 0;
+    std::unique_ptr<ShrinkAutoTuner> tuner_;
+};
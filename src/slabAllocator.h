@@ -0,0 +1,334 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace slab_detail {
+
+constexpr size_t kSlabSize = 64 * 1024;     // 每个 slab 64KB，按 64KB 对齐，指针按掩码即可找到所属 slab
+constexpr size_t kMaxObjectSize = 2048;     // 超过的对象直接走 operator new
+
+// 向系统申请一块按 kSlabSize 对齐的内存；失败返回 nullptr
+inline void* MapSlab() {
+#if defined(_WIN32)
+    // VirtualAlloc 的分配粒度就是 64KB，天然对齐
+    return ::VirtualAlloc(nullptr, kSlabSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#else
+    // 多映射一个 slab 再裁掉首尾，得到对齐地址
+    void* raw = ::mmap(nullptr, 2 * kSlabSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return nullptr;
+    uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+    uintptr_t aligned = (start + kSlabSize - 1) & ~(kSlabSize - 1);
+    if (aligned > start) ::munmap(raw, aligned - start);
+    uintptr_t tail = aligned + kSlabSize;
+    uintptr_t end = start + 2 * kSlabSize;
+    if (end > tail) ::munmap(reinterpret_cast<void*>(tail), end - tail);
+    return reinterpret_cast<void*>(aligned);
+#endif
+}
+
+// 整块归还系统（RSS 立即下降，不经过 malloc 的空闲链）
+inline void UnmapSlab(void* p) {
+#if defined(_WIN32)
+    ::VirtualFree(p, 0, MEM_RELEASE);
+#else
+    ::munmap(p, kSlabSize);
+#endif
+}
+
+} // namespace slab_detail
+
+/**
+ * @brief 单一尺寸规格的 slab 池：64KB 对齐的 slab 切成等长对象，空 slab 整块归还系统
+ *
+ * 非线程安全，由所属 SlabArena 的持有者（即容器）保证单线程访问，和容器本身的约束一致。
+ * 分配：优先从有空位的 slab 的空闲链/未切分区取；没有再映射新 slab。
+ * 释放：指针按掩码找到 slab 头，放回其空闲链；slab 变空时若已缓存足够的空 slab 则直接 munmap。
+ */
+class SlabPool {
+public:
+    /**
+     * @param object_size 对象大小（字节）
+     * @param align 对象对齐
+     * @param max_cached_empty 最多保留多少个空 slab 不归还（避免 insert/erase 在边界抖动时反复映射）
+     */
+    SlabPool(size_t object_size, size_t align, size_t max_cached_empty = 1)
+        : align_(std::max(align, alignof(void*))),
+          object_size_(round_up(std::max(object_size, sizeof(void*)), align_)),
+          first_offset_(round_up(sizeof(SlabHeader), align_)),
+          objects_per_slab_((slab_detail::kSlabSize - first_offset_) / object_size_),
+          max_cached_empty_(max_cached_empty) {}
+
+    SlabPool(const SlabPool&) = delete;
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    ~SlabPool() {
+        // 容器析构时所有节点已归还；这里兜底释放全部 slab
+        release_list(partial_);
+        release_list(full_);
+        release_list(empty_);
+    }
+
+    void* allocate() {
+        SlabHeader* s = partial_;
+        if (!s) {
+            s = empty_ ? take_empty() : map_new_slab();
+            if (!s) throw std::bad_alloc();
+            link(partial_, s);
+        }
+        void* p;
+        if (s->free_list) {
+            p = s->free_list;
+            s->free_list = *static_cast<void**>(p);
+        } else {
+            p = reinterpret_cast<char*>(s) + first_offset_ + s->carved * object_size_;
+            ++s->carved;
+        }
+        ++s->used;
+        ++live_objects_;
+        if (s->used == objects_per_slab_) {
+            unlink(partial_, s);
+            link(full_, s);
+        }
+        return p;
+    }
+
+    void deallocate(void* p) noexcept {
+        SlabHeader* s = slab_of(p);
+        bool was_full = s->used == objects_per_slab_;
+        *static_cast<void**>(p) = s->free_list;
+        s->free_list = p;
+        --s->used;
+        --live_objects_;
+        if (was_full) {
+            unlink(full_, s);
+            link(partial_, s);
+        }
+        if (s->used == 0) {
+            unlink(partial_, s);
+            if (empty_count_ < max_cached_empty_) {
+                s->free_list = nullptr;
+                s->carved = 0;
+                link(empty_, s);
+                ++empty_count_;
+            } else {
+                slab_detail::UnmapSlab(s);
+                --slab_count_;
+            }
+        }
+    }
+
+    /**
+     * @brief 归还所有缓存的空 slab
+     * @return 归还的字节数
+     */
+    size_t release_empty() noexcept {
+        size_t n = empty_count_;
+        release_list(empty_);
+        empty_count_ = 0;
+        return n * slab_detail::kSlabSize;
+    }
+
+    bool owns(const void* p) const noexcept { return slab_of(p)->pool == this; }
+
+    size_t object_size() const { return object_size_; }
+    size_t align() const { return align_; }
+    size_t slab_count() const { return slab_count_; }
+    size_t live_objects() const { return live_objects_; }
+    size_t reserved_bytes() const { return slab_count_ * slab_detail::kSlabSize; }
+
+private:
+    struct SlabHeader {
+        SlabPool* pool;
+        SlabHeader* prev;
+        SlabHeader* next;
+        void* free_list;   // 已归还对象组成的单链
+        size_t carved;     // 从未分配过的区域的切分进度
+        size_t used;
+    };
+
+    static size_t round_up(size_t n, size_t a) { return (n + a - 1) / a * a; }
+
+    static SlabHeader* slab_of(const void* p) noexcept {
+        return reinterpret_cast<SlabHeader*>(reinterpret_cast<uintptr_t>(p) & ~(slab_detail::kSlabSize - 1));
+    }
+
+    SlabHeader* map_new_slab() {
+        void* mem = slab_detail::MapSlab();
+        if (!mem) return nullptr;
+        ++slab_count_;
+        return new (mem) SlabHeader{this, nullptr, nullptr, nullptr, 0, 0};
+    }
+
+    SlabHeader* take_empty() {
+        SlabHeader* s = empty_;
+        unlink(empty_, s);
+        --empty_count_;
+        return s;
+    }
+
+    static void link(SlabHeader*& head, SlabHeader* s) {
+        s->prev = nullptr;
+        s->next = head;
+        if (head) head->prev = s;
+        head = s;
+    }
+
+    static void unlink(SlabHeader*& head, SlabHeader* s) {
+        if (s->prev) s->prev->next = s->next;
+        else head = s->next;
+        if (s->next) s->next->prev = s->prev;
+        s->prev = s->next = nullptr;
+    }
+
+    void release_list(SlabHeader*& head) noexcept {
+        while (head) {
+            SlabHeader* next = head->next;
+            slab_detail::UnmapSlab(head);
+            --slab_count_;
+            head = next;
+        }
+    }
+
+    const size_t align_;
+    const size_t object_size_;
+    const size_t first_offset_;
+    const size_t objects_per_slab_;
+    const size_t max_cached_empty_;
+
+    SlabHeader* partial_ = nullptr; // 有空位的 slab，分配总从链头取，新释放的 slab 也挂到链头，节点尽量集中
+    SlabHeader* full_ = nullptr;
+    SlabHeader* empty_ = nullptr;
+    size_t empty_count_ = 0;
+    size_t slab_count_ = 0;
+    size_t live_objects_ = 0;
+};
+
+/**
+ * @brief 一个容器专属的一组 SlabPool（按对象尺寸/对齐分规格，懒创建）
+ *
+ * list/map 会把分配器 rebind 成节点类型，实际只会用到一两个规格。
+ */
+class SlabArena {
+public:
+    explicit SlabArena(size_t max_cached_empty = 1) : max_cached_empty_(max_cached_empty) {}
+
+    SlabPool& pool_for(size_t size, size_t align) {
+        if (last_ && last_size_ == size && last_align_ == align) return *last_;
+        for (auto& e : pools_) {
+            if (e.size == size && e.align == align) {
+                remember(e);
+                return *e.pool;
+            }
+        }
+        pools_.push_back(Entry{size, align, std::make_unique<SlabPool>(size, align, max_cached_empty_)});
+        remember(pools_.back());
+        return *pools_.back().pool;
+    }
+
+    size_t release_empty() noexcept {
+        size_t n = 0;
+        for (auto& e : pools_) n += e.pool->release_empty();
+        return n;
+    }
+
+    size_t reserved_bytes() const {
+        size_t n = 0;
+        for (auto& e : pools_) n += e.pool->reserved_bytes();
+        return n;
+    }
+
+    size_t slab_count() const {
+        size_t n = 0;
+        for (auto& e : pools_) n += e.pool->slab_count();
+        return n;
+    }
+
+private:
+    struct Entry {
+        size_t size;
+        size_t align;
+        std::unique_ptr<SlabPool> pool;
+    };
+
+    void remember(const Entry& e) {
+        last_ = e.pool.get();
+        last_size_ = e.size;
+        last_align_ = e.align;
+    }
+
+    size_t max_cached_empty_;
+    std::vector<Entry> pools_;
+    SlabPool* last_ = nullptr;
+    size_t last_size_ = 0;
+    size_t last_align_ = 0;
+};
+
+/**
+ * @brief 给节点式容器用的 slab 分配器，每个容器实例一个 SlabArena
+ *
+ * 用法：std::list<T, SlabAllocator<T>>、std::map<K, V, std::less<K>, SlabAllocator<std::pair<const K, V>>>
+ * 默认构造即新建一个 arena，所以每个容器的节点落在各自的 slab 上，
+ * 容器 clear/析构后 slab 整块 munmap，RSS 立即回落，不受其它容器的碎片影响。
+ * 拷贝构造容器时副本拿到新的 arena；移动/交换时 arena 跟着节点走。
+ * 单个对象且不超过 2KB 时走 slab，否则（如 unordered_map 的桶数组）直接走 operator new。
+ * 线程约束与容器相同：同一个容器（及其 arena）同一时刻只能被一个线程修改。
+ */
+template <typename T>
+class SlabAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    SlabAllocator() : arena_(std::make_shared<SlabArena>()) {}
+    // 只声明拷贝（不生成移动）：被移走的容器仍持有有效 arena，可以继续使用
+    SlabAllocator(const SlabAllocator&) noexcept = default;
+    SlabAllocator& operator=(const SlabAllocator&) noexcept = default;
+    explicit SlabAllocator(std::shared_ptr<SlabArena> arena) : arena_(std::move(arena)) {}
+    template <typename U>
+    SlabAllocator(const SlabAllocator<U>& other) noexcept : arena_(other.arena()) {}
+
+    T* allocate(size_t n) {
+        if (n == 1 && sizeof(T) <= slab_detail::kMaxObjectSize) {
+            return static_cast<T*>(arena_->pool_for(sizeof(T), alignof(T)).allocate());
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (n == 1 && sizeof(T) <= slab_detail::kMaxObjectSize) {
+            arena_->pool_for(sizeof(T), alignof(T)).deallocate(p);
+            return;
+        }
+        ::operator delete(p, std::align_val_t(alignof(T)));
+    }
+
+    SlabAllocator select_on_container_copy_construction() const { return SlabAllocator(); }
+
+    const std::shared_ptr<SlabArena>& arena() const noexcept { return arena_; }
+
+    template <typename U>
+    bool operator==(const SlabAllocator<U>& other) const noexcept { return arena_ == other.arena(); }
+    template <typename U>
+    bool operator!=(const SlabAllocator<U>& other) const noexcept { return arena_ != other.arena(); }
+
+private:
+    std::shared_ptr<SlabArena> arena_;
+};
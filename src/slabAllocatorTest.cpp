@@ -0,0 +1,74 @@
+#include "slabAllocatorTest.h"
+#include "slabAllocator.h"
+
+#include <list>
+#include <map>
+#include <spdlog/spdlog.h>
+#include "util.h"
+
+namespace {
+
+struct SlabData {
+    char buf[1024]; // 1KB，与 DoTest 的 Data 一致
+};
+
+void LogArena(const char* what, const SlabArena& arena) {
+    SPDLOG_INFO("{} slabs={} reserved={:.2f} MiB", what, arena.slab_count(),
+                arena.reserved_bytes() / (1024.0 * 1024.0));
+}
+
+} // namespace
+
+// 与 DoTest 的 list / map 段相同的检查点，节点改由每容器独立的 slab 提供
+void TestSlabAllocator() {
+    {
+        SPDLOG_INFO("[Begin] Part:slab list test===========");
+        std::list<SlabData, SlabAllocator<SlabData>> l;
+        const SlabArena& arena = *l.get_allocator().arena();
+        for (int i = 0; i < 100000; ++i) {
+            l.emplace_back();
+        }
+        LogArena("slab list 插入10万对象后", arena);
+        pause_for_check("slab list 插入10万对象后");
+
+        // 隔一个删一个：每个 slab 都还有存活节点，理论上一个 slab 都不能归还
+        size_t idx = 0;
+        for (auto it = l.begin(); it != l.end(); ++idx) {
+            it = (idx % 2 == 0) ? l.erase(it) : std::next(it);
+        }
+        LogArena("slab list 隔一个删一个后", arena);
+        pause_for_check("slab list 隔一个删一个后");
+
+        while (!l.empty()) {
+            l.pop_front();
+        }
+        LogArena("slab list pop_front清空后，空 slab 已整块归还系统", arena);
+        pause_for_check("slab list pop_front清空后");
+        SPDLOG_INFO("[End] Part:slab list test===========");
+    }
+
+    {
+        SPDLOG_INFO("[Begin] Part:slab map test===========");
+        std::map<int, SlabData, std::less<int>, SlabAllocator<std::pair<const int, SlabData>>> m;
+        const SlabArena& arena = *m.get_allocator().arena();
+        for (int i = 0; i < 100000; ++i) {
+            m.emplace(i, SlabData{});
+        }
+        LogArena("slab map 插入10万对象后", arena);
+        pause_for_check("slab map 插入10万对象后");
+
+        for (int i = 0; i < 100000; ++i) {
+            m.erase(i);
+        }
+        LogArena("slab map erase所有key后", arena);
+        pause_for_check("slab map 单个erase全部元素后");
+
+        for (int i = 0; i < 100000; ++i) {
+            m.emplace(i, SlabData{});
+        }
+        m.clear();
+        LogArena("slab map 再次插满后 clear()", arena);
+        pause_for_check("slab map clear()后");
+        SPDLOG_INFO("[End] Part:slab map test===========");
+    }
+}
@@ -0,0 +1,280 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include "mappedFile.h"
+
+/**
+ * @brief 元素落盘编解码，按长度前缀记录写入溢出段 / 快照文件
+ *
+ * 可平凡复制的类型直接 memcpy；其它类型需特化本模板，提供：
+ *   static size_t size(const T& v);                       // 编码后的字节数
+ *   static void encode(const T& v, char* out);            // 写入恰好 size(v) 个字节
+ *   static T decode(const char* in, size_t len);          // 从 len 个字节还原
+ * 可选提供：
+ *   static bool valid_length(size_t len);                 // 读取外部文件（快照）时校验记录长度，不合法的记录不交给 decode
+ * 已内置 std::string 的特化；可平凡复制类型的 decode 固定读 sizeof(T) 个字节，因此要求长度恰好为 sizeof(T)。
+ */
+template <typename T>
+struct SpillCodec;
+
+template <typename T>
+    requires std::is_trivially_copyable_v<T>
+struct SpillCodec<T> {
+    static size_t size(const T&) { return sizeof(T); }
+    static void encode(const T& v, char* out) { std::memcpy(out, &v, sizeof(T)); }
+    static T decode(const char* in, size_t) {
+        T v;
+        std::memcpy(&v, in, sizeof(T));
+        return v;
+    }
+    static bool valid_length(size_t len) { return len == sizeof(T); }
+};
+
+template <>
+struct SpillCodec<std::string> {
+    static size_t size(const std::string& v) { return v.size(); }
+    static void encode(const std::string& v, char* out) { std::memcpy(out, v.data(), v.size()); }
+    static std::string decode(const char* in, size_t len) { return std::string(in, len); }
+};
+
+/**
+ * @brief T 是否有可用的 SpillCodec（可平凡复制，或用户提供了特化）
+ */
+template <typename T>
+concept SpillCodable = requires(const T& v, char* out, const char* in) {
+    { SpillCodec<T>::size(v) } -> std::convertible_to<size_t>;
+    SpillCodec<T>::encode(v, out);
+    { SpillCodec<T>::decode(in, size_t{}) } -> std::convertible_to<T>;
+};
+
+/**
+ * @brief 长度为 len 的记录能否交给 SpillCodec<T>::decode：codec 提供 valid_length 时以它为准，否则不限制
+ */
+template <typename T>
+bool SpillLengthValid(size_t len) {
+    if constexpr (requires { { SpillCodec<T>::valid_length(len) } -> std::convertible_to<bool>; }) {
+        return SpillCodec<T>::valid_length(len);
+    } else {
+        return true;
+    }
+}
+
+/**
+ * @brief 溢出到磁盘的参数
+ */
+struct SpillOptions {
+    std::string directory;                          // 段文件所在目录（本地盘），不存在时自动创建
+    size_t memory_limit_bytes = 64ull << 20;        // 队列内存部分超过该估算字节数后，新元素改写到磁盘
+    size_t segment_bytes = 64ull << 20;             // 单个段文件大小；超大元素会单独占一个更大的段
+    size_t refill_batch = 4096;                     // 内存部分取空后，一次从磁盘读回的元素数
+    size_t release_stride = 1ull << 20;             // 每顺序写/读这么多字节，把已经走过的页移出常驻集
+};
+
+/**
+ * @brief 追加写、顺序读的磁盘溢出区，按 FIFO 存取，由所属队列的锁保护（非线程安全）
+ *
+ * 每条记录为 [u32 长度][编码内容]，写进内存映射的段文件；段写满后开新段，读完的段立即关闭并删除。
+ * 写过/读过的页按 release_stride 及时移出常驻集（数据仍在页缓存和文件里），因此常驻内存只有读写游标附近的几页。
+ * T 须满足 SpillCodable（类本身不加约束，便于队列无条件地持有 unique_ptr<SpillStore<T>> 成员）。
+ * 磁盘写失败（目录不可写、空间不足）时，后续元素退回内存中的 fallback_ 尾部暂存，直到溢出区取空，先进先出不受影响。
+ */
+template <typename T>
+class SpillStore {
+public:
+    explicit SpillStore(SpillOptions options) : options_(std::move(options)) {
+        static std::atomic<uint64_t> instance_seq{0};
+        prefix_ = "spill-" + std::to_string(process_id()) + "-" + std::to_string(instance_seq.fetch_add(1)) + "-";
+    }
+
+    ~SpillStore() {
+        while (!segments_.empty()) drop_front_segment();
+    }
+
+    SpillStore(const SpillStore&) = delete;
+    SpillStore& operator=(const SpillStore&) = delete;
+
+    /**
+     * @brief 创建目录，失败返回 false
+     */
+    bool prepare() {
+        std::error_code ec;
+        std::filesystem::create_directories(options_.directory, ec);
+        return std::filesystem::is_directory(options_.directory, ec);
+    }
+
+    /**
+     * @brief 追加到溢出区尾部；写盘失败时放进内存暂存，右值版本直接 move 进去，不做深拷贝
+     */
+    void append(const T& value) {
+        if (fallback_.empty() && write_disk(value)) {
+            ++on_disk_;
+        } else {
+            fallback_.push_back(value);
+        }
+    }
+    void append(T&& value) {
+        if (fallback_.empty() && write_disk(value)) {
+            ++on_disk_;
+        } else {
+            fallback_.push_back(std::move(value));
+        }
+    }
+
+    /**
+     * @brief 按 FIFO 取出至多 max 个元素追加到 out
+     * @param memory_bytes 累加取出元素的内存估算字节（见 memory_bytes_of()）
+     * @return 实际取出的个数
+     */
+    template <typename Out>
+    size_t pop_into(Out& out, size_t max, size_t& memory_bytes) {
+        size_t n = 0;
+        while (n < max && on_disk_ != 0) {
+            Segment& s = segments_.front();
+            if (s.read_off == s.write_off) { // 前面的段已读完（后面一定还有段）
+                drop_front_segment();
+                continue;
+            }
+            uint32_t len;
+            std::memcpy(&len, s.file.data() + s.read_off, sizeof(len));
+            out.push_back(SpillCodec<T>::decode(s.file.data() + s.read_off + sizeof(len), len));
+            memory_bytes += memory_bytes_of(out.back());
+            s.read_off += sizeof(len) + len;
+            --s.unread;
+            --on_disk_;
+            ++n;
+            if (s.read_off - s.released_read >= options_.release_stride) {
+                s.file.release_pages(s.released_read, s.read_off - s.released_read);
+                s.released_read = s.read_off;
+            }
+        }
+        // 磁盘部分取空：删除所有段，下次溢出重新建段
+        if (on_disk_ == 0) {
+            while (!segments_.empty()) drop_front_segment();
+        }
+        while (n < max && !fallback_.empty()) {
+            out.push_back(std::move(fallback_.front()));
+            fallback_.pop_front();
+            memory_bytes += memory_bytes_of(out.back());
+            ++n;
+        }
+        return n;
+    }
+
+    /**
+     * @brief 按 FIFO 顺序遍历溢出区而不取出：磁盘上的记录以原始字节段交给 raw(data, bytes, records)，
+     *        写盘失败暂存在内存里的元素逐个交给 elem(const T&)
+     */
+    template <typename RawFn, typename ElemFn>
+    void visit(RawFn&& raw, ElemFn&& elem) const {
+        for (const Segment& s : segments_) {
+            if (s.unread != 0) raw(s.file.data() + s.read_off, s.write_off - s.read_off, s.unread);
+        }
+        for (const T& v : fallback_) elem(v);
+    }
+
+    /**
+     * @brief 元素在内存中的估算字节：max(sizeof(T), 编码长度)，编码长度近似元素自带的堆内存
+     */
+    static size_t memory_bytes_of(const T& v) {
+        size_t encoded = SpillCodec<T>::size(v);
+        return encoded > sizeof(T) ? encoded : sizeof(T);
+    }
+
+    size_t size() const { return on_disk_ + fallback_.size(); }
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief 当前段文件个数
+     */
+    size_t segments() const { return segments_.size(); }
+
+    /**
+     * @brief 磁盘写失败后暂存在内存里的元素数
+     */
+    size_t fallback_size() const { return fallback_.size(); }
+
+    /**
+     * @brief 累计写入磁盘的元素数
+     */
+    uint64_t total_spilled() const { return total_spilled_; }
+
+    const SpillOptions& options() const { return options_; }
+
+private:
+    struct Segment {
+        MappedFile file;
+        std::string path;
+        size_t write_off = 0;
+        size_t read_off = 0;
+        size_t released_write = 0;
+        size_t released_read = 0;
+        size_t unread = 0; // 本段尚未读出的记录数
+    };
+
+    bool write_disk(const T& value) {
+        const size_t len = SpillCodec<T>::size(value);
+        if (len > UINT32_MAX) return false;
+        const size_t need = sizeof(uint32_t) + len;
+        if (segments_.empty() || segments_.back().write_off + need > segments_.back().file.size()) {
+            if (!open_segment(need)) return false;
+        }
+        Segment& s = segments_.back();
+        const uint32_t len32 = static_cast<uint32_t>(len);
+        std::memcpy(s.file.data() + s.write_off, &len32, sizeof(len32));
+        SpillCodec<T>::encode(value, s.file.data() + s.write_off + sizeof(len32));
+        s.write_off += need;
+        ++s.unread;
+        ++total_spilled_;
+        if (s.write_off - s.released_write >= options_.release_stride) {
+            s.file.release_pages(s.released_write, s.write_off - s.released_write);
+            s.released_write = s.write_off;
+        }
+        return true;
+    }
+
+    bool open_segment(size_t need) {
+        Segment s;
+        s.path = (std::filesystem::path(options_.directory) / (prefix_ + std::to_string(next_segment_++) + ".seg")).string();
+        // 预分配磁盘块：空间不足在建段时就失败，而不是写映射时收到 SIGBUS
+        if (!s.file.create(s.path, need > options_.segment_bytes ? need : options_.segment_bytes, true)) {
+            std::error_code ec;
+            std::filesystem::remove(s.path, ec);
+            return false;
+        }
+        segments_.push_back(std::move(s));
+        return true;
+    }
+
+    void drop_front_segment() {
+        Segment& s = segments_.front();
+        s.file.close();
+        std::error_code ec;
+        std::filesystem::remove(s.path, ec);
+        segments_.pop_front();
+    }
+
+    static uint64_t process_id() {
+#if defined(_WIN32)
+        return ::GetCurrentProcessId();
+#else
+        return static_cast<uint64_t>(::getpid());
+#endif
+    }
+
+    SpillOptions options_;
+    std::string prefix_;
+    std::deque<Segment> segments_;
+    std::deque<T> fallback_;
+    size_t on_disk_ = 0;
+    uint64_t next_segment_ = 0;
+    uint64_t total_spilled_ = 0;
+};
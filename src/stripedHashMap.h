@@ -0,0 +1,201 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "autoShrinkContainers.h"
+#include "cacheLine.h"
+
+/**
+ * @brief 分段锁、按段自动收缩的并发哈希表
+ *
+ * key 按哈希值分到 2 的幂个段，每段一把锁 + 一个 AutoShrinkUnorderedMap。
+ * 每段按自己的 ShrinkPolicy 独立把桶数组缩回去，收缩时只锁住这一段，其它段照常读写，没有全表停顿。
+ * 段对象按 cache line 对齐，相邻段的锁不会伪共享。
+ * 查找返回值拷贝（std::optional<V>），需要原地修改请用 update()/compute()，回调在段锁内执行，不可重入本表。
+ * size()/for_each() 逐段加锁，结果只是快照。
+ */
+template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEq = std::equal_to<K>>
+class StripedHashMap {
+public:
+    /**
+     * @param segments 段数，向上取整为 2 的幂（推荐不少于并发线程数的 2~4 倍）
+     * @param shrink_check_interval 每段每删除多少个元素检查一次是否需要 shrink
+     * @param shrink_factor 段内元素数低于该段 high mark 的 shrink_factor 时收缩
+     */
+    explicit StripedHashMap(size_t segments = 16, size_t shrink_check_interval = 150, float shrink_factor = 0.25f)
+        : segment_count_(std::bit_ceil(segments == 0 ? size_t{1} : segments)),
+          segment_shift_(64 - std::countr_zero(static_cast<uint64_t>(segment_count_))),
+          segments_(std::make_unique<Segment[]>(segment_count_)) {
+        for (size_t i = 0; i < segment_count_; ++i) {
+            segments_[i].map = SegmentMap(ShrinkPolicy(shrink_check_interval, shrink_factor));
+        }
+    }
+
+    StripedHashMap(const StripedHashMap&) = delete;
+    StripedHashMap& operator=(const StripedHashMap&) = delete;
+
+    /**
+     * @return key 不存在并插入成功返回 true，已存在返回 false（不覆盖）
+     */
+    template <typename... Args>
+    bool try_emplace(const K& key, Args&&... args) {
+        Segment& s = segment_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.map.try_emplace(key, std::forward<Args>(args)...).second;
+    }
+    bool insert(const K& key, const V& value) { return try_emplace(key, value); }
+
+    /**
+     * @return 新插入返回 true，覆盖已有值返回 false
+     */
+    template <typename M>
+    bool insert_or_assign(const K& key, M&& value) {
+        Segment& s = segment_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.map.insert_or_assign(key, std::forward<M>(value)).second;
+    }
+
+    std::optional<V> find(const K& key) const {
+        const Segment& s = segment_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.map.find(key);
+        if (it == s.map.end()) return std::nullopt;
+        return it->second;
+    }
+
+    bool contains(const K& key) const {
+        const Segment& s = segment_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.map.contains(key);
+    }
+
+    /**
+     * @brief 存在时在段锁内对值执行 fn(V&)
+     * @return key 是否存在
+     */
+    template <typename F>
+    bool update(const K& key, F&& fn) {
+        Segment& s = segment_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.map.find(key);
+        if (it == s.map.end()) return false;
+        std::forward<F>(fn)(it->second);
+        return true;
+    }
+
+    /**
+     * @brief 不存在时先默认构造插入，再在段锁内执行 fn(V&)
+     */
+    template <typename F>
+    void compute(const K& key, F&& fn) {
+        Segment& s = segment_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        std::forward<F>(fn)(s.map[key]);
+    }
+
+    /**
+     * @return 删除成功返回 true；可能触发该段的收缩
+     */
+    bool erase(const K& key) {
+        Segment& s = segment_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.map.erase(key) != 0;
+    }
+
+    /**
+     * @brief 删除并取出值
+     */
+    std::optional<V> extract(const K& key) {
+        Segment& s = segment_for(key);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto it = s.map.find(key);
+        if (it == s.map.end()) return std::nullopt;
+        std::optional<V> out(std::move(it->second));
+        s.map.erase(key);
+        return out;
+    }
+
+    /**
+     * @brief 逐段清空，每段清空后立即收缩
+     */
+    void clear() {
+        for (size_t i = 0; i < segment_count_; ++i) {
+            std::lock_guard<std::mutex> lock(segments_[i].mutex);
+            segments_[i].map.clear();
+            segments_[i].map.shrink_to_fit();
+        }
+    }
+
+    /**
+     * @brief 逐段加锁遍历 fn(const K&, V&)，同一时刻只锁一段
+     */
+    template <typename F>
+    void for_each(F&& fn) {
+        for (size_t i = 0; i < segment_count_; ++i) {
+            std::lock_guard<std::mutex> lock(segments_[i].mutex);
+            for (auto& kv : segments_[i].map) fn(kv.first, kv.second);
+        }
+    }
+
+    /**
+     * @brief 元素总数，仅做信息快照，不可用于业务并发逻辑
+     */
+    size_t size() const {
+        return sum([](const SegmentMap& m) { return m.size(); });
+    }
+    bool empty() const { return size() == 0; }
+
+    /**
+     * @brief 所有段的桶数之和，仅作为信息描述
+     */
+    size_t bucket_count() const {
+        return sum([](const SegmentMap& m) { return m.bucket_count(); });
+    }
+
+    /**
+     * @brief 所有段累计执行 shrink 的次数，仅作为信息描述
+     */
+    size_t shrink_count() const {
+        return sum([](const SegmentMap& m) { return m.shrink_count(); });
+    }
+
+    size_t segment_count() const { return segment_count_; }
+
+private:
+    using SegmentMap = AutoShrinkUnorderedMap<K, V, Hash, KeyEq>;
+
+    struct alignas(kCacheLineSize) Segment {
+        mutable std::mutex mutex;
+        SegmentMap map;
+    };
+
+    // 段号取混合后哈希的高位，段内 unordered_map 用的是低位，两者互不相关
+    size_t segment_index(const K& key) const {
+        uint64_t h = static_cast<uint64_t>(hasher_(key)) * 0x9E3779B97F4A7C15ull;
+        return segment_count_ == 1 ? 0 : static_cast<size_t>(h >> segment_shift_);
+    }
+    Segment& segment_for(const K& key) { return segments_[segment_index(key)]; }
+    const Segment& segment_for(const K& key) const { return segments_[segment_index(key)]; }
+
+    template <typename F>
+    size_t sum(F&& field) const {
+        size_t total = 0;
+        for (size_t i = 0; i < segment_count_; ++i) {
+            std::lock_guard<std::mutex> lock(segments_[i].mutex);
+            total += field(segments_[i].map);
+        }
+        return total;
+    }
+
+    const size_t segment_count_;
+    const unsigned segment_shift_;
+    std::unique_ptr<Segment[]> segments_;
+    Hash hasher_;
+};
@@ -0,0 +1,400 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "queueNotifier.h"
+#include "shrinkPolicy.h"
+#include "cacheLine.h"
+
+/**
+ * @brief 头尾分锁的阻塞队列（Michael–Scott two-lock queue），分块存储，自动收缩语义与 AutoShrinkBlockingQueue 一致
+ *
+ * 生产者只拿 tail_mutex_，消费者只拿 head_mutex_，两端通过原子计数 count_ 交接：
+ * 生产者构造好元素后 fetch_add(release)，消费者 acquire 读到计数非 0 才去读头部元素。
+ * 队列非空时两端互不等待，MPSC（如 20 生产者 / 1 消费者）下消费者不再排在生产者后面抢同一把锁。
+ * 唤醒按 LinkedBlockingQueue 的做法：只在 0→1 / 满→不满 的边沿去拿对端的锁发通知，其余由同端级联唤醒。
+ *
+ * 存储是单向链接的定长块，元素原地构造；块写满后生产者链上新块，消费者读完一块后把它交回备用链表复用，
+ * 热路径上不会每块都 malloc/free。备用链表在突发过后会囤积到高水位，这就是这里的"容量保留"：
+ * 每 shrink_check_interval 次出队按 ShrinkPolicy 检查一次，低于 high mark 的 shrink_factor 时释放全部备用块。
+ *
+ * T 必须可 move 构造。不提供协程与 eventfd 接口，需要时用 AutoShrinkBlockingQueue。
+ * 注意：size/empty/last_high_mark 仅为快照，不能用于并发逻辑判断
+ */
+template <typename T>
+class TwoLockQueue {
+    static_assert(std::is_move_constructible<T>::value, "TwoLockQueue: T must be move constructible");
+
+public:
+    /**
+     * @brief 每块元素个数，按约 4KB 一块取整（与 libc++ deque 的块大小相当）
+     */
+    static constexpr size_t kChunkElems = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+
+    /**
+     * @param shrink_check_interval 每多少次出队检查一次是否需要 shrink
+     * @param shrink_factor 当前队长低于 high mark 的 shrink_factor 时释放备用块（推荐 0.15~0.25）
+     * @param capacity 队列容量上限，0 表示不限（有界模式下 push 满时阻塞）
+     */
+    explicit TwoLockQueue(size_t shrink_check_interval = 150, float shrink_factor = 0.25f, size_t capacity = 0)
+        : capacity_(capacity), shrink_policy_(shrink_check_interval, shrink_factor) {
+        head_chunk_ = tail_chunk_ = new Chunk;
+    }
+
+    TwoLockQueue(const TwoLockQueue&) = delete;
+    TwoLockQueue& operator=(const TwoLockQueue&) = delete;
+
+    ~TwoLockQueue() {
+        for (size_t n = count_.load(std::memory_order_acquire); n != 0; --n) {
+            advance_head_if_needed();
+            std::destroy_at(head_chunk_->slot(head_idx_++));
+        }
+        free_chain(head_chunk_);
+        free_chain(spare_head_);
+    }
+
+    /**
+     * @brief 线程安全入队，有界模式下队列满时阻塞
+     */
+    void push(const T& value) {
+        emplace(value);
+    }
+    void push(T&& value) {
+        emplace(std::move(value));
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        size_t before;
+        {
+            std::unique_lock<std::mutex> lock(tail_mutex_);
+            if (capacity_ != 0) {
+                cond_not_full_.wait(lock, [this] { return count_.load(std::memory_order_acquire) < capacity_; });
+            }
+            if (tail_idx_ == kChunkElems) {
+                Chunk* c = acquire_chunk();
+                tail_chunk_->next = c;
+                tail_chunk_ = c;
+                tail_idx_ = 0;
+            }
+            ::new (static_cast<void*>(tail_chunk_->slot(tail_idx_))) T(std::forward<Args>(args)...);
+            ++tail_idx_;
+            before = count_.fetch_add(1, std::memory_order_acq_rel);
+            // 有界模式下还有空位，级联唤醒下一个等待的生产者
+            if (capacity_ != 0 && before + 1 < capacity_) cond_not_full_.notify_one();
+        }
+        raise_high_mark(before + 1);
+        if (before == 0) signal_not_empty();
+        notify_external(before == 0);
+    }
+
+    /**
+     * @brief 阻塞直到有数据，线程安全
+     * @note 如果 T 的移动构造抛异常，队列元素将丢失
+     */
+    T pop() {
+        std::unique_lock<std::mutex> lock(head_mutex_);
+        cond_not_empty_.wait(lock, [this] { return count_.load(std::memory_order_acquire) != 0; });
+        size_t before;
+        T value = take_locked(before);
+        if (before > 1) cond_not_empty_.notify_one();
+        lock.unlock();
+        if (capacity_ != 0 && before == capacity_) signal_not_full();
+        return value;
+    }
+
+    /**
+     * @brief 非阻塞尝试出队，线程安全
+     */
+    std::optional<T> try_pop() {
+        std::unique_lock<std::mutex> lock(head_mutex_);
+        if (count_.load(std::memory_order_acquire) == 0) return std::nullopt;
+        size_t before;
+        std::optional<T> value(take_locked(before));
+        if (before > 1) cond_not_empty_.notify_one();
+        lock.unlock();
+        if (capacity_ != 0 && before == capacity_) signal_not_full();
+        return value;
+    }
+
+    /**
+     * @brief 非阻塞批量出队，最多移出 max 个元素写入 out，整批只拿一次 head 锁
+     * @return 实际移出的个数
+     * @note 若因 max 限制未取空队列，会重新触发外部通知器
+     */
+    template <typename OutputIt>
+    size_t drain_into(OutputIt out, size_t max = std::numeric_limits<size_t>::max()) {
+        size_t n = 0;
+        size_t first_before = 0;
+        size_t before = 0;
+        {
+            std::unique_lock<std::mutex> lock(head_mutex_);
+            while (n < max && count_.load(std::memory_order_acquire) != 0) {
+                *out = take_locked(before);
+                ++out;
+                if (n++ == 0) first_before = before;
+            }
+            if (n != 0 && before > 1) cond_not_empty_.notify_one();
+        }
+        if (capacity_ != 0 && n != 0 && first_before == capacity_) signal_not_full();
+        if (n != 0 && before > 1) notify_external(true);
+        return n;
+    }
+
+    /**
+     * @brief 队列当前元素数，仅做信息快照，不可用于业务并发逻辑
+     */
+    size_t size() const {
+        return count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 队列是否为空，仅做信息快照，不可用于业务并发逻辑
+     */
+    bool empty() const {
+        return size() == 0;
+    }
+
+    /**
+     * @brief 返回历史最大队列长度（收缩后归到当时的队长），仅作为信息描述
+     */
+    size_t last_high_mark() const {
+        return high_mark_snapshot_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 累计真正执行 shrink 的次数，仅作为信息描述
+     */
+    size_t shrink_count() const {
+        return shrink_count_snapshot_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 当前囤积的备用块数，仅作为信息描述
+     */
+    size_t spare_chunks() const {
+        std::lock_guard<std::mutex> lock(spare_mutex_);
+        return spare_count_;
+    }
+
+    /**
+     * @brief 立即释放全部备用块（不等 shrink_check_interval），供 ShrinkCoordinator 等外部调度调用
+     * @return 回收的字节数
+     */
+    size_t shrink_to_fit() {
+        std::unique_lock<std::mutex> lock(head_mutex_);
+        return shrink_locked();
+    }
+
+    /**
+     * @brief 收缩能回收的字节数（备用块占用）
+     */
+    size_t reclaimable_bytes() const {
+        return spare_chunks() * sizeof(Chunk);
+    }
+
+    /**
+     * @brief 开关按出队次数触发的自动收缩；关闭后仍记录高水位，收缩交给 shrink_to_fit 的调用方决定
+     */
+    void set_auto_shrink(bool enabled) {
+        std::unique_lock<std::mutex> lock(head_mutex_);
+        auto_shrink_enabled_ = enabled;
+    }
+
+    /**
+     * @brief 运行时调整收缩参数，下一次检查起生效；开启在线调参时调参器会在此基础上继续调整
+     * @param shrink_check_interval 每多少次出队检查一次是否需要 shrink（0 按 1 处理）
+     * @param shrink_factor 当前队长低于 high mark 的 shrink_factor 时触发 shrink（限制在 [0, 1]）
+     */
+    void set_shrink_params(size_t shrink_check_interval, float shrink_factor) {
+        std::unique_lock<std::mutex> lock(head_mutex_);
+        shrink_policy_.set_check_interval(shrink_check_interval);
+        shrink_policy_.set_shrink_factor(shrink_factor);
+    }
+
+    /**
+     * @brief 当前生效的 (check_interval, shrink_factor)
+     */
+    std::pair<size_t, float> shrink_params() const {
+        std::unique_lock<std::mutex> lock(head_mutex_);
+        return {shrink_policy_.check_interval(), shrink_policy_.shrink_factor()};
+    }
+
+    /**
+     * @brief 开启收缩参数的在线调参：按窗口观察收缩耗时与收缩后回涨，在 CPU 预算内尽量早地归还内存，规则见 ShrinkAutoTuner
+     */
+    void enable_shrink_tuning(const ShrinkTuning& tuning = ShrinkTuning()) {
+        std::unique_lock<std::mutex> lock(head_mutex_);
+        shrink_policy_.enable_tuning(tuning);
+    }
+
+    /**
+     * @brief 关闭在线调参，参数停在当前值
+     */
+    void disable_shrink_tuning() {
+        std::unique_lock<std::mutex> lock(head_mutex_);
+        shrink_policy_.disable_tuning();
+    }
+
+    /**
+     * @brief 调参器统计快照，未开启时为空
+     */
+    std::optional<ShrinkTunerStats> shrink_tuner_stats() const {
+        std::unique_lock<std::mutex> lock(head_mutex_);
+        if (const ShrinkAutoTuner* t = shrink_policy_.tuner()) return t->stats();
+        return std::nullopt;
+    }
+
+    /**
+     * @brief 容量上限，0 表示无界
+     */
+    size_t capacity() const { return capacity_; }
+
+    /**
+     * @brief 挂接外部通知器（如 QueueSet 的共享信号），每次入队后回调；传 nullptr 解除挂接
+     */
+    void set_notifier(QueueNotifier* notifier) {
+        notifier_.store(notifier, std::memory_order_release);
+    }
+
+private:
+    struct Chunk {
+        Chunk* next = nullptr;
+        alignas(T) unsigned char storage[sizeof(T) * kChunkElems];
+
+        T* slot(size_t i) { return std::launder(reinterpret_cast<T*>(storage) + i); }
+    };
+
+    // 调用方持 head_mutex_ 且已确认 count_ != 0；before 返回出队前的元素数
+    T take_locked(size_t& before) {
+        advance_head_if_needed();
+        T* p = head_chunk_->slot(head_idx_);
+        T value(std::move(*p));
+        std::destroy_at(p);
+        ++head_idx_;
+        before = count_.fetch_sub(1, std::memory_order_acq_rel);
+        auto_shrink(before);
+        return value;
+    }
+
+    // 当前块已读完时换到下一块；计数非 0 保证生产者已经链好 next（随 count_ 的 release 一起可见）
+    void advance_head_if_needed() {
+        if (head_idx_ != kChunkElems) return;
+        Chunk* done = head_chunk_;
+        head_chunk_ = done->next;
+        head_idx_ = 0;
+        recycle_chunk(done);
+    }
+
+    void auto_shrink(size_t before) {
+        shrink_policy_.on_grow(before);
+        if (shrink_policy_.on_remove(before - 1) && auto_shrink_enabled_) {
+            shrink_locked();
+        }
+    }
+
+    size_t shrink_locked() {
+        Chunk* spares;
+        size_t n;
+        {
+            std::lock_guard<std::mutex> lock(spare_mutex_);
+            spares = std::exchange(spare_head_, nullptr);
+            n = std::exchange(spare_count_, 0);
+        }
+        free_chain(spares);
+        size_t current = count_.load(std::memory_order_relaxed);
+        shrink_policy_.on_shrunk(current);
+        high_mark_snapshot_.store(current, std::memory_order_relaxed);
+        shrink_count_snapshot_.store(shrink_policy_.shrink_count(), std::memory_order_relaxed);
+        return n * sizeof(Chunk);
+    }
+
+    Chunk* acquire_chunk() {
+        {
+            std::lock_guard<std::mutex> lock(spare_mutex_);
+            if (Chunk* c = spare_head_) {
+                spare_head_ = c->next;
+                --spare_count_;
+                c->next = nullptr;
+                return c;
+            }
+        }
+        return new Chunk;
+    }
+
+    void recycle_chunk(Chunk* c) {
+        std::lock_guard<std::mutex> lock(spare_mutex_);
+        c->next = spare_head_;
+        spare_head_ = c;
+        ++spare_count_;
+    }
+
+    static void free_chain(Chunk* c) {
+        while (c) delete std::exchange(c, c->next);
+    }
+
+    // 生产者在锁外抬高高水位；只有超过旧值时才写，稳态下不会反复写这条 cache line
+    void raise_high_mark(size_t size) {
+        size_t cur = high_mark_snapshot_.load(std::memory_order_relaxed);
+        while (size > cur && !high_mark_snapshot_.compare_exchange_weak(cur, size, std::memory_order_relaxed)) {
+        }
+    }
+
+    // 0→1 时才需要拿 head 锁通知，保证与消费者"检查计数后等待"之间不丢唤醒
+    void signal_not_empty() {
+        std::lock_guard<std::mutex> lock(head_mutex_);
+        cond_not_empty_.notify_one();
+    }
+
+    void signal_not_full() {
+        std::lock_guard<std::mutex> lock(tail_mutex_);
+        cond_not_full_.notify_one();
+    }
+
+    void notify_external(bool was_empty) {
+        if (QueueNotifier* n = notifier_.load(std::memory_order_acquire)) {
+            n->notify(was_empty);
+        }
+    }
+
+    // ---- 成员按访问方分组，每组从新的 cache line 开始 ----
+
+    // 读多写少
+    alignas(kCacheLineSize) const size_t capacity_;
+    std::atomic<QueueNotifier*> notifier_{nullptr};
+
+    // 消费者端：只有持 head_mutex_ 者访问
+    alignas(kCacheLineSize) mutable std::mutex head_mutex_;
+    Chunk* head_chunk_ = nullptr;
+    size_t head_idx_ = 0;
+    ShrinkPolicy shrink_policy_;
+    bool auto_shrink_enabled_ = true;
+    std::condition_variable cond_not_empty_;
+
+    // 生产者端：只有持 tail_mutex_ 者访问
+    alignas(kCacheLineSize) std::mutex tail_mutex_;
+    Chunk* tail_chunk_ = nullptr;
+    size_t tail_idx_ = 0;
+    std::condition_variable cond_not_full_;
+
+    // 两端交接的元素数，生产者/消费者各改一次，单独占一行
+    alignas(kCacheLineSize) std::atomic<size_t> count_{0};
+
+    // 备用块链表：每 kChunkElems 个元素才访问一次，单独一把锁
+    alignas(kCacheLineSize) mutable std::mutex spare_mutex_;
+    Chunk* spare_head_ = nullptr;
+    size_t spare_count_ = 0;
+
+    // 信息快照
+    alignas(kCacheLineSize) std::atomic<size_t> high_mark_snapshot_{0};
+    std::atomic<size_t> shrink_count_snapshot_{0};
+};
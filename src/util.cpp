@@ -1,24 +1,44 @@
 #include "util.h"
+#if defined(_WIN32)
 #include <windows.h>
-#include <shlwapi.h>
+#else
+#include <unistd.h>
+#include <climits>
+#endif
 #include <filesystem>
 #include <spdlog/spdlog.h>
 #include <spdlog/async.h>
 #include <spdlog/sinks/hourly_file_sink.h>
 #include <memory>
+#include <mutex>
 #include <string>
-#include <psapi.h>
+#include <sstream>
+#include <iomanip>
 
-// 兼容性的spdlog异步logger创建函数
-std::shared_ptr<spdlog::logger> gain_logger(const std::string& name)
+// 可执行文件全路径，用于把日志目录放在 exe 旁边
+static std::filesystem::path GetModulePath()
 {
-    // 1. 用ANSI/char确保32/64位下都统一
+#if defined(_WIN32)
+    // 用ANSI/char确保32/64位下都统一
     char spath[MAX_PATH] = { 0 };
     // 获取exe全路径（ANSI版，避免TCHAR切换）
     GetModuleFileNameA(nullptr, spath, MAX_PATH);
+    return std::filesystem::path(spath);
+#else
+    char spath[PATH_MAX] = { 0 };
+    ssize_t n = readlink("/proc/self/exe", spath, sizeof(spath) - 1);
+    if (n <= 0) return std::filesystem::current_path() / "stl-test";
+    return std::filesystem::path(std::string(spath, static_cast<size_t>(n)));
+#endif
+}
+
+// 兼容性的spdlog异步logger创建函数
+std::shared_ptr<spdlog::logger> gain_logger(const std::string& name)
+{
+    // 1. 获取exe全路径
+    std::filesystem::path module_path = GetModulePath();
 
     // 2. 转成fs::path，拼出logs目录和日志文件名
-    std::filesystem::path module_path(spath);
     std::filesystem::path log_dir = module_path.parent_path() / "logs";
     if (!std::filesystem::exists(log_dir))
         std::filesystem::create_directories(log_dir);
@@ -33,7 +53,9 @@ std::shared_ptr<spdlog::logger> gain_logger(const std::string& name)
     // 4. 创建异步logger
     auto async_logger = spdlog::create_async<spdlog::sinks::hourly_file_sink_mt>(name, log_path.string());
     //async_logger->set_pattern("%Y-%m-%d %H:%M:%S.%e [%l] %v");
-    async_logger->flush_on(spdlog::level::info);
+    // 只在 warn 及以上立即 flush：flush_on(info) 会让每条 SPDLOG_INFO 都触发一次文件 flush，
+    // 干扰内存/延迟测量；其余由 flush_every 定期刷出，热路径埋点请用 EventLog
+    async_logger->flush_on(spdlog::level::warn);
 
     return async_logger;
 }
@@ -48,50 +70,6 @@ void ResetLoggerPattern()
     spdlog::default_logger()->set_pattern(pattern);
 }
 
-// 内存统计结构体
-struct MemoryStats {
-    double rss_mib = 0.0;    // Resident Set Size (工作集)
-    double commit_mib = 0.0; // Committed Memory (提交内存)
-    size_t page_faults = 0;  // 页面错误计数
-    size_t peak_working_set = 0; // 峰值工作集大小
-};
-
-// 获取内存统计信息
-MemoryStats GetMemoryStats() {
-    MemoryStats stats;
-    
-    PROCESS_MEMORY_COUNTERS_EX pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), 
-                           reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), 
-                           sizeof(pmc))) {
-        // 基础内存信息
-        // 进程当前使用的物理内存（包括共享 DLL 等）
-            // 对应：
-            // mimalloc: rss
-            // 任务管理器: 工作集（Working Set）
-        stats.rss_mib = static_cast<double>(pmc.WorkingSetSize) / (1024 * 1024);
-
-        //  进程私有的虚拟内存（实际已经提交的部分）
-            // 对应：
-            // mimalloc: commit
-            // 任务管理器: 提交大小（Commit Size）
-  
-        // 注意：不是专用工作集，也不是保留虚拟内存，而是实际 已提交使用的虚拟内存。
-        stats.commit_mib = static_cast<double>(pmc.PrivateUsage) / (1024 * 1024);
-        
-        // 附加内存指标
-        stats.page_faults = pmc.PageFaultCount;
-
-        // 峰值工作集大小, 进程生命周期中曾经达到的最大工作集大小
-        stats.peak_working_set = pmc.PeakWorkingSetSize / (1024 * 1024); // MiB
-    } else {
-        DWORD error = GetLastError();
-        SPDLOG_ERROR("GetProcessMemoryInfo failed. Error code: {}", error);
-    }
-    
-    return stats;
-}
-
 // 格式化内存统计信息
 std::string FormatMemoryStats(const MemoryStats& stats) {
     std::ostringstream oss;
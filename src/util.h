@@ -4,6 +4,7 @@
 #include <spdlog/spdlog.h>
 #include <memory>
 #include <string>
+#include "memoryStats.h"
 
 // 兼容性的spdlog异步logger创建函数
 std::shared_ptr<spdlog::logger> gain_logger(const std::string& name);
@@ -1,4 +1,5 @@
 #include "threadSafeQueue.h"
+#include "sequenceStamp.h"
 #include <gtest/gtest.h>
 #include <thread>
 #include <vector>
@@ -128,6 +129,26 @@ TEST(ThreadSafeQueueTest, ProducerConsumerDataIntegrity) {
     EXPECT_TRUE(q.empty());
 }
 
+// ========== 多生产者顺序校验（单生产者内 FIFO） ==========
+TEST(ThreadSafeQueueTest, MultiProducerPerProducerFifo) {
+    constexpr int producer_count = 20;
+    constexpr int per_producer = 5000;
+    ThreadSafeQueue<Stamped<int>> q;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producer_count; ++p) {
+        producers.emplace_back([&q, p] {
+            SequenceStamper stamper(p);
+            for (int i = 0; i < per_producer; ++i) q.push(stamper.stamp(i));
+        });
+    }
+    FifoOrderChecker checker(producer_count, true);
+    for (int i = 0; i < producer_count * per_producer; ++i) checker.check(q.pop());
+    for (auto& th : producers) th.join();
+    EXPECT_EQ(checker.violations(), 0u);
+    EXPECT_TRUE(checker.complete(per_producer));
+    EXPECT_TRUE(q.empty());
+}
+
 // ========== 多线程 try_pop 验证可用性和线程安全性 ==========
 TEST(ThreadSafeQueueTest, TryPopMultiThreaded) {
     ThreadSafeQueue<int> q;
@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include "adapterQueue.h"
+#include "coroExecutor.h"
+
+using namespace std::chrono_literals;
+
+// ========== 辅助协程 ==========
+
+DetachedTask PopOnce(AutoShrinkBlockingQueue<int>& q, CoroExecutor& ex, int& out, bool& done) {
+    out = co_await q.async_pop(ex);
+    done = true;
+}
+
+DetachedTask PushAll(AutoShrinkBlockingQueue<int>& q, CoroExecutor& ex, std::vector<int> values, bool& done) {
+    for (int v : values) co_await q.async_push(v, ex);
+    done = true;
+}
+
+// ========== async_pop ==========
+
+TEST(AutoShrinkAsyncTest, AsyncPopDoesNotSuspendWhenDataReady) {
+    AutoShrinkBlockingQueue<int> q;
+    q.push(7);
+    int out = 0;
+    bool done = false;
+    PopOnce(q, InlineExecutor::instance(), out, done);
+    EXPECT_TRUE(done);
+    EXPECT_EQ(out, 7);
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(AutoShrinkAsyncTest, AsyncPopSuspendsUntilPush) {
+    AutoShrinkBlockingQueue<int> q;
+    int out = 0;
+    bool done = false;
+    PopOnce(q, InlineExecutor::instance(), out, done);
+    EXPECT_FALSE(done);
+    q.push(42); // InlineExecutor：在 push 线程上直接恢复
+    EXPECT_TRUE(done);
+    EXPECT_EQ(out, 42);
+    EXPECT_TRUE(q.empty()); // 元素直接交给等待者，没有进入队列
+}
+
+TEST(AutoShrinkAsyncTest, AsyncWaitersServedInFifoOrder) {
+    AutoShrinkBlockingQueue<int> q;
+    LoopExecutor loop;
+    constexpr int N = 4;
+    int out[N] = {};
+    bool done[N] = {};
+    for (int i = 0; i < N; ++i) PopOnce(q, loop, out[i], done[i]);
+    for (int i = 0; i < N; ++i) q.push(100 + i);
+    EXPECT_EQ(loop.poll(), static_cast<size_t>(N));
+    for (int i = 0; i < N; ++i) {
+        EXPECT_TRUE(done[i]);
+        EXPECT_EQ(out[i], 100 + i);
+    }
+}
+
+TEST(AutoShrinkAsyncTest, AsyncPopMoveOnly) {
+    AutoShrinkBlockingQueue<std::unique_ptr<int>> q;
+    std::unique_ptr<int> out;
+    auto task = [](AutoShrinkBlockingQueue<std::unique_ptr<int>>& q, std::unique_ptr<int>& out) -> DetachedTask {
+        out = co_await q.async_pop();
+    };
+    task(q, out);
+    EXPECT_FALSE(out);
+    q.push(std::make_unique<int>(5));
+    ASSERT_TRUE(out);
+    EXPECT_EQ(*out, 5);
+}
+
+// 一个线程承载大量逻辑消费者
+TEST(AutoShrinkAsyncTest, ThousandsOfConsumersOnOneThread) {
+    AutoShrinkBlockingQueue<int> q;
+    LoopExecutor loop;
+    constexpr int kConsumers = 2000;
+    constexpr int kPerConsumer = 5;
+    std::atomic<int> consumed{0};
+    std::atomic<long long> sum{0};
+
+    auto consumer = [&](int) -> DetachedTask {
+        co_await schedule_on(loop);
+        for (int i = 0; i < kPerConsumer; ++i) {
+            int v = co_await q.async_pop(loop);
+            sum += v;
+            ++consumed;
+        }
+    };
+    for (int i = 0; i < kConsumers; ++i) consumer(i);
+
+    std::thread loop_thread([&]{ loop.run(); });
+    std::thread producer([&]{
+        for (int i = 0; i < kConsumers * kPerConsumer; ++i) q.push(i);
+    });
+    producer.join();
+    while (consumed < kConsumers * kPerConsumer) std::this_thread::sleep_for(1ms);
+    loop.stop();
+    loop_thread.join();
+
+    const long long total = static_cast<long long>(kConsumers) * kPerConsumer;
+    EXPECT_EQ(sum.load(), total * (total - 1) / 2);
+    EXPECT_TRUE(q.empty());
+}
+
+// ========== close ==========
+
+TEST(AutoShrinkAsyncTest, CloseResumesSuspendedWaitersWithError) {
+    AutoShrinkBlockingQueue<int> q(150, 0.25f, 1);
+    int pop_closed = 0, push_closed = 0;
+    auto popper = [&]() -> DetachedTask {
+        try {
+            co_await q.async_pop();
+        } catch (const QueueClosedError&) {
+            ++pop_closed;
+        }
+    };
+    auto pusher = [&](int v) -> DetachedTask {
+        try {
+            co_await q.async_push(v);
+        } catch (const QueueClosedError&) {
+            ++push_closed;
+        }
+    };
+
+    popper(); // 队列为空，挂起
+    q.close();
+    EXPECT_EQ(pop_closed, 1);
+
+    AutoShrinkBlockingQueue<int> full(150, 0.25f, 1);
+    full.push(1);
+    auto full_pusher = [&]() -> DetachedTask {
+        try {
+            co_await full.async_push(2);
+        } catch (const QueueClosedError&) {
+            ++push_closed;
+        }
+    };
+    full_pusher(); // 队满，挂起
+    EXPECT_EQ(push_closed, 0);
+    full.close();
+    EXPECT_EQ(push_closed, 1);
+    EXPECT_EQ(full.pop(), 1); // 已入队的元素保留
+
+    // 关闭后的新请求不挂起，直接以异常结束
+    pusher(3);
+    popper();
+    EXPECT_EQ(push_closed, 2);
+    EXPECT_EQ(pop_closed, 2);
+}
+
+// ========== 有界模式 ==========
+
+TEST(AutoShrinkAsyncTest, BoundedAsyncPushSuspendsWhenFull) {
+    AutoShrinkBlockingQueue<int> q(150, 0.25f, 2);
+    bool done = false;
+    PushAll(q, InlineExecutor::instance(), {1, 2, 3, 4}, done);
+    EXPECT_FALSE(done);
+    EXPECT_EQ(q.size(), 2u);
+
+    EXPECT_EQ(q.pop(), 1); // 腾出空位，挂起的生产者被接纳并恢复
+    EXPECT_EQ(q.size(), 2u);
+    EXPECT_FALSE(done);
+    EXPECT_EQ(q.pop(), 2);
+    EXPECT_TRUE(done);
+    EXPECT_EQ(q.pop(), 3);
+    EXPECT_EQ(q.pop(), 4);
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(AutoShrinkAsyncTest, UnboundedAsyncPushNeverSuspends) {
+    AutoShrinkBlockingQueue<int> q;
+    bool done = false;
+    PushAll(q, InlineExecutor::instance(), {1, 2, 3}, done);
+    EXPECT_TRUE(done);
+    EXPECT_EQ(q.size(), 3u);
+}
+
+TEST(AutoShrinkAsyncTest, BoundedPushBlocksUntilPop) {
+    AutoShrinkBlockingQueue<int> q(150, 0.25f, 1);
+    q.push(1);
+    std::atomic<bool> pushed{false};
+    std::thread t([&]{
+        q.push(2);
+        pushed = true;
+    });
+    std::this_thread::sleep_for(50ms);
+    EXPECT_FALSE(pushed);
+    EXPECT_EQ(q.pop(), 1);
+    t.join();
+    EXPECT_TRUE(pushed);
+    EXPECT_EQ(q.pop(), 2);
+}
+
+TEST(AutoShrinkAsyncTest, BoundedProducerConsumerCoroutines) {
+    AutoShrinkBlockingQueue<int> q(150, 0.25f, 8);
+    LoopExecutor loop;
+    constexpr int N = 10000;
+    std::vector<int> out;
+    bool produced = false, finished = false;
+
+    auto producer = [&]() -> DetachedTask {
+        co_await schedule_on(loop);
+        for (int i = 0; i < N; ++i) co_await q.async_push(i, loop);
+        produced = true;
+    };
+    auto consumer = [&]() -> DetachedTask {
+        co_await schedule_on(loop);
+        for (int i = 0; i < N; ++i) out.push_back(co_await q.async_pop(loop));
+        finished = true;
+        loop.stop();
+    };
+    consumer();
+    producer();
+    loop.run();
+
+    EXPECT_TRUE(produced);
+    EXPECT_TRUE(finished);
+    ASSERT_EQ(out.size(), static_cast<size_t>(N));
+    for (int i = 0; i < N; ++i) EXPECT_EQ(out[i], i);
+    EXPECT_LE(q.last_high_mark(), 8u);
+}
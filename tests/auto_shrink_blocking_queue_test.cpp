@@ -7,7 +7,10 @@
 #include <mutex>
 #include <algorithm>
 #include <optional>
+#include <span>
+#include <deque>
 #include "adapterQueue.h"
+#include "sequenceStamp.h"
 
 using namespace std::chrono_literals;
 
@@ -141,6 +144,63 @@ TEST(AutoShrinkBlockingQueueTest, MultiThreadedTryPopStress) {
     EXPECT_EQ(output.size(), producerN * numPerProducer);
 }
 
+// ========== 多生产者顺序校验（单生产者内 FIFO） ==========
+
+TEST(AutoShrinkBlockingQueueTest, MultiProducerPerProducerFifo) {
+    // 低 interval 让 shrink 在压测过程中频繁发生，确认 shrink 搬迁不打乱顺序
+    AutoShrinkBlockingQueue<Stamped<int>> q(16, 0.5f);
+    constexpr int producerN = 20, numPerProducer = 5000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerN; ++p) {
+        producers.emplace_back([&, p]{
+            SequenceStamper stamper(p);
+            for (int j = 0; j < numPerProducer; ++j) q.push(stamper.stamp(j));
+        });
+    }
+    FifoOrderChecker checker(producerN, true);
+    for (int i = 0; i < producerN * numPerProducer; ++i) {
+        auto s = q.pop();
+        checker.check(s);
+        EXPECT_EQ(s.value, static_cast<int>(s.seq));
+    }
+    for (auto& t : producers) t.join();
+    EXPECT_EQ(checker.violations(), 0u)
+        << "producer " << checker.first_violation_producer()
+        << " expected seq " << checker.first_violation_expected()
+        << " got " << checker.first_violation_seq();
+    EXPECT_TRUE(checker.complete(numPerProducer));
+}
+
+TEST(AutoShrinkBlockingQueueTest, MultiProducerMultiConsumerNoReorder) {
+    AutoShrinkBlockingQueue<Stamped<int>> q(16, 0.5f);
+    constexpr int producerN = 8, consumerN = 4, numPerProducer = 5000;
+    std::vector<std::thread> threads;
+    std::vector<FifoOrderChecker> checkers(consumerN, FifoOrderChecker(producerN));
+    for (int p = 0; p < producerN; ++p) {
+        threads.emplace_back([&, p]{
+            SequenceStamper stamper(p);
+            for (int j = 0; j < numPerProducer; ++j) q.push(stamper.stamp(j));
+        });
+    }
+    std::atomic<int> consumed{0};
+    for (int c = 0; c < consumerN; ++c) {
+        threads.emplace_back([&, c]{
+            while (consumed < producerN * numPerProducer) {
+                if (auto s = q.try_pop()) {
+                    checkers[c].check(*s);
+                    ++consumed;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    for (int c = 1; c < consumerN; ++c) checkers[0].merge(checkers[c]);
+    EXPECT_EQ(checkers[0].violations(), 0u);
+    EXPECT_TRUE(checkers[0].complete(numPerProducer));
+}
+
 // ========== shrink 行为（内存&高水位回收） ==========
 
 // 测试 shrink 能正确归零 high_mark 和队列内容，符合 STL shrink 语义
@@ -213,6 +273,26 @@ TEST(AutoShrinkBlockingQueueTest, EmptyAndSizeThreadSafe) {
     reader.join();
 }
 
+TEST(AutoShrinkBlockingQueueTest, SnapshotsFollowEveryMutation) {
+    AutoShrinkBlockingQueue<int> q(4, 0.75f, 8);
+    for (int i = 0; i < 8; ++i) q.push(i);
+    EXPECT_EQ(q.size(), 8u);
+    EXPECT_EQ(q.last_high_mark(), 8u);
+
+    std::vector<int> out;
+    EXPECT_EQ(q.drain_into(std::back_inserter(out), 6), 6u); // 第 4 个出队时 4 < 8 * 0.75，触发收缩
+    EXPECT_EQ(q.size(), 2u);
+    EXPECT_EQ(q.shrink_count(), 1u);
+    EXPECT_EQ(q.last_high_mark(), 4u);
+
+    q.shrink_to_fit();
+    EXPECT_EQ(q.shrink_count(), 2u);
+    EXPECT_EQ(q.last_high_mark(), 2u);
+    EXPECT_TRUE(q.try_pop().has_value());
+    EXPECT_EQ(q.pop(), 7);
+    EXPECT_TRUE(q.empty());
+}
+
 TEST(AutoShrinkBlockingQueueTest, PopPushAlternating) {
     AutoShrinkBlockingQueue<int> q;
     for (int i = 0; i < 8; ++i) {
@@ -220,4 +300,113 @@ TEST(AutoShrinkBlockingQueueTest, PopPushAlternating) {
         EXPECT_EQ(q.pop(), i);
     }
     EXPECT_TRUE(q.empty());
-}
\ No newline at end of file
+}
+// ========== 有序停机 ==========
+
+TEST(AutoShrinkBlockingQueueTest, CloseRejectsPushAndWakesBlockedPop) {
+    AutoShrinkBlockingQueue<int> q;
+    q.push(1);
+    std::atomic<int> popped{0};
+    std::atomic<bool> closed_seen{false};
+    std::thread consumer([&] {
+        try {
+            for (;;) {
+                q.pop();
+                ++popped;
+            }
+        } catch (const QueueClosedError&) {
+            closed_seen = true;
+        }
+    });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(closed_seen.load());
+    q.close();
+    consumer.join();
+    EXPECT_TRUE(closed_seen.load());
+    EXPECT_EQ(popped.load(), 1); // 关闭前入队的元素照常取走
+    EXPECT_TRUE(q.closed());
+    EXPECT_THROW(q.push(2), QueueClosedError);
+    EXPECT_FALSE(q.try_pop().has_value());
+    q.close(); // 重复关闭无副作用
+}
+
+TEST(AutoShrinkBlockingQueueTest, CloseWakesBoundedPush) {
+    AutoShrinkBlockingQueue<int> q(150, 0.25f, 1);
+    q.push(1);
+    std::atomic<bool> rejected{false};
+    std::thread producer([&] {
+        try {
+            q.push(2);
+        } catch (const QueueClosedError&) {
+            rejected = true;
+        }
+    });
+    std::this_thread::sleep_for(20ms);
+    q.close();
+    producer.join();
+    EXPECT_TRUE(rejected.load());
+    EXPECT_EQ(q.pop(), 1);
+    EXPECT_THROW(q.pop(), QueueClosedError);
+}
+
+TEST(AutoShrinkBlockingQueueTest, DrainHandsBatchesOutsideLock) {
+    AutoShrinkBlockingQueue<std::unique_ptr<int>> q(16, 0.25f);
+    for (int i = 0; i < 1000; ++i) q.push(std::make_unique<int>(i));
+    q.close();
+    std::vector<int> out;
+    size_t batches = 0;
+    size_t total = q.drain([&](std::span<std::unique_ptr<int>> batch) {
+        EXPECT_LE(batch.size(), 64u);
+        ++batches;
+        (void)q.size(); // sink 在锁外执行，可以访问同一队列
+        for (auto& p : batch) out.push_back(*std::move(p));
+    }, 64);
+    EXPECT_EQ(total, 1000u);
+    EXPECT_EQ(batches, 16u);
+    ASSERT_EQ(out.size(), 1000u);
+    for (int i = 0; i < 1000; ++i) EXPECT_EQ(out[i], i);
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.drain([](std::span<std::unique_ptr<int>>) {}), 0u);
+}
+
+TEST(AutoShrinkBlockingQueueTest, DrainIntoRebuildsAtMostOncePerCall) {
+    AutoShrinkBlockingQueue<int> q(16, 0.25f);
+    for (int i = 0; i < 1000; ++i) q.push(i);
+    std::vector<int> out;
+    // 一次取空会越过多个收缩检查点；只重建一次，换下的旧存储在锁外析构
+    EXPECT_EQ(q.drain_into(std::back_inserter(out)), 1000u);
+    EXPECT_EQ(q.shrink_count(), 1u);
+    EXPECT_GT(q.last_high_mark(), 0u);
+    // 推迟的收缩在下一个检查点完成
+    for (int i = 0; i < 16; ++i) {
+        q.push(i);
+        EXPECT_EQ(q.pop(), i);
+    }
+    EXPECT_EQ(q.shrink_count(), 2u);
+    EXPECT_LE(q.last_high_mark(), 1u);
+}
+
+TEST(AutoShrinkBlockingQueueTest, DetachStorageSwapsOutBackingStore) {
+    AutoShrinkBlockingQueue<int> q(150, 0.25f, 4);
+    for (int i = 0; i < 4; ++i) q.push(i);
+    std::atomic<bool> pushed{false};
+    std::thread producer([&] {
+        q.push(100); // 队满阻塞，detach 腾出空位后继续
+        pushed = true;
+    });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(pushed.load());
+
+    std::deque<int> detached = q.detach_storage();
+    producer.join();
+    EXPECT_EQ(detached, (std::deque<int>{0, 1, 2, 3}));
+    EXPECT_TRUE(pushed.load());
+    EXPECT_EQ(q.pop(), 100);
+    EXPECT_EQ(q.last_high_mark(), 1u);
+
+    // 大存储交给后台线程析构
+    for (int i = 0; i < 4; ++i) q.push(i);
+    std::thread reaper([s = q.detach_storage()]() mutable { s.clear(); });
+    reaper.join();
+    EXPECT_TRUE(q.empty());
+}
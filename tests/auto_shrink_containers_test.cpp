@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "autoShrinkContainers.h"
+#include "containerRetention.h"
+
+#include <memory>
+#include <string>
+
+TEST(ShrinkPolicy, ChecksEveryIntervalRemovals) {
+    ShrinkPolicy p(10, 0.25f);
+    p.on_grow(100);
+    EXPECT_EQ(p.high_mark(), 100u);
+    for (int i = 0; i < 9; ++i) EXPECT_FALSE(p.on_remove(10));
+    EXPECT_TRUE(p.on_remove(10));      // 第 10 次删除：10 < 100 * 0.25
+    EXPECT_FALSE(p.on_remove(10, 5));
+    EXPECT_FALSE(p.on_remove(50, 5));  // 到了检查点但 50 >= 25
+    EXPECT_TRUE(p.on_remove(0, 100));  // 批量删除一次计满
+    p.on_shrunk(0);
+    EXPECT_EQ(p.high_mark(), 0u);
+    EXPECT_EQ(p.shrink_count(), 1u);
+}
+
+TEST(AutoShrinkVector, PopBackReleasesCapacity) {
+    AutoShrinkVector<int> v(ShrinkPolicy(100, 0.25f));
+    for (int i = 0; i < 10000; ++i) v.push_back(i);
+    EXPECT_EQ(v.high_mark(), 10000u);
+    while (!v.empty()) v.pop_back();
+    EXPECT_GE(v.shrink_count(), 1u);
+    EXPECT_EQ(v.capacity(), 0u);
+    EXPECT_EQ(v.high_mark(), 0u);
+}
+
+TEST(AutoShrinkVector, ClearShrinksOnce) {
+    AutoShrinkVector<std::string> v;
+    for (int i = 0; i < 1000; ++i) v.emplace_back(64, 'x');
+    v.clear();
+    EXPECT_EQ(v.shrink_count(), 1u);
+    EXPECT_EQ(v.capacity(), 0u);
+}
+
+TEST(AutoShrinkVector, EraseReturnsValidIteratorAcrossShrink) {
+    AutoShrinkVector<int> v(ShrinkPolicy(1, 0.9f));
+    for (int i = 0; i < 100; ++i) v.push_back(i);
+    auto it = v.erase(v.begin(), v.begin() + 90); // 触发收缩
+    EXPECT_EQ(v.shrink_count(), 1u);
+    ASSERT_NE(it, v.end());
+    EXPECT_EQ(*it, 90);
+    EXPECT_EQ(v.capacity(), 10u);
+}
+
+TEST(AutoShrinkVector, EraseIfAndMoveOnly) {
+    AutoShrinkVector<std::unique_ptr<int>> v(ShrinkPolicy(10, 0.5f));
+    for (int i = 0; i < 100; ++i) v.push_back(std::make_unique<int>(i));
+    size_t removed = v.erase_if([](const auto& p) { return *p % 10 != 0; });
+    EXPECT_EQ(removed, 90u);
+    EXPECT_EQ(v.size(), 10u);
+    EXPECT_EQ(v.capacity(), 10u);
+    EXPECT_EQ(*v[3], 30);
+}
+
+TEST(AutoShrinkUnorderedMap, EraseByKeyShrinksBuckets) {
+    AutoShrinkUnorderedMap<int, int> m(ShrinkPolicy(1000, 0.25f));
+    for (int i = 0; i < 100000; ++i) m.emplace(i, i);
+    size_t peak_buckets = m.bucket_count();
+    for (int i = 0; i < 99000; ++i) m.erase(i);
+    EXPECT_GE(m.shrink_count(), 1u);
+    EXPECT_LT(m.bucket_count(), peak_buckets / 10);
+    EXPECT_EQ(m.size(), 1000u);
+    EXPECT_EQ(m.at(99500), 99500);
+}
+
+TEST(AutoShrinkUnorderedMap, IteratorEraseDefersShrink) {
+    AutoShrinkUnorderedMap<int, int> m(ShrinkPolicy(10, 0.25f));
+    for (int i = 0; i < 1000; ++i) m[i] = i;
+    size_t peak_buckets = m.bucket_count();
+    size_t visited = 0;
+    for (auto it = m.begin(); it != m.end();) {
+        it = m.erase(it);
+        ++visited;
+    }
+    EXPECT_EQ(visited, 1000u);
+    EXPECT_EQ(m.shrink_count(), 0u);
+    EXPECT_EQ(m.bucket_count(), peak_buckets);
+    m.erase(-1); // 补上欠下的收缩
+    EXPECT_EQ(m.shrink_count(), 1u);
+    EXPECT_LT(m.bucket_count(), peak_buckets);
+}
+
+TEST(AutoShrinkUnorderedMap, WorksWithRetentionRegistry) {
+    ContainerRetentionRegistry registry;
+    AutoShrinkUnorderedMap<int, int> m(ShrinkPolicy(1000000, 0.25f)); // 策略基本不触发，交给登记表
+    auto h = registry.track("index", m);
+    for (int i = 0; i < 10000; ++i) m.emplace(i, i);
+    for (int i = 0; i < 10000; ++i) m.erase(i);
+    auto top = registry.top(1);
+    ASSERT_EQ(top.size(), 1u);
+    EXPECT_STREQ(top[0].kind, "auto_shrink_unordered_map");
+    EXPECT_GT(registry.shrink_top(1), 0u);
+    EXPECT_EQ(m.shrink_count(), 1u);
+}
@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+#include "adapterQueue.h"
+#include "basicQueue.h"
+#include "threadSafeQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static_assert(std::is_same_v<ThreadSafeQueue<int>,
+                             BasicQueue<int, DequeStorage, MutexLock, CondVarWait, NoShrink, SnapshotStats>>);
+static_assert(std::is_empty_v<NoShrink> && std::is_empty_v<NoStats>);
+static_assert(std::is_base_of_v<BasicQueue<int, SpillDequeStorage, MutexLock, CondVarWait, ShrinkPolicy, SnapshotStats, CoroWaiters>,
+                                AutoShrinkBlockingQueue<int>>);
+
+namespace {
+
+template <typename Q>
+class BasicQueueCompositions : public ::testing::Test {};
+
+using Compositions = ::testing::Types<
+    ThreadSafeQueue<int>,
+    AutoShrinkQueue<int>,
+    BasicQueue<int, RingStorage, MutexLock, CondVarWait, ShrinkPolicy, SnapshotStats>,
+    BasicQueue<int, DequeStorage, SpinLock, CondVarWait, NoShrink, NoStats>,
+    BasicQueue<int, RingStorage, SpinLock, YieldWait, ShrinkPolicy, NoStats>>;
+TYPED_TEST_SUITE(BasicQueueCompositions, Compositions);
+
+} // namespace
+
+TYPED_TEST(BasicQueueCompositions, FifoAndNonBlockingOps) {
+    TypeParam q;
+    EXPECT_FALSE(q.try_pop().has_value());
+    for (int i = 0; i < 1000; ++i) q.push(i);
+    EXPECT_EQ(q.size(), 1000u);
+    for (int i = 0; i < 500; ++i) ASSERT_EQ(q.pop(), i);
+    std::vector<int> out;
+    EXPECT_EQ(q.drain_into(std::back_inserter(out), 100), 100u);
+    EXPECT_EQ(out.front(), 500);
+    for (int i = 600; i < 1000; ++i) ASSERT_EQ(*q.try_pop(), i);
+    EXPECT_TRUE(q.empty());
+}
+
+TYPED_TEST(BasicQueueCompositions, MultiProducerMultiConsumer) {
+    TypeParam q;
+    constexpr int producerN = 4, perProducer = 20000, consumerN = 2;
+    std::atomic<long long> sum{0};
+    std::atomic<int> remaining{producerN * perProducer};
+    std::vector<std::thread> threads;
+    for (int c = 0; c < consumerN; ++c) {
+        threads.emplace_back([&] {
+            while (remaining.fetch_sub(1) > 0) sum += q.pop();
+        });
+    }
+    for (int p = 0; p < producerN; ++p) {
+        threads.emplace_back([&q] {
+            for (int i = 0; i < perProducer; ++i) q.push(i);
+        });
+    }
+    for (auto& t : threads) t.join();
+    EXPECT_EQ(sum.load(), static_cast<long long>(producerN) * perProducer * (perProducer - 1) / 2);
+    EXPECT_TRUE(q.empty());
+}
+
+TYPED_TEST(BasicQueueCompositions, CloseWakesBlockedPop) {
+    TypeParam q;
+    std::thread consumer([&] { EXPECT_THROW(q.pop(), QueueClosedError); });
+    std::this_thread::sleep_for(20ms);
+    q.close();
+    consumer.join();
+    EXPECT_THROW(q.push(1), QueueClosedError);
+}
+
+TEST(BasicQueue, RingStorageShrinksAfterBurst) {
+    BasicQueue<std::string, RingStorage> q(100, 0.25f);
+    for (int i = 0; i < 10000; ++i) q.push(std::to_string(i));
+    EXPECT_EQ(q.last_high_mark(), 10000u);
+    for (int i = 0; i < 9990; ++i) ASSERT_EQ(q.pop(), std::to_string(i));
+    EXPECT_GE(q.shrink_count(), 1u);
+    EXPECT_LT(q.last_high_mark(), 2500u);
+    for (int i = 9990; i < 10000; ++i) ASSERT_EQ(q.pop(), std::to_string(i)); // 重建后环绕位置正确
+    for (int i = 0; i < 100; ++i) q.push(std::to_string(i));
+    for (int i = 0; i < 100; ++i) ASSERT_EQ(q.pop(), std::to_string(i));
+}
+
+TEST(BasicQueue, ShrinkToFitReportsFreedBytes) {
+    BasicQueue<int, RingStorage, MutexLock, CondVarWait, NoShrink> q;
+    for (int i = 0; i < 4096; ++i) q.push(i);
+    while (q.size() > 3) q.pop();
+    EXPECT_EQ(q.shrink_to_fit(), (4096u - 16u) * sizeof(int)); // 剩 3 个，按最小容量 16 重新分配
+    EXPECT_EQ(q.pop(), 4093);
+}
+
+TEST(BasicQueue, BoundedPushBlocksUntilPop) {
+    AutoShrinkQueue<std::unique_ptr<int>> q(150, 0.25f, 2);
+    q.push(std::make_unique<int>(1));
+    q.push(std::make_unique<int>(2));
+    std::atomic<bool> pushed{false};
+    std::thread producer([&] {
+        q.push(std::make_unique<int>(3));
+        pushed = true;
+    });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(pushed.load());
+    EXPECT_EQ(*q.pop(), 1);
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+    EXPECT_EQ(*q.pop(), 2);
+    EXPECT_EQ(*q.pop(), 3);
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "containerRetention.h"
+
+#include <deque>
+#include <list>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+struct Blob { char buf[256]; };
+}
+
+TEST(ContainerRetention, VectorReclaimableIsUnusedCapacity) {
+    std::vector<Blob> v(1000);
+    v.resize(100);
+    ContainerFootprint f = EstimateFootprint(v);
+    EXPECT_EQ(f.elements, 100u);
+    EXPECT_EQ(f.reclaimable(), (v.capacity() - v.size()) * sizeof(Blob));
+    ShrinkContainer(v);
+    EXPECT_EQ(EstimateFootprint(v).reclaimable(), (v.capacity() - v.size()) * sizeof(Blob));
+}
+
+TEST(ContainerRetention, NodeContainersRetainNothing) {
+    std::list<Blob> l(100);
+    std::map<int, Blob> m;
+    for (int i = 0; i < 100; ++i) m.emplace(i, Blob{});
+    EXPECT_EQ(EstimateFootprint(l).reclaimable(), 0u);
+    EXPECT_EQ(EstimateFootprint(m).reclaimable(), 0u);
+    EXPECT_GT(EstimateFootprint(m).used_bytes, 100 * sizeof(Blob));
+}
+
+TEST(ContainerRetention, UnorderedMapBucketsAfterErase) {
+    std::unordered_map<int, int> um;
+    for (int i = 0; i < 100000; ++i) um.emplace(i, i);
+    for (int i = 0; i < 100000; ++i) um.erase(i);
+    ContainerFootprint before = EstimateFootprint(um);
+    EXPECT_GE(before.reclaimable(), 100000 * sizeof(void*) / 2);
+    ShrinkContainer(um);
+    EXPECT_LT(EstimateFootprint(um).allocated_bytes, before.allocated_bytes);
+}
+
+TEST(ContainerRetention, DequeUsesHighWaterMark) {
+    std::deque<Blob> dq;
+    for (int i = 0; i < 10000; ++i) dq.emplace_back();
+    while (!dq.empty()) dq.pop_front();
+    EXPECT_EQ(EstimateFootprint(dq, 0).reclaimable(), 0u);
+    EXPECT_GT(EstimateFootprint(dq, 10000).reclaimable(), 0u); // 至少块指针数组按峰值保留
+}
+
+TEST(ContainerRetention, QueueAdaptorSeesUnderlyingDeque) {
+    std::queue<Blob> q;
+    for (int i = 0; i < 1000; ++i) q.emplace();
+    EXPECT_EQ(EstimateFootprint(q).elements, 1000u);
+    EXPECT_STREQ(ContainerKindName(q), "queue");
+}
+
+TEST(ContainerRetention, RegistryRanksAndShrinksTopWasteful) {
+    ContainerRetentionRegistry registry;
+    std::vector<Blob> big(10000);
+    std::vector<Blob> small(100);
+    std::string s(4096, 'x');
+    std::mutex m;
+    auto h1 = registry.track("big", big, &m);
+    auto h2 = registry.track("small", small);
+    auto h3 = registry.track("string", s);
+    big.clear();
+    small.clear();
+    s.clear();
+
+    auto top = registry.top(2);
+    ASSERT_EQ(top.size(), 2u);
+    EXPECT_EQ(top[0].name, "big");
+    EXPECT_STREQ(top[0].kind, "vector");
+    EXPECT_EQ(top[0].high_water, 0u); // 登记时已满，但 clear 之前没扫描过
+
+    size_t reclaimed = registry.shrink_top(1);
+    EXPECT_EQ(reclaimed, 10000 * sizeof(Blob));
+    EXPECT_EQ(big.capacity(), 0u);
+    EXPECT_GT(small.capacity(), 0u); // 只收缩排第一的
+    EXPECT_EQ(registry.top(10, 10000 * sizeof(Blob)).size(), 0u);
+}
+
+TEST(ContainerRetention, HandleUnregistersOnDestruction) {
+    ContainerRetentionRegistry registry;
+    std::vector<int> v;
+    {
+        auto h = registry.track("v", v);
+        EXPECT_EQ(registry.tracked(), 1u);
+        auto moved = std::move(h);
+        EXPECT_FALSE(h);
+        EXPECT_TRUE(moved);
+        EXPECT_EQ(registry.tracked(), 1u);
+    }
+    EXPECT_EQ(registry.tracked(), 0u);
+}
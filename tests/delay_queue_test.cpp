@@ -0,0 +1,210 @@
+#include <gtest/gtest.h>
+#include "delayQueue.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// 手动推进的时钟：随机测试里直接跳时间，覆盖各层进位与超出覆盖范围的定时器
+struct ManualClock {
+    using duration = std::chrono::nanoseconds;
+    using rep = duration::rep;
+    using period = duration::period;
+    using time_point = std::chrono::time_point<ManualClock>;
+    static constexpr bool is_steady = true;
+    static inline time_point current{};
+    static time_point now() { return current; }
+};
+
+} // namespace
+
+TEST(DelayQueue, PopsInDeadlineOrderNotBeforeDeadline) {
+    DelayQueue<int> q;
+    const auto start = std::chrono::steady_clock::now();
+    q.schedule_after(30ms, 3);
+    q.schedule_after(10ms, 1);
+    q.schedule_after(20ms, 2);
+    q.schedule_after(-5ms, 0); // 已过期
+    EXPECT_EQ(q.size(), 4u);
+    EXPECT_EQ(q.pop(), 0);
+    for (int i = 1; i <= 3; ++i) {
+        EXPECT_EQ(q.pop(), i);
+        EXPECT_GE(std::chrono::steady_clock::now() - start, i * 10ms);
+    }
+    EXPECT_TRUE(q.empty());
+    EXPECT_FALSE(q.try_pop().has_value());
+}
+
+TEST(DelayQueue, CancelIsExactAndStaleIdsAreRejected) {
+    DelayQueue<std::string> q;
+    auto a = q.schedule_after(5ms, "a");
+    auto b = q.schedule_after(5ms, "b");
+    auto far = q.schedule_after(24h, "far"); // 挂在高层槽位
+    EXPECT_TRUE(q.cancel(b));
+    EXPECT_FALSE(q.cancel(b));
+    EXPECT_FALSE(q.cancel(DelayQueue<std::string>::TimerId{}));
+    EXPECT_TRUE(q.cancel(far));
+    EXPECT_EQ(q.pop(), "a");
+    EXPECT_FALSE(q.cancel(a)); // 已出队
+
+    // 节点复用后旧句柄不会取消新定时器
+    auto c = q.schedule_after(1ms, "c");
+    EXPECT_FALSE(q.cancel(a));
+    EXPECT_EQ(q.pop(), "c");
+    EXPECT_FALSE(q.cancel(c));
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(DelayQueue, CascadesAcrossLevels) {
+    // 100us 一格：最低层 25.6ms，第二层 6.5s；跨过若干次第一层进位
+    DelayQueue<int> q(100us);
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<int> delays_ms = {120, 3, 60, 27, 90, 45, 1, 26};
+    for (int d : delays_ms) q.schedule_at(start + std::chrono::milliseconds(d), d);
+    std::sort(delays_ms.begin(), delays_ms.end());
+    for (int d : delays_ms) {
+        EXPECT_EQ(q.pop(), d);
+        EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(d));
+    }
+}
+
+TEST(DelayQueue, EarlierScheduleWakesSleepingConsumer) {
+    DelayQueue<int> q;
+    q.schedule_after(10s, -1);
+    std::atomic<int> got{0};
+    std::thread consumer([&] { got = q.pop(); });
+    std::this_thread::sleep_for(20ms);
+    const auto t0 = std::chrono::steady_clock::now();
+    q.schedule_after(5ms, 7);
+    consumer.join();
+    EXPECT_EQ(got.load(), 7);
+    EXPECT_LT(std::chrono::steady_clock::now() - t0, 2s);
+}
+
+TEST(DelayQueue, ConcurrentProducersAndConsumers) {
+    DelayQueue<int> q;
+    constexpr int producerN = 4, perProducer = 5000;
+    std::atomic<long long> sum{0};
+    std::atomic<int> popped{0};
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < 2; ++c) {
+        consumers.emplace_back([&] {
+            while (popped.fetch_add(1) < producerN * perProducer) sum += q.pop();
+        });
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerN; ++p) {
+        producers.emplace_back([&q] {
+            for (int i = 0; i < perProducer; ++i) {
+                auto id = q.schedule_after(std::chrono::microseconds(i % 3000), i);
+                if (i % 2 == 1) {
+                    // 一半定时器马上取消，再补一个立即到期的，总数不变
+                    if (q.cancel(id)) {
+                        q.schedule_after(0ms, i);
+                    }
+                }
+            }
+        });
+    }
+    for (auto& t : producers) t.join();
+    for (auto& t : consumers) t.join();
+    EXPECT_EQ(sum.load(), static_cast<long long>(producerN) * perProducer * (perProducer - 1) / 2);
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(DelayQueue, ReleasesNodeChunksAfterBurst) {
+    DelayQueue<int> q(1ms, 1000, 0.25f);
+    std::vector<DelayQueue<int>::TimerId> ids;
+    for (int i = 0; i < 100000; ++i) ids.push_back(q.schedule_after(1h, i));
+    const size_t peak = q.node_capacity();
+    EXPECT_GE(peak, 100000u);
+    EXPECT_EQ(q.last_high_mark(), 100000u);
+    for (auto id : ids) ASSERT_TRUE(q.cancel(id)); // 重试超时大多在到期前被取消
+    EXPECT_TRUE(q.empty());
+    EXPECT_GE(q.shrink_count(), 1u);
+    EXPECT_LT(q.node_capacity(), peak / 10);
+
+    // 收缩之后照常使用
+    for (int i = 0; i < 1000; ++i) q.schedule_after(0ms, i);
+    for (int i = 0; i < 1000; ++i) ASSERT_EQ(q.pop(), i);
+    q.shrink_to_fit();
+    EXPECT_EQ(q.node_capacity(), 0u);
+}
+
+TEST(DelayQueue, CloseWakesPopAndDrainHandsOutPending) {
+    DelayQueue<int> q;
+    q.schedule_after(1h, 1);
+    q.schedule_after(2h, 2);
+    q.schedule_after(-1ms, 0);
+    std::thread consumer([&] {
+        EXPECT_EQ(q.pop(), 0);
+        EXPECT_THROW(q.pop(), QueueClosedError); // 阻塞等下一个到期时被 close 唤醒
+    });
+    std::this_thread::sleep_for(20ms);
+    q.close();
+    consumer.join();
+    EXPECT_TRUE(q.closed());
+    EXPECT_THROW(q.schedule_after(1ms, 3), QueueClosedError);
+
+    std::vector<int> rest;
+    EXPECT_EQ(q.drain([&](std::span<int> batch) { rest.insert(rest.end(), batch.begin(), batch.end()); }, 1), 2u);
+    EXPECT_EQ(rest, (std::vector<int>{1, 2}));
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(DelayQueue, MatchesReferenceModelUnderRandomJumps) {
+    ManualClock::current = ManualClock::time_point{};
+    DelayQueue<uint64_t, ManualClock> q(1us, 64, 0.25f);
+    std::mt19937_64 rng(42);
+    std::multimap<int64_t, uint64_t> model; // 到期 tick -> 值
+    std::map<uint64_t, DelayQueue<uint64_t, ManualClock>::TimerId> ids;
+    uint64_t next_value = 0;
+    int64_t now_us = 0;
+    for (int round = 0; round < 3000; ++round) {
+        const int ops = static_cast<int>(rng() % 20);
+        for (int i = 0; i < ops; ++i) {
+            // 延迟跨越 0 ~ 2^36 us，覆盖全部 4 层以及最高层之外
+            const int64_t delay = static_cast<int64_t>(rng() >> (28 + rng() % 36));
+            const uint64_t v = next_value++;
+            ids[v] = q.schedule_at(ManualClock::current + std::chrono::microseconds(delay), v);
+            model.emplace(now_us + delay, v);
+        }
+        if (!ids.empty() && rng() % 3 == 0) {
+            auto it = ids.begin();
+            std::advance(it, static_cast<long>(rng() % ids.size()));
+            ASSERT_TRUE(q.cancel(it->second));
+            for (auto m = model.begin(); m != model.end(); ++m) {
+                if (m->second == it->first) {
+                    model.erase(m);
+                    break;
+                }
+            }
+            ids.erase(it);
+        }
+        const int64_t jump = static_cast<int64_t>(rng() >> (30 + rng() % 34));
+        now_us += jump;
+        ManualClock::current += std::chrono::microseconds(jump);
+        // 到期的全部可取，未到期的一个也不能出来
+        std::vector<uint64_t> got;
+        while (auto v = q.try_pop()) got.push_back(*v);
+        std::vector<uint64_t> expect;
+        while (!model.empty() && model.begin()->first <= now_us) {
+            expect.push_back(model.begin()->second);
+            model.erase(model.begin());
+        }
+        std::sort(got.begin(), got.end());
+        std::sort(expect.begin(), expect.end());
+        ASSERT_EQ(got, expect) << "round " << round;
+        for (uint64_t v : got) ids.erase(v);
+        ASSERT_EQ(q.size(), model.size());
+    }
+}
@@ -0,0 +1,295 @@
+#include <gtest/gtest.h>
+#include "eventLog.h"
+
+#include <cstring>
+#include <filesystem>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <csignal>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string TempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+#if defined(__linux__)
+// 在子进程里把文件大小上限压到 limit 字节后执行 body（返回 0 表示通过），模拟磁盘满/配额导致的扩展失败
+template <typename F>
+int RunWithFileSizeLimit(size_t limit, F body) {
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        std::signal(SIGXFSZ, SIG_IGN); // 超限时让 ftruncate 返回 EFBIG 而不是杀掉进程
+        rlimit rl{static_cast<rlim_t>(limit), static_cast<rlim_t>(limit)};
+        ::setrlimit(RLIMIT_FSIZE, &rl);
+        ::_exit(body());
+    }
+    int status = 0;
+    ::waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+}
+#endif
+
+} // namespace
+
+TEST(MappedFile, CreateResizeAndReadBack) {
+    std::string path = TempPath("mapped_file_test.bin");
+    {
+        MappedFile f;
+        ASSERT_TRUE(f.create(path, 4096));
+        EXPECT_TRUE(f.writable());
+        std::memcpy(f.data(), "hello", 5);
+        ASSERT_TRUE(f.resize(3 * 4096));
+        EXPECT_EQ(f.size(), 3u * 4096);
+        EXPECT_EQ(std::memcmp(f.data(), "hello", 5), 0); // 扩展后原内容保留
+        std::memcpy(f.data() + 2 * 4096, "world", 5);
+        MappedFile moved(std::move(f));
+        EXPECT_FALSE(f.is_open());
+        moved.close(2 * 4096 + 5);
+    }
+    EXPECT_EQ(std::filesystem::file_size(path), 2u * 4096 + 5);
+
+    MappedFile r;
+    ASSERT_TRUE(r.open_read(path));
+    EXPECT_FALSE(r.writable());
+    EXPECT_FALSE(r.resize(8192));
+    EXPECT_EQ(std::memcmp(r.data(), "hello", 5), 0);
+    EXPECT_EQ(std::memcmp(r.data() + 2 * 4096, "world", 5), 0);
+    r.close();
+    std::filesystem::remove(path);
+}
+
+TEST(EventLog, RoundTripWithDeferredFormatting) {
+    std::string path = TempPath("event_log_roundtrip.evlog");
+    EventLog log;
+    uint16_t push = log.register_event("push", "size={} high_mark={}");
+    uint16_t shrink = log.register_event("shrink", "from={} to={}");
+    EXPECT_EQ(log.register_event("push"), push); // 同名返回已有事件号
+
+    EXPECT_FALSE(log.record(push, 1, 2)); // 未启动时不记录
+    ASSERT_TRUE(log.start(path));
+    EXPECT_FALSE(log.start(path));
+    for (uint64_t i = 0; i < 1000; ++i) EXPECT_TRUE(log.record(push, i, i * 2));
+    EXPECT_TRUE(log.record(shrink, 1000, 10));
+    log.flush();
+    EXPECT_EQ(log.flushed_records(), 1001u);
+    log.stop();
+    EXPECT_FALSE(log.running());
+
+    EventLogReader reader;
+    ASSERT_TRUE(reader.open(path));
+    ASSERT_EQ(reader.record_count(), 1001u);
+    EXPECT_EQ(reader.dropped(), 0u);
+    ASSERT_EQ(reader.events().size(), 2u);
+    const EventRecord* recs = reader.records();
+    for (uint64_t i = 0; i < 1000; ++i) {
+        ASSERT_EQ(recs[i].event, push);
+        ASSERT_EQ(recs[i].a, i);
+        ASSERT_EQ(recs[i].b, i * 2);
+        if (i > 0) {
+            ASSERT_GE(recs[i].ts_ns, recs[i - 1].ts_ns);
+        }
+    }
+    EXPECT_STREQ(reader.event_name(recs[1000].event), "shrink");
+    EXPECT_EQ(reader.format_args(recs[1000]), "from=1000 to=10");
+
+    std::ostringstream os;
+    reader.dump(os, 2);
+    EXPECT_NE(os.str().find("push size=1 high_mark=2"), std::string::npos);
+    std::filesystem::remove(path);
+}
+
+TEST(EventLog, RejectsEventsBeyondTheUint16Dictionary) {
+    EventLog log;
+    for (uint32_t i = 0; i < EventLog::kInvalidEvent; ++i) {
+        ASSERT_EQ(log.register_event("ev" + std::to_string(i)), static_cast<uint16_t>(i));
+    }
+    EXPECT_EQ(log.register_event("one-too-many"), EventLog::kInvalidEvent); // 不再回绕成事件 0
+    EXPECT_EQ(log.register_event("ev0"), 0u);
+
+    std::string path = TempPath("event_log_full_dict.evlog");
+    ASSERT_TRUE(log.start(path));
+    EXPECT_FALSE(log.record(EventLog::kInvalidEvent, 1));
+    EXPECT_TRUE(log.record(0, 1));
+    log.stop();
+    EventLogReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(reader.events().size(), static_cast<size_t>(EventLog::kInvalidEvent));
+    EXPECT_EQ(reader.record_count(), 1u);
+    std::filesystem::remove(path);
+}
+
+TEST(EventLog, RejectsNamesAndFormatsLongerThanUint16) {
+    EventLog log;
+    const std::string huge(size_t(UINT16_MAX) + 1, 'x');
+    EXPECT_EQ(log.register_event(huge), EventLog::kInvalidEvent);
+    EXPECT_EQ(log.register_event("long-format", huge), EventLog::kInvalidEvent);
+    uint16_t max_name = log.register_event(std::string(UINT16_MAX, 'n'), "a={}");
+    uint16_t after = log.register_event("after", "b={}");
+    ASSERT_NE(max_name, EventLog::kInvalidEvent);
+    ASSERT_NE(after, EventLog::kInvalidEvent);
+
+    // 长度正好 UINT16_MAX 的名字之后，字典里的其余项仍能正确解析
+    std::string path = TempPath("event_log_long_names.evlog");
+    ASSERT_TRUE(log.start(path));
+    EXPECT_TRUE(log.record(after, 7));
+    log.stop();
+    EventLogReader reader;
+    ASSERT_TRUE(reader.open(path));
+    ASSERT_EQ(reader.events().size(), 2u);
+    ASSERT_EQ(reader.record_count(), 1u);
+    EXPECT_STREQ(reader.event_name(reader.records()[0].event), "after");
+    EXPECT_EQ(reader.format_args(reader.records()[0]), "b=7");
+    std::filesystem::remove(path);
+}
+
+TEST(EventLog, PerThreadRingsKeepProducerOrder) {
+    std::string path = TempPath("event_log_threads.evlog");
+    EventLog log;
+    uint16_t ev = log.register_event("seq", "thread_seq={}");
+    EventLog::Options opt;
+    opt.ring_capacity = 1 << 16;
+    opt.flush_interval = std::chrono::milliseconds(1);
+    opt.file_grow_bytes = 64 * 1024; // 小步扩展，覆盖重新映射的路径
+    ASSERT_TRUE(log.start(path, opt));
+
+    constexpr int kThreads = 4;
+    constexpr uint64_t kPerThread = 50000;
+    std::vector<uint64_t> accepted(kThreads, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (uint64_t i = 0; i < kPerThread; ++i) {
+                if (log.record(ev, i, static_cast<uint64_t>(t))) ++accepted[t];
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    log.stop();
+
+    EventLogReader reader;
+    ASSERT_TRUE(reader.open(path));
+    uint64_t total_accepted = 0;
+    for (auto n : accepted) total_accepted += n;
+    EXPECT_EQ(reader.record_count(), total_accepted);
+    EXPECT_EQ(reader.record_count() + reader.dropped(), kThreads * kPerThread);
+
+    // 同一生产者的记录在文件中保持写入顺序
+    std::vector<int64_t> last(kThreads, -1);
+    std::vector<uint32_t> thread_of(kThreads, 0);
+    for (size_t i = 0; i < reader.record_count(); ++i) {
+        const EventRecord& r = reader.records()[i];
+        ASSERT_LT(r.b, static_cast<uint64_t>(kThreads));
+        ASSERT_GT(static_cast<int64_t>(r.a), last[r.b]);
+        last[r.b] = static_cast<int64_t>(r.a);
+        if (thread_of[r.b] == 0) thread_of[r.b] = r.thread;
+        ASSERT_EQ(thread_of[r.b], r.thread);
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(EventLog, DropsInsteadOfBlockingWhenRingIsFull) {
+    std::string path = TempPath("event_log_drop.evlog");
+    EventLog log;
+    uint16_t ev = log.register_event("burst");
+    EventLog::Options opt;
+    opt.ring_capacity = 64;
+    opt.flush_interval = std::chrono::milliseconds(10000); // 只在 stop 时搬运
+    ASSERT_TRUE(log.start(path, opt));
+    size_t ok = 0;
+    for (int i = 0; i < 1000; ++i) ok += log.record(ev, i) ? 1 : 0;
+    EXPECT_EQ(ok, 64u);
+    EXPECT_EQ(log.dropped(), 1000u - 64u);
+    log.stop();
+
+    EventLogReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_EQ(reader.record_count(), 64u);
+    EXPECT_EQ(reader.dropped(), 1000u - 64u);
+    std::filesystem::remove(path);
+}
+
+TEST(EventLog, RestartGivesThreadsFreshRings) {
+    std::string first = TempPath("event_log_first.evlog");
+    std::string second = TempPath("event_log_second.evlog");
+    EventLog log;
+    uint16_t ev = log.register_event("tick");
+
+    ASSERT_TRUE(log.start(first));
+    EXPECT_TRUE(log.record(ev, 1));
+    log.stop();
+    ASSERT_TRUE(log.start(second));
+    EXPECT_TRUE(log.record(ev, 2));
+    EXPECT_TRUE(log.record(ev, 3));
+    log.stop();
+
+    EventLogReader a, b;
+    ASSERT_TRUE(a.open(first));
+    ASSERT_TRUE(b.open(second));
+    ASSERT_EQ(a.record_count(), 1u);
+    ASSERT_EQ(b.record_count(), 2u);
+    EXPECT_EQ(b.records()[0].a, 2u);
+    EXPECT_EQ(b.records()[0].thread, 1u); // 新会话重新分配线程序号
+    a = EventLogReader();
+    b = EventLogReader();
+    std::filesystem::remove(first);
+    std::filesystem::remove(second);
+}
+
+#if defined(__linux__)
+TEST(MappedFile, FailedResizeKeepsOldMapping) {
+    std::string path = TempPath("mapped_file_resize_fail.bin");
+    int rc = RunWithFileSizeLimit(64 * 1024, [&] {
+        MappedFile f;
+        if (!f.create(path, 4096)) return 1;
+        std::memcpy(f.data(), "hello", 5);
+        if (f.resize(1 << 20)) return 2;
+        if (!f.data() || f.size() != 4096) return 3;
+        if (std::memcmp(f.data(), "hello", 5) != 0) return 4;
+        if (!f.resize(8192) || std::memcmp(f.data(), "hello", 5) != 0) return 5; // 上限以内照常扩展
+        return 0;
+    });
+    EXPECT_EQ(rc, 0);
+    std::filesystem::remove(path);
+}
+
+TEST(EventLog, GrowFailureDropsBatchesAndKeepsFileReadable) {
+    std::string path = TempPath("event_log_grow_fail.evlog");
+    constexpr size_t kLimit = 128 * 1024;
+    int rc = RunWithFileSizeLimit(kLimit, [&] {
+        EventLog log;
+        uint16_t ev = log.register_event("tick", "i={}");
+        EventLog::Options opt;
+        opt.ring_capacity = 1 << 16;
+        opt.file_grow_bytes = 64 * 1024;
+        if (!log.start(path, opt)) return 1;
+        // 分批刷入共 640KB 的记录，远超文件上限：前几批写入，之后的批次扩展失败被丢弃
+        for (uint64_t i = 0; i < 20000; ++i) {
+            log.record(ev, i);
+            if (i % 1000 == 999) log.flush();
+        }
+        log.stop(); // 写字典、更新文件头都不能碰到丢失的映射
+        return 0;
+    });
+    ASSERT_EQ(rc, 0);
+
+    EventLogReader reader;
+    ASSERT_TRUE(reader.open(path));
+    EXPECT_GT(reader.record_count(), 0u);
+    EXPECT_LT(reader.record_count(), 20000u);
+    EXPECT_LE(std::filesystem::file_size(path), kLimit);
+    for (size_t i = 0; i < reader.record_count(); ++i) ASSERT_EQ(reader.records()[i].event, 0u);
+    // 字典要么完整写入，要么不发布
+    EXPECT_TRUE(reader.events().empty() || reader.events().front().name == "tick");
+    reader = EventLogReader();
+    std::filesystem::remove(path);
+}
+#endif
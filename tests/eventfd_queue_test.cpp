@@ -0,0 +1,198 @@
+#if defined(__linux__)
+
+#include <gtest/gtest.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include "adapterQueue.h"
+#include "threadSafeQueue.h"
+
+using namespace std::chrono_literals;
+
+namespace {
+
+bool Readable(int fd, int timeout_ms = 0) {
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+    epoll_event out{};
+    int n = epoll_wait(ep, &out, 1, timeout_ms);
+    close(ep);
+    return n == 1;
+}
+
+// 两种队列的 eventfd 行为完全一致，用模板复用测试体
+template <typename Q>
+void CheckSignalsOnlyOnEmptyToNonEmpty() {
+    Q q;
+    int fd = q.enable_eventfd();
+    ASSERT_GE(fd, 0);
+    EXPECT_EQ(q.fd(), fd);
+    EXPECT_FALSE(Readable(fd));
+
+    for (int i = 0; i < 100; ++i) q.push(i);
+    EXPECT_TRUE(Readable(fd));
+    EXPECT_EQ(q.consume_eventfd(), 1u); // 100 次 push 合并为一次写
+    EXPECT_FALSE(Readable(fd));
+
+    q.push(100); // 队列非空，不触发
+    EXPECT_FALSE(Readable(fd));
+
+    std::vector<int> out;
+    EXPECT_EQ(q.drain_into(std::back_inserter(out)), 101u);
+    EXPECT_EQ(out.front(), 0);
+    EXPECT_EQ(out.back(), 100);
+    EXPECT_TRUE(q.empty());
+
+    q.push(1); // 空→非空，再次触发
+    EXPECT_TRUE(Readable(fd));
+}
+
+template <typename Q>
+void CheckPartialDrainResignals() {
+    Q q;
+    int fd = q.enable_eventfd();
+    for (int i = 0; i < 10; ++i) q.push(i);
+    q.consume_eventfd();
+
+    std::vector<int> out;
+    EXPECT_EQ(q.drain_into(std::back_inserter(out), 4), 4u);
+    EXPECT_TRUE(Readable(fd)); // 还剩 6 个，fd 保持可读
+    q.consume_eventfd();
+    EXPECT_EQ(q.drain_into(std::back_inserter(out), 100), 6u);
+    EXPECT_FALSE(Readable(fd));
+    for (int i = 0; i < 10; ++i) EXPECT_EQ(out[i], i);
+}
+
+template <typename Q>
+void CheckReactorLoopReceivesEverything() {
+    Q q;
+    int fd = q.enable_eventfd();
+    constexpr int kProducers = 4, kPerProducer = 20000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&]{
+            for (int i = 0; i < kPerProducer; ++i) q.push(i);
+        });
+    }
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+
+    std::vector<int> batch;
+    size_t received = 0;
+    while (received < static_cast<size_t>(kProducers) * kPerProducer) {
+        epoll_event out{};
+        int n = epoll_wait(ep, &out, 1, 1000);
+        ASSERT_EQ(n, 1) << "lost wakeup";
+        q.consume_eventfd();
+        batch.clear();
+        received += q.drain_into(std::back_inserter(batch), 256);
+    }
+    close(ep);
+    for (auto& t : producers) t.join();
+    EXPECT_EQ(received, static_cast<size_t>(kProducers) * kPerProducer);
+    EXPECT_TRUE(q.empty());
+}
+
+// 生产者逐个 push，队列频繁在空/非空之间切换，每次 consume 都可能与 signal 交错；
+// 任何一次 epoll_wait 超时都说明唤醒丢了（队列里有元素，fd 却不再可读）
+template <typename Q>
+void CheckConsumeRacingSignalNeverStalls() {
+    Q q;
+    int fd = q.enable_eventfd();
+    constexpr int kItems = 200000;
+    std::thread producer([&] {
+        for (int i = 0; i < kItems; ++i) {
+            q.push(i);
+            if (i % 8 == 0) std::this_thread::yield();
+        }
+    });
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+
+    std::vector<int> batch;
+    int received = 0;
+    bool stalled = false;
+    while (received < kItems) {
+        q.consume_eventfd();
+        batch.clear();
+        received += static_cast<int>(q.drain_into(std::back_inserter(batch)));
+        if (received == kItems) break;
+        epoll_event out{};
+        if (epoll_wait(ep, &out, 1, 2000) == 0) {
+            stalled = true;
+            break;
+        }
+    }
+    close(ep);
+    if (stalled) {
+        // 放掉剩余元素，让生产者能够结束
+        received += static_cast<int>(q.drain_into(std::back_inserter(batch)));
+    }
+    producer.join();
+    EXPECT_FALSE(stalled) << "reactor stalled after " << received << " items";
+}
+
+} // namespace
+
+TEST(EventFdQueueTest, AutoShrinkSignalsOnlyOnEmptyToNonEmpty) {
+    CheckSignalsOnlyOnEmptyToNonEmpty<AutoShrinkBlockingQueue<int>>();
+}
+
+TEST(EventFdQueueTest, ThreadSafeQueueSignalsOnlyOnEmptyToNonEmpty) {
+    CheckSignalsOnlyOnEmptyToNonEmpty<ThreadSafeQueue<int>>();
+}
+
+TEST(EventFdQueueTest, AutoShrinkPartialDrainResignals) {
+    CheckPartialDrainResignals<AutoShrinkBlockingQueue<int>>();
+}
+
+TEST(EventFdQueueTest, ThreadSafeQueuePartialDrainResignals) {
+    CheckPartialDrainResignals<ThreadSafeQueue<int>>();
+}
+
+TEST(EventFdQueueTest, AutoShrinkReactorLoop) {
+    CheckReactorLoopReceivesEverything<AutoShrinkBlockingQueue<int>>();
+}
+
+TEST(EventFdQueueTest, ThreadSafeQueueReactorLoop) {
+    CheckReactorLoopReceivesEverything<ThreadSafeQueue<int>>();
+}
+
+TEST(EventFdQueueTest, AutoShrinkConsumeRacingSignalNeverStalls) {
+    CheckConsumeRacingSignalNeverStalls<AutoShrinkBlockingQueue<int>>();
+}
+
+TEST(EventFdQueueTest, ThreadSafeQueueConsumeRacingSignalNeverStalls) {
+    CheckConsumeRacingSignalNeverStalls<ThreadSafeQueue<int>>();
+}
+
+TEST(EventFdQueueTest, EnableOnNonEmptyQueueIsImmediatelyReadable) {
+    AutoShrinkBlockingQueue<int> q;
+    q.push(1);
+    int fd = q.enable_eventfd();
+    EXPECT_TRUE(Readable(fd));
+}
+
+TEST(EventFdQueueTest, DrainIntoWithoutEventFd) {
+    AutoShrinkBlockingQueue<int> q;
+    EXPECT_EQ(q.fd(), -1);
+    for (int i = 0; i < 5; ++i) q.push(i);
+    std::vector<int> out;
+    EXPECT_EQ(q.drain_into(std::back_inserter(out)), 5u);
+    EXPECT_EQ(out, (std::vector<int>{0, 1, 2, 3, 4}));
+}
+
+#endif // __linux__
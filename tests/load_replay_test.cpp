@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include "loadReplay.h"
+#include "latencyHistogram.h"
+#include "adapterQueue.h"
+#include "threadSafeQueue.h"
+
+using namespace std::chrono_literals;
+
+// ========== 直方图 ==========
+
+TEST(LatencyHistogramTest, ExactForSmallValues) {
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 10; ++v) h.record(v);
+    EXPECT_EQ(h.count(), 10u);
+    EXPECT_EQ(h.percentile(50), 5u);
+    EXPECT_EQ(h.percentile(100), 10u);
+    EXPECT_EQ(h.min(), 1u);
+    EXPECT_EQ(h.max(), 10u);
+    EXPECT_DOUBLE_EQ(h.mean(), 5.5);
+}
+
+TEST(LatencyHistogramTest, RelativeErrorBounded) {
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 100000; ++v) h.record(v * 1000);
+    for (double p : {50.0, 90.0, 99.0, 99.9}) {
+        double exact = p / 100.0 * 100000 * 1000;
+        double got = static_cast<double>(h.percentile(p));
+        EXPECT_GE(got, exact * 0.99) << p;
+        EXPECT_LE(got, exact * 1.07) << p;
+    }
+    EXPECT_EQ(h.percentile(100), 100000u * 1000);
+}
+
+TEST(LatencyHistogramTest, MergeAndEmpty) {
+    LatencyHistogram a, b;
+    EXPECT_EQ(a.percentile(99), 0u);
+    a.record(5);
+    b.record(500);
+    a.merge(b);
+    EXPECT_EQ(a.count(), 2u);
+    EXPECT_EQ(a.max(), 500u);
+    EXPECT_EQ(a.min(), 5u);
+}
+
+// ========== 轨迹生成 ==========
+
+TEST(LoadReplayTest, GeneratorsAreDeterministic) {
+    auto a = GeneratePoissonTrace(10000, 1s, 10us, 42);
+    auto b = GeneratePoissonTrace(10000, 1s, 10us, 42);
+    auto c = GeneratePoissonTrace(10000, 1s, 10us, 43);
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t i = 0; i < a.size(); ++i) {
+        EXPECT_EQ(a[i].arrival_ns, b[i].arrival_ns);
+        EXPECT_EQ(a[i].service_ns, b[i].service_ns);
+    }
+    EXPECT_FALSE(a.size() == c.size() && a.back().arrival_ns == c.back().arrival_ns); // 不同种子不同轨迹
+}
+
+TEST(LoadReplayTest, PoissonRateAndOrdering) {
+    auto t = GeneratePoissonTrace(10000, 2s, 10us, 7);
+    EXPECT_NEAR(static_cast<double>(t.size()), 20000.0, 600.0);
+    for (size_t i = 1; i < t.size(); ++i) EXPECT_LE(t[i - 1].arrival_ns, t[i].arrival_ns);
+    double mean_service = 0;
+    for (auto& e : t) mean_service += static_cast<double>(e.service_ns);
+    mean_service /= static_cast<double>(t.size());
+    EXPECT_NEAR(mean_service, 10000.0, 500.0);
+}
+
+TEST(LoadReplayTest, BurstyConcentratesArrivals) {
+    auto t = GenerateBurstyTrace(1000, 100000, 100ms, 10ms, 1s, 0ns, 7);
+    size_t in_burst = 0;
+    for (auto& e : t) if ((e.arrival_ns % 100'000'000) < 10'000'000) ++in_burst;
+    // 突发窗口占 10% 时间但应包含绝大多数到达
+    EXPECT_GT(in_burst, t.size() * 9 / 10);
+}
+
+TEST(LoadReplayTest, DiurnalPeakAndTrough) {
+    auto t = GenerateDiurnalTrace(10000, 0.9, 1s, 1s, 0ns, 7);
+    size_t first_half = 0;
+    for (auto& e : t) if (e.arrival_ns < 500'000'000) ++first_half;
+    EXPECT_GT(first_half, (t.size() - first_half) * 3); // 正弦前半周期为高峰
+}
+
+TEST(LoadReplayTest, TraceFileRoundTrip) {
+    auto path = (std::filesystem::temp_directory_path() / "load_replay_test_trace.txt").string();
+    ReplayTrace t = {{0, 1000}, {1500, 2000}, {1500, 0}, {90000, 12000}};
+    ASSERT_TRUE(SaveReplayTrace(t, path));
+    auto loaded = LoadReplayTrace(path);
+    ASSERT_TRUE(loaded.has_value());
+    ASSERT_EQ(loaded->size(), t.size());
+    for (size_t i = 0; i < t.size(); ++i) {
+        EXPECT_EQ((*loaded)[i].arrival_ns, t[i].arrival_ns);
+        EXPECT_EQ((*loaded)[i].service_ns, t[i].service_ns);
+    }
+    std::remove(path.c_str());
+    EXPECT_FALSE(LoadReplayTrace(path).has_value());
+}
+
+// ========== 回放 ==========
+
+TEST(LoadReplayTest, ReplayCountsLatencyAndShrinks) {
+    using Item = ReplayItem<64>;
+    auto trace = GenerateBurstyTrace(5000, 200000, 100ms, 20ms, 300ms, 5us, 11);
+    AutoShrinkBlockingQueue<Item> q(50, 0.25f);
+    size_t fake_rss = 1000;
+    ReplayOptions opt;
+    opt.producers = 2;
+    opt.rss_probe = [&] { return fake_rss += 10; };
+    opt.settle_time = 10ms;
+    auto r = RunReplay<Item>(q, trace, opt);
+    EXPECT_EQ(r.elements, trace.size());
+    EXPECT_EQ(r.latency_ns.count(), trace.size());
+    EXPECT_GT(r.throughput, 0);
+    EXPECT_GT(r.shrink_count, 0u);
+    EXPECT_GE(r.peak_rss, r.baseline_rss);
+    EXPECT_TRUE(q.empty());
+
+    ReplayBudget loose;
+    loose.min_throughput = 1;
+    EXPECT_TRUE(CheckReplayBudget(r, loose).empty());
+    ReplayBudget tight;
+    tight.max_p99_ns = 1;
+    EXPECT_EQ(CheckReplayBudget(r, tight).size(), 1u);
+}
+
+TEST(LoadReplayTest, ReplayOnQueueWithoutShrinkCount) {
+    using Item = ReplayItem<16>;
+    auto trace = GeneratePoissonTrace(20000, 100ms, 0ns, 3);
+    ThreadSafeQueue<Item> q;
+    ReplayOptions opt;
+    opt.consumers = 2;
+    opt.settle_time = 0ms;
+    auto r = RunReplay<Item>(q, trace, opt);
+    EXPECT_EQ(r.latency_ns.count(), trace.size());
+    EXPECT_EQ(r.shrink_count, 0u);
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include "queueSet.h"
+
+using namespace std::chrono_literals;
+
+TEST(QueueSetTest, TrySelectOnEmptyReturnsNullopt) {
+    AutoShrinkBlockingQueue<int> a, b;
+    QueueSet<int> set;
+    set.add(a);
+    set.add(b);
+    EXPECT_FALSE(set.try_select().has_value());
+}
+
+TEST(QueueSetTest, SelectReportsSourceQueue) {
+    AutoShrinkBlockingQueue<int> a, b, c;
+    QueueSet<int> set;
+    size_t ia = set.add(a);
+    size_t ib = set.add(b);
+    size_t ic = set.add(c);
+    EXPECT_EQ(set.size(), 3u);
+
+    c.push(30);
+    auto r = set.select();
+    EXPECT_EQ(r.index, ic);
+    EXPECT_EQ(r.value, 30);
+
+    a.push(10);
+    b.push(20);
+    std::map<size_t, int> got;
+    for (int i = 0; i < 2; ++i) {
+        auto s = set.select();
+        got[s.index] = s.value;
+    }
+    EXPECT_EQ(got[ia], 10);
+    EXPECT_EQ(got[ib], 20);
+    EXPECT_FALSE(set.try_select().has_value());
+}
+
+TEST(QueueSetTest, SelectBlocksUntilAnyQueuePushes) {
+    std::vector<std::unique_ptr<AutoShrinkBlockingQueue<int>>> queues;
+    QueueSet<int> set;
+    for (int i = 0; i < 12; ++i) {
+        queues.push_back(std::make_unique<AutoShrinkBlockingQueue<int>>());
+        set.add(*queues.back());
+    }
+    std::atomic<bool> selected{false};
+    QueueSet<int>::Selected result{0, 0};
+    std::thread consumer([&]{
+        result = set.select();
+        selected = true;
+    });
+    std::this_thread::sleep_for(50ms);
+    EXPECT_FALSE(selected);
+    queues[7]->push(777);
+    consumer.join();
+    EXPECT_TRUE(selected);
+    EXPECT_EQ(result.index, 7u);
+    EXPECT_EQ(result.value, 777);
+}
+
+TEST(QueueSetTest, SelectForTimesOut) {
+    AutoShrinkBlockingQueue<int> a;
+    QueueSet<int> set;
+    set.add(a);
+    auto begin = std::chrono::steady_clock::now();
+    auto r = set.select_for(30ms);
+    EXPECT_FALSE(r.has_value());
+    EXPECT_GE(std::chrono::steady_clock::now() - begin, 30ms);
+
+    a.push(1);
+    r = set.select_for(30ms);
+    ASSERT_TRUE(r.has_value());
+    EXPECT_EQ(r->value, 1);
+}
+
+// 两个队列都积压时，按权重比例出队
+TEST(QueueSetTest, WeightedFairness) {
+    AutoShrinkBlockingQueue<int> heavy, light;
+    QueueSet<int> set;
+    size_t ih = set.add(heavy, 3);
+    size_t il = set.add(light, 1);
+    for (int i = 0; i < 100; ++i) {
+        heavy.push(i);
+        light.push(i);
+    }
+    std::map<size_t, int> counts;
+    for (int i = 0; i < 40; ++i) ++counts[set.select().index];
+    EXPECT_EQ(counts[ih], 30);
+    EXPECT_EQ(counts[il], 10);
+}
+
+// 某个队列为空时不会占用份额，其它队列照常服务
+TEST(QueueSetTest, EmptyQueueDoesNotStallOthers) {
+    AutoShrinkBlockingQueue<int> a, b;
+    QueueSet<int> set;
+    set.add(a, 5);
+    size_t ib = set.add(b, 1);
+    for (int i = 0; i < 10; ++i) b.push(i);
+    for (int i = 0; i < 10; ++i) {
+        auto r = set.select();
+        EXPECT_EQ(r.index, ib);
+        EXPECT_EQ(r.value, i); // 单个队列内保持 FIFO
+    }
+}
+
+TEST(QueueSetTest, ManyProducersOneSelectingConsumer) {
+    constexpr int kQueues = 12, kPerQueue = 2000;
+    std::vector<std::unique_ptr<AutoShrinkBlockingQueue<int>>> queues;
+    QueueSet<int> set;
+    for (int i = 0; i < kQueues; ++i) {
+        queues.push_back(std::make_unique<AutoShrinkBlockingQueue<int>>());
+        set.add(*queues.back());
+    }
+    std::vector<std::thread> producers;
+    for (int i = 0; i < kQueues; ++i) {
+        producers.emplace_back([&, i]{
+            for (int j = 0; j < kPerQueue; ++j) queues[i]->push(j);
+        });
+    }
+    std::vector<int> next(kQueues, 0);
+    for (int n = 0; n < kQueues * kPerQueue; ++n) {
+        auto r = set.select();
+        EXPECT_EQ(r.value, next[r.index]);
+        ++next[r.index];
+    }
+    for (auto& t : producers) t.join();
+    for (int i = 0; i < kQueues; ++i) EXPECT_EQ(next[i], kPerQueue);
+    EXPECT_FALSE(set.try_select().has_value());
+}
+
+TEST(QueueSetTest, SelectThrowsOnceAllQueuesClosedAndDrained) {
+    AutoShrinkBlockingQueue<int> a, b;
+    QueueSet<int> set;
+    set.add(a);
+    set.add(b);
+    a.push(1);
+    a.close(); // 关闭但还有剩余元素
+    std::vector<int> got;
+    std::atomic<bool> finished{false};
+    std::thread consumer([&] {
+        try {
+            for (;;) got.push_back(set.select().value);
+        } catch (const QueueClosedError&) {
+            finished = true;
+        }
+    });
+    std::this_thread::sleep_for(30ms);
+    EXPECT_FALSE(finished); // b 还开着，继续阻塞
+    b.push(2);
+    std::this_thread::sleep_for(30ms);
+    EXPECT_FALSE(finished);
+    b.close(); // 最后一个队列关闭，唤醒阻塞中的 select
+    consumer.join();
+    EXPECT_TRUE(finished);
+    EXPECT_EQ(got, (std::vector<int>{1, 2}));
+    EXPECT_THROW(set.select_for(1s), QueueClosedError);
+    EXPECT_FALSE(set.try_select().has_value());
+}
@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "adapterQueue.h"
+#include "queueSnapshot.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+std::string TempPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+struct Order {
+    uint64_t id;
+    double price;
+    int32_t qty;
+};
+
+} // namespace
+
+TEST(QueueSnapshot, RoundTripKeepsOrderAndSourceQueue) {
+    std::string path = TempPath("queue_snapshot_roundtrip.qsnap");
+    AutoShrinkBlockingQueue<std::string> src;
+    for (int i = 0; i < 10000; ++i) src.push("msg-" + std::to_string(i) + std::string(i % 50, 'x'));
+    src.push(std::string()); // 空串也是合法记录
+    ASSERT_TRUE(src.snapshot_to(path));
+    EXPECT_EQ(src.size(), 10001u); // 快照不改变队列
+    EXPECT_FALSE(std::filesystem::exists(path + ".tmp"));
+
+    AutoShrinkBlockingQueue<std::string> dst;
+    dst.push("already-there");
+    ASSERT_TRUE(dst.restore_from(path));
+    EXPECT_EQ(dst.size(), 10002u);
+    EXPECT_EQ(dst.pop(), "already-there"); // 恢复的元素追加在队尾
+    for (int i = 0; i < 10000; ++i) ASSERT_EQ(dst.pop(), "msg-" + std::to_string(i) + std::string(i % 50, 'x'));
+    EXPECT_EQ(dst.pop(), "");
+    EXPECT_TRUE(dst.empty());
+    std::filesystem::remove(path);
+}
+
+TEST(QueueSnapshot, IncludesSpilledElements) {
+    std::string path = TempPath("queue_snapshot_spill.qsnap");
+    std::string dir = TempPath("queue_snapshot_spill_dir");
+    AutoShrinkBlockingQueue<Order> src;
+    SpillOptions o;
+    o.directory = dir;
+    o.memory_limit_bytes = 100 * sizeof(Order);
+    o.segment_bytes = 16 << 10;
+    ASSERT_TRUE(src.enable_spill(o));
+    for (uint64_t i = 0; i < 5000; ++i) src.push(Order{i, 1.5 * static_cast<double>(i), static_cast<int32_t>(i % 7)});
+    ASSERT_GT(src.spilled(), 0u);
+    for (int i = 0; i < 10; ++i) src.pop(); // 溢出段的读游标不在起点
+    ASSERT_TRUE(src.snapshot_to(path));
+
+    AutoShrinkBlockingQueue<Order> dst;
+    ASSERT_TRUE(dst.restore_from(path));
+    EXPECT_EQ(dst.size(), 4990u);
+    for (uint64_t i = 10; i < 5000; ++i) {
+        Order got = dst.pop();
+        ASSERT_EQ(got.id, i);
+        ASSERT_EQ(got.qty, static_cast<int32_t>(i % 7));
+    }
+    std::filesystem::remove(path);
+    std::filesystem::remove_all(dir);
+}
+
+TEST(QueueSnapshot, UnwritablePathReturnsFalseAndKeepsQueue) {
+    AutoShrinkBlockingQueue<int> q;
+    for (int i = 0; i < 3; ++i) q.push(i);
+    EXPECT_FALSE(q.snapshot_to(TempPath("queue_snapshot_missing_dir/x.qsnap")));
+    EXPECT_EQ(q.size(), 3u);
+    for (int i = 0; i < 3; ++i) EXPECT_EQ(q.pop(), i);
+}
+
+TEST(QueueSnapshot, RejectsMissingCorruptOrOversizedSnapshots) {
+    std::string path = TempPath("queue_snapshot_corrupt.qsnap");
+    AutoShrinkBlockingQueue<int> q;
+    EXPECT_FALSE(q.restore_from(TempPath("queue_snapshot_missing.qsnap")));
+
+    AutoShrinkBlockingQueue<int> src;
+    for (int i = 0; i < 100; ++i) src.push(i);
+    ASSERT_TRUE(src.snapshot_to(path));
+
+    AutoShrinkBlockingQueue<int> small(150, 0.25f, 50);
+    EXPECT_FALSE(small.restore_from(path)); // 有界模式放不下，整批拒绝
+    EXPECT_TRUE(small.empty());
+
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3); // 截断最后一条记录
+    EXPECT_FALSE(q.restore_from(path));
+    EXPECT_TRUE(q.empty());
+    std::filesystem::remove(path);
+}
+
+TEST(QueueSnapshot, RejectsRecordWithWrongLengthForTrivialCodec) {
+    std::string path = TempPath("queue_snapshot_bad_len.qsnap");
+    AutoShrinkBlockingQueue<uint64_t> src;
+    for (uint64_t i = 0; i < 4; ++i) src.push(i);
+    ASSERT_TRUE(src.snapshot_to(path));
+
+    // 把最后一条记录改成 2 字节长并同步截断文件与头部：结构自洽，但长度小于 sizeof(uint64_t)，
+    // 按 sizeof(T) 解码会读出记录之外（文件末尾则是映射之外）
+    const size_t size = std::filesystem::file_size(path);
+    const size_t last = size - sizeof(uint64_t) - sizeof(uint32_t);
+    {
+        std::FILE* f = std::fopen(path.c_str(), "r+b");
+        ASSERT_NE(f, nullptr);
+        uint32_t len = 2;
+        std::fseek(f, static_cast<long>(last), SEEK_SET);
+        std::fwrite(&len, sizeof(len), 1, f);
+        uint64_t payload = size - 6 - 32;
+        std::fseek(f, 24, SEEK_SET); // FileHeader::payload_bytes
+        std::fwrite(&payload, sizeof(payload), 1, f);
+        std::fclose(f);
+    }
+    std::filesystem::resize_file(path, size - 6);
+
+    AutoShrinkBlockingQueue<uint64_t> dst;
+    EXPECT_FALSE(dst.restore_from(path));
+    EXPECT_TRUE(dst.empty());
+    std::filesystem::remove(path);
+}
+
+TEST(QueueSnapshot, RestoreWakesBlockedConsumer) {
+    std::string path = TempPath("queue_snapshot_wake.qsnap");
+    {
+        AutoShrinkBlockingQueue<int> src;
+        for (int i = 1; i <= 3; ++i) src.push(i);
+        ASSERT_TRUE(src.snapshot_to(path));
+    }
+    AutoShrinkBlockingQueue<int> q;
+    std::atomic<int> sum{0};
+    std::thread consumer([&] {
+        for (int i = 0; i < 3; ++i) sum += q.pop();
+    });
+    std::this_thread::sleep_for(20ms);
+    ASSERT_TRUE(q.restore_from(path));
+    consumer.join();
+    EXPECT_EQ(sum.load(), 6);
+    std::filesystem::remove(path);
+}
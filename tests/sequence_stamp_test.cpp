@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <memory>
+#include "sequenceStamp.h"
+
+TEST(SequenceStampTest, StamperNumbersPerProducer) {
+    SequenceStamper a(0), b(1);
+    auto a0 = a.stamp(10);
+    auto a1 = a.stamp(11);
+    auto b0 = b.stamp(20);
+    EXPECT_EQ(a0.producer_id, 0u);
+    EXPECT_EQ(a0.seq, 0u);
+    EXPECT_EQ(a1.seq, 1u);
+    EXPECT_EQ(a1.value, 11);
+    EXPECT_EQ(b0.producer_id, 1u);
+    EXPECT_EQ(b0.seq, 0u);
+    EXPECT_EQ(a.stamped(), 2u);
+}
+
+TEST(SequenceStampTest, GlobalCounterSharedAcrossProducers) {
+    std::atomic<uint64_t> global{0};
+    SequenceStamper a(0, &global), b(1, &global);
+    EXPECT_EQ(a.stamp(1).global_seq, 0u);
+    EXPECT_EQ(b.stamp(2).global_seq, 1u);
+    EXPECT_EQ(a.stamp(3).global_seq, 2u);
+}
+
+TEST(SequenceStampTest, StampMoveOnlyValue) {
+    SequenceStamper s(3);
+    auto st = s.stamp(std::make_unique<int>(7));
+    ASSERT_TRUE(st.value);
+    EXPECT_EQ(*st.value, 7);
+}
+
+TEST(SequenceStampTest, CheckerAcceptsInterleavedProducers) {
+    FifoOrderChecker c(2, true);
+    EXPECT_TRUE(c.check(0, 0));
+    EXPECT_TRUE(c.check(1, 0));
+    EXPECT_TRUE(c.check(0, 1));
+    EXPECT_TRUE(c.check(1, 1));
+    EXPECT_EQ(c.violations(), 0u);
+    EXPECT_TRUE(c.complete(2));
+}
+
+TEST(SequenceStampTest, CheckerDetectsReorder) {
+    FifoOrderChecker c(1);
+    EXPECT_TRUE(c.check(0, 0));
+    EXPECT_TRUE(c.check(0, 2));
+    EXPECT_FALSE(c.check(0, 1)); // 1 在 2 之后到达
+    EXPECT_EQ(c.violations(), 1u);
+    EXPECT_EQ(c.first_violation_expected(), 3u);
+    EXPECT_EQ(c.first_violation_seq(), 1u);
+}
+
+TEST(SequenceStampTest, CheckerDetectsDuplicate) {
+    FifoOrderChecker c(1);
+    EXPECT_TRUE(c.check(0, 0));
+    EXPECT_FALSE(c.check(0, 0));
+    EXPECT_FALSE(c.complete(1));
+}
+
+TEST(SequenceStampTest, NonContiguousAllowsGapsContiguousDoesNot) {
+    FifoOrderChecker relaxed(1), strict(1, true);
+    EXPECT_TRUE(relaxed.check(0, 0));
+    EXPECT_TRUE(relaxed.check(0, 5));
+    EXPECT_TRUE(strict.check(0, 0));
+    EXPECT_FALSE(strict.check(0, 5)); // 单消费者下跳号即丢失
+}
+
+TEST(SequenceStampTest, CheckerRejectsUnknownProducer) {
+    FifoOrderChecker c(2);
+    EXPECT_FALSE(c.check(5, 0));
+    EXPECT_EQ(c.violations(), 1u);
+}
+
+TEST(SequenceStampTest, MergeAggregatesConsumers) {
+    FifoOrderChecker c1(2), c2(2);
+    c1.check(0, 0); c1.check(1, 1);
+    c2.check(0, 1); c2.check(1, 0);
+    EXPECT_FALSE(c1.complete(2));
+    c1.merge(c2);
+    EXPECT_TRUE(c1.complete(2));
+    EXPECT_EQ(c1.received(0), 2u);
+}
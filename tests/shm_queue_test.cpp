@@ -0,0 +1,148 @@
+#if defined(__linux__)
+
+#include <gtest/gtest.h>
+#include "shmQueue.h"
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Tick {
+    uint32_t producer;
+    uint32_t seq;
+    char payload[56];
+};
+
+// 每个用例用带 pid 的名字，结束时 shm_unlink
+class ShmName {
+public:
+    explicit ShmName(const char* tag) : name_("/shm_queue_test_" + std::string(tag) + "_" + std::to_string(::getpid())) {
+        ShmQueue<Tick>::remove(name_);
+    }
+    ~ShmName() { ShmQueue<Tick>::remove(name_); }
+    const std::string& str() const { return name_; }
+
+private:
+    std::string name_;
+};
+
+// 子进程：映射同名队列后推 n 个元素，退出码表示是否成功
+pid_t ForkProducer(const std::string& name, uint32_t producer, uint32_t n) {
+    pid_t pid = ::fork();
+    if (pid == 0) {
+        ShmQueue<Tick> q;
+        if (!q.open(name)) ::_exit(2);
+        for (uint32_t i = 0; i < n; ++i) q.push(Tick{producer, i, {}});
+        ::_exit(0);
+    }
+    return pid;
+}
+
+bool ChildSucceeded(pid_t pid) {
+    int status = 0;
+    return ::waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+} // namespace
+
+TEST(ShmQueue, CreateOpenAndValidate) {
+    ShmName name("open");
+    ShmQueue<Tick> q;
+    ASSERT_TRUE(q.create(name.str(), 1000));
+    EXPECT_EQ(q.capacity(), 1024u); // 向上取整到 2 的幂
+    ShmQueue<Tick> dup;
+    EXPECT_FALSE(dup.create(name.str(), 16)); // 同名已存在
+
+    ShmQueue<Tick> other;
+    ASSERT_TRUE(other.open(name.str()));
+    EXPECT_TRUE(other.try_push(Tick{1, 7, {}}));
+    EXPECT_EQ(q.size(), 1u);
+    auto got = q.try_pop();
+    ASSERT_TRUE(got.has_value());
+    EXPECT_EQ(got->seq, 7u);
+    EXPECT_FALSE(q.try_pop().has_value());
+
+    ShmQueue<uint64_t> wrong_type;
+    EXPECT_FALSE(wrong_type.open(name.str())); // 元素大小不符
+    ShmQueue<Tick> missing;
+    EXPECT_FALSE(missing.open(name.str() + "_missing"));
+}
+
+TEST(ShmQueue, CrossProcessHandoffKeepsFifo) {
+    ShmName name("spsc");
+    ShmQueue<Tick> q;
+    ASSERT_TRUE(q.create(name.str(), 256)); // 远小于总量，生产者会在满时阻塞
+    constexpr uint32_t n = 100000;
+    pid_t child = ForkProducer(name.str(), 0, n);
+    ASSERT_GT(child, 0);
+    for (uint32_t i = 0; i < n; ++i) {
+        Tick t = q.pop();
+        ASSERT_EQ(t.seq, i);
+    }
+    EXPECT_TRUE(ChildSucceeded(child));
+    EXPECT_TRUE(q.empty());
+}
+
+TEST(ShmQueue, MultipleProducerProcesses) {
+    ShmName name("mpsc");
+    ShmQueue<Tick> q;
+    ASSERT_TRUE(q.create(name.str(), 1024));
+    constexpr uint32_t producerN = 4, perProducer = 20000;
+    std::vector<pid_t> children;
+    for (uint32_t p = 0; p < producerN; ++p) children.push_back(ForkProducer(name.str(), p, perProducer));
+
+    std::vector<uint32_t> next(producerN, 0);
+    for (uint32_t i = 0; i < producerN * perProducer; ++i) {
+        auto t = q.pop_for(10s);
+        ASSERT_TRUE(t.has_value());
+        ASSERT_LT(t->producer, producerN);
+        ASSERT_EQ(t->seq, next[t->producer]++); // 单生产者内 FIFO
+    }
+    for (pid_t c : children) EXPECT_TRUE(ChildSucceeded(c));
+    EXPECT_FALSE(q.pop_for(10ms).has_value());
+}
+
+TEST(ShmQueue, ShrinkPunchesHolesInFreeSlots) {
+    ShmName name("shrink");
+    ShmQueue<Tick> q;
+    ASSERT_TRUE(q.create(name.str(), 1 << 16, 1 << 30)); // 关掉自动收缩，手动触发
+    const size_t idle = q.allocated_bytes();
+    for (uint32_t i = 0; i < (1u << 16); ++i) ASSERT_TRUE(q.try_push(Tick{0, i, {}}));
+    EXPECT_FALSE(q.try_push(Tick{}));
+    const size_t burst = q.allocated_bytes();
+    EXPECT_GE(burst, idle + (1u << 16) * sizeof(Tick));
+    EXPECT_EQ(q.last_high_mark(), 1u << 16);
+
+    for (uint32_t i = 0; i < (1u << 16) - 10; ++i) ASSERT_EQ(q.try_pop()->seq, i);
+    const size_t punched = q.shrink_to_fit();
+    EXPECT_GT(punched, ((1u << 16) - 100) * sizeof(Tick));
+    EXPECT_LE(q.allocated_bytes(), burst - punched);
+    EXPECT_EQ(q.shrink_count(), 1u);
+    EXPECT_EQ(q.last_high_mark(), 10u);
+
+    // 打洞后剩余元素完好，空闲槽位可以继续使用
+    for (uint32_t i = (1u << 16) - 10; i < (1u << 16); ++i) ASSERT_EQ(q.try_pop()->seq, i);
+    for (uint32_t i = 0; i < 1000; ++i) ASSERT_TRUE(q.try_push(Tick{1, i, {}}));
+    for (uint32_t i = 0; i < 1000; ++i) ASSERT_EQ(q.try_pop()->seq, i);
+}
+
+TEST(ShmQueue, AutoShrinkAfterBurstDrains) {
+    ShmName name("auto");
+    ShmQueue<Tick> q;
+    ASSERT_TRUE(q.create(name.str(), 1 << 15, 1000, 0.25f));
+    for (uint32_t i = 0; i < (1u << 15); ++i) ASSERT_TRUE(q.try_push(Tick{0, i, {}}));
+    const size_t burst = q.allocated_bytes();
+    while (q.try_pop()) {
+    }
+    EXPECT_GE(q.shrink_count(), 1u);
+    EXPECT_LT(q.allocated_bytes(), burst / 2);
+}
+
+#endif // __linux__
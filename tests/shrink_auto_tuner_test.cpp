@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "adapterQueue.h"
+#include "basicQueue.h"
+#include "shrinkPolicy.h"
+#include "twoLockQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+// 每次检查都结束一个窗口，不设 CPU 上限：结果只取决于回涨与空闲内存，和机器快慢无关
+ShrinkTuning EveryCheckTuning() {
+    ShrinkTuning t;
+    t.window = 0ns;
+    t.cpu_budget = 1.0;
+    return t;
+}
+
+// 涨到 peak 再逐个删空，按策略要求收缩
+void GrowThenDrain(ShrinkPolicy& p, size_t peak) {
+    for (size_t i = 1; i <= peak; ++i) p.on_grow(i);
+    for (size_t size = peak; size-- > 0;) {
+        if (p.on_remove(size)) p.on_shrunk(size);
+    }
+}
+
+} // namespace
+
+TEST(ShrinkPolicy, RuntimeSettersTakeEffectAtNextCheck) {
+    ShrinkPolicy p(100, 0.25f);
+    p.on_grow(100);
+    p.set_check_interval(2);
+    p.set_shrink_factor(0.6f);
+    EXPECT_FALSE(p.on_remove(50));
+    EXPECT_TRUE(p.on_remove(50)); // 第 2 次删除：50 < 100 * 0.6
+    p.set_check_interval(0);
+    p.set_shrink_factor(3.0f);
+    EXPECT_EQ(p.check_interval(), 1u);
+    EXPECT_EQ(p.shrink_factor(), 1.0f);
+    EXPECT_EQ(p.tuner(), nullptr);
+}
+
+TEST(ShrinkAutoTuner, BacksOffWhenShrunkMemoryIsRegrown) {
+    ShrinkPolicy p(16, 0.5f);
+    p.enable_tuning(EveryCheckTuning());
+    // 每轮刚收缩完又涨回峰值：收缩全被抵消
+    for (int round = 0; round < 20; ++round) GrowThenDrain(p, 1000);
+    ASSERT_NE(p.tuner(), nullptr);
+    EXPECT_GT(p.tuner()->stats().adjustments, 0u);
+    EXPECT_GT(p.check_interval(), 16u);
+    EXPECT_LT(p.shrink_factor(), 0.5f);
+
+    // 拷贝带走调参器状态
+    ShrinkPolicy copy = p;
+    ASSERT_NE(copy.tuner(), nullptr);
+    EXPECT_EQ(copy.tuner()->stats().windows, p.tuner()->stats().windows);
+    p.disable_tuning();
+    EXPECT_EQ(p.tuner(), nullptr);
+    EXPECT_NE(copy.tuner(), nullptr);
+}
+
+TEST(ShrinkAutoTuner, TightensWhenIdleMemoryIsHeld) {
+    // 降到峰值的 30% 后稳定：固定 0.25 的阈值永远不会触发，峰值的七成一直闲置
+    auto run = [](ShrinkPolicy& p) {
+        for (size_t i = 1; i <= 10000; ++i) p.on_grow(i);
+        size_t size = 10000;
+        while (size > 3000) {
+            --size;
+            if (p.on_remove(size)) p.on_shrunk(size);
+        }
+        for (int i = 0; i < 2000; ++i) {
+            p.on_grow(size + 1);
+            if (p.on_remove(size)) p.on_shrunk(size);
+        }
+    };
+    ShrinkPolicy fixed(64, 0.25f);
+    run(fixed);
+    EXPECT_EQ(fixed.shrink_count(), 0u);
+    EXPECT_EQ(fixed.high_mark(), 10000u);
+
+    ShrinkPolicy tuned(64, 0.25f);
+    tuned.enable_tuning(EveryCheckTuning());
+    run(tuned);
+    EXPECT_GE(tuned.shrink_count(), 1u);
+    EXPECT_LE(tuned.high_mark(), 5000u);
+    EXPECT_GT(tuned.shrink_factor(), 0.25f);
+    EXPECT_LT(tuned.check_interval(), 64u);
+}
+
+TEST(ShrinkAutoTuner, BacksOffWhenShrinkTimeExceedsBudget) {
+    AutoShrinkBlockingQueue<int> q(16, 0.25f);
+    ShrinkTuning t;
+    t.window = 0ns;
+    t.cpu_budget = 1e-9; // 任何一次收缩都超预算
+    q.enable_shrink_tuning(t);
+    for (int i = 0; i < 20000; ++i) {
+        q.push(i);
+        ASSERT_EQ(q.pop(), i); // 每次检查时队列为空，都会收缩
+    }
+    auto [interval, factor] = q.shrink_params();
+    EXPECT_GT(interval, 16u);
+    EXPECT_LT(factor, 0.25f);
+    auto stats = q.shrink_tuner_stats();
+    ASSERT_TRUE(stats.has_value());
+    EXPECT_GT(stats->adjustments, 0u);
+    // 间隔翻倍后收缩次数远少于 20000 / 16
+    EXPECT_LT(q.shrink_count(), 200u);
+
+    q.disable_shrink_tuning();
+    EXPECT_FALSE(q.shrink_tuner_stats().has_value());
+    EXPECT_EQ(q.shrink_params(), std::make_pair(interval, factor));
+}
+
+TEST(ShrinkAutoTuner, ParamsCanBeChangedWhileQueueIsBusy) {
+    TwoLockQueue<int> q(150, 0.25f);
+    AutoShrinkQueue<int> bq(150, 0.25f);
+    q.enable_shrink_tuning();
+    bq.enable_shrink_tuning();
+    std::atomic<bool> stop{false};
+    std::thread tuner([&] {
+        for (size_t i = 0; !stop.load(); ++i) {
+            q.set_shrink_params(1 + i % 300, 0.1f + static_cast<float>(i % 5) * 0.1f);
+            bq.set_shrink_params(1 + i % 300, 0.1f + static_cast<float>(i % 5) * 0.1f);
+            std::this_thread::yield();
+        }
+    });
+    long long sum = 0, bsum = 0;
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < 2000; ++i) q.push(i), bq.push(i);
+        for (int i = 0; i < 2000; ++i) sum += q.pop(), bsum += bq.pop();
+    }
+    stop = true;
+    tuner.join();
+    EXPECT_EQ(sum, 20LL * 2000 * 1999 / 2);
+    EXPECT_EQ(bsum, sum);
+    EXPECT_TRUE(q.empty() && bq.empty());
+    q.set_shrink_params(0, -1.0f);
+    EXPECT_EQ(q.shrink_params(), std::make_pair(size_t(1), 0.0f));
+}
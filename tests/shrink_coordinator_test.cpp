@@ -0,0 +1,157 @@
+#include <gtest/gtest.h>
+#include "shrinkCoordinator.h"
+#include "adapterQueue.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+
+ShrinkCoordinator::Config TestConfig() {
+    ShrinkCoordinator::Config cfg;
+    cfg.min_reclaimable = 1;
+    cfg.trim_malloc = false;
+    cfg.psi_path = "/nonexistent/memory.pressure"; // 不受宿主机 PSI 影响
+    return cfg;
+}
+
+// 可回收字节固定、收缩后归零的假成员，记录收缩顺序
+struct FakeMember {
+    size_t bytes;
+    std::vector<std::string>* order;
+    std::string name;
+    size_t reclaimable() const { return bytes; }
+    size_t shrink() {
+        order->push_back(name);
+        return std::exchange(bytes, 0);
+    }
+};
+
+} // namespace
+
+TEST(ShrinkCoordinator, TrimAllShrinksLargestFirst) {
+    ShrinkCoordinator c(TestConfig());
+    std::vector<std::string> order;
+    std::vector<FakeMember> fakes{{100, &order, "small"}, {5000, &order, "large"}, {0, &order, "empty"},
+                                  {700, &order, "medium"}};
+    std::vector<ShrinkCoordinator::Handle> handles;
+    for (auto& f : fakes) {
+        handles.push_back(c.join_custom(f.name, [&f] { return f.reclaimable(); }, [&f] { return f.shrink(); }));
+    }
+    EXPECT_EQ(c.members(), 4u);
+    EXPECT_EQ(c.scan().front().name, "large");
+
+    ShrinkRoundReport r = c.trim_all();
+    EXPECT_STREQ(r.reason, "manual");
+    EXPECT_EQ(r.members, 4u);
+    EXPECT_EQ(r.shrunk, 3u); // 可回收为 0 的成员跳过
+    EXPECT_EQ(r.estimated_bytes, 5800u);
+    EXPECT_EQ(order, (std::vector<std::string>{"large", "medium", "small"}));
+
+    handles.clear();
+    EXPECT_EQ(c.members(), 0u);
+}
+
+TEST(ShrinkCoordinator, PollOnlyShrinksUnderRssPressure) {
+    std::atomic<size_t> rss{100};
+    auto cfg = TestConfig();
+    cfg.rss_soft_limit = 1000;
+    cfg.rss_bytes = [&rss] { return rss.load(); };
+    cfg.max_targets_per_round = 2;
+    cfg.min_reclaimable = 50;
+    ShrinkCoordinator c(cfg);
+
+    std::vector<std::string> order;
+    std::vector<FakeMember> fakes{{40, &order, "a"}, {300, &order, "b"}, {200, &order, "c"}, {100, &order, "d"}};
+    std::vector<ShrinkCoordinator::Handle> handles;
+    for (auto& f : fakes) {
+        handles.push_back(c.join_custom(f.name, [&f] { return f.reclaimable(); }, [&f] { return f.shrink(); }));
+    }
+
+    EXPECT_FALSE(c.under_pressure());
+    EXPECT_STREQ(c.poll().reason, "");
+    EXPECT_TRUE(order.empty());
+
+    rss = 2000;
+    EXPECT_TRUE(c.under_pressure());
+    ShrinkRoundReport r = c.poll();
+    EXPECT_STREQ(r.reason, "rss");
+    EXPECT_EQ(r.shrunk, 2u); // 每轮上限
+    EXPECT_EQ(r.rss_before, 2000u);
+    EXPECT_EQ(order, (std::vector<std::string>{"b", "c"}));
+
+    r = c.poll();
+    EXPECT_EQ(r.shrunk, 1u); // "a" 低于 min_reclaimable
+    EXPECT_EQ(order.back(), "d");
+}
+
+TEST(ShrinkCoordinator, ReadsPsiThreshold) {
+    std::string path = (std::filesystem::temp_directory_path() / "shrink_coordinator_psi").string();
+    {
+        std::ofstream out(path);
+        out << "some avg10=12.50 avg60=3.00 avg300=0.50 total=123456\n"
+            << "full avg10=1.00 avg60=0.00 avg300=0.00 total=1234\n";
+    }
+    EXPECT_DOUBLE_EQ(shrink_coordinator_detail::ReadPsiSomeAvg10(path), 12.5);
+    EXPECT_LT(shrink_coordinator_detail::ReadPsiSomeAvg10("/nonexistent/psi"), 0.0);
+
+    auto cfg = TestConfig();
+    cfg.psi_path = path;
+    cfg.psi_some_avg10 = 10.0;
+    ShrinkCoordinator c(cfg);
+    EXPECT_TRUE(c.under_pressure());
+    cfg.psi_some_avg10 = 20.0;
+    c.configure(cfg);
+    EXPECT_FALSE(c.under_pressure());
+    std::filesystem::remove(path);
+}
+
+TEST(ShrinkCoordinator, TakesOverQueueAutoShrink) {
+    ShrinkCoordinator c(TestConfig());
+    AutoShrinkBlockingQueue<int> q(10, 0.25f);
+    {
+        auto handle = c.join("orders", q);
+        for (int i = 0; i < 100000; ++i) q.push(i);
+        for (int i = 0; i < 100000; ++i) q.pop();
+        EXPECT_EQ(q.shrink_count(), 0u); // 自动收缩已交给协调器
+        EXPECT_EQ(q.last_high_mark(), 100000u);
+        size_t reclaimable = q.reclaimable_bytes(); // libstdc++ 只剩块指针数组，MSVC 还囤着块
+        EXPECT_GT(reclaimable, 0u);
+
+        ShrinkRoundReport r = c.trim_all();
+        EXPECT_EQ(r.shrunk, 1u);
+        EXPECT_EQ(r.estimated_bytes, reclaimable);
+        EXPECT_EQ(q.shrink_count(), 1u);
+        EXPECT_EQ(q.last_high_mark(), 0u);
+        EXPECT_EQ(q.reclaimable_bytes(), 0u);
+    }
+    // 离开协调器后恢复队列自己的自动收缩
+    EXPECT_EQ(c.members(), 0u);
+    for (int i = 0; i < 1000; ++i) q.push(i);
+    for (int i = 0; i < 1000; ++i) q.pop();
+    EXPECT_GT(q.shrink_count(), 1u);
+}
+
+TEST(ShrinkCoordinator, BackgroundThreadPolls) {
+    std::atomic<int> shrinks{0};
+    auto cfg = TestConfig();
+    cfg.rss_soft_limit = 1;
+    cfg.rss_bytes = [] { return size_t{2}; };
+    ShrinkCoordinator c(cfg);
+    auto h = c.join_custom("cache", [] { return size_t{4096}; }, [&shrinks] {
+        ++shrinks;
+        return size_t{4096};
+    });
+    c.start(1ms);
+    for (int i = 0; i < 2000 && shrinks.load() < 3; ++i) std::this_thread::sleep_for(1ms);
+    c.stop();
+    EXPECT_GE(shrinks.load(), 3);
+    EXPECT_GE(c.background_polls(), 3u);
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "slabAllocator.h"
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+struct Node64 { char buf[64]; };
+}
+
+TEST(SlabPool, AllocatesFromAlignedSlabsAndReleasesEmpty) {
+    SlabPool pool(64, 8, 0);
+    std::vector<void*> ptrs;
+    for (int i = 0; i < 5000; ++i) ptrs.push_back(pool.allocate());
+    EXPECT_EQ(pool.live_objects(), 5000u);
+    EXPECT_GE(pool.slab_count(), 5000u * 64 / slab_detail::kSlabSize);
+    for (void* p : ptrs) EXPECT_TRUE(pool.owns(p));
+    for (void* p : ptrs) pool.deallocate(p);
+    EXPECT_EQ(pool.live_objects(), 0u);
+    EXPECT_EQ(pool.slab_count(), 0u); // 不缓存空 slab 时全部归还
+}
+
+TEST(SlabPool, ReusesFreedSlotsAndCachesOneEmptySlab) {
+    SlabPool pool(24, 8, 1);
+    void* a = pool.allocate();
+    void* b = pool.allocate();
+    pool.deallocate(a);
+    EXPECT_EQ(pool.allocate(), a); // 后进先出复用
+    pool.deallocate(a);
+    pool.deallocate(b);
+    EXPECT_EQ(pool.slab_count(), 1u); // 留一个空 slab
+    EXPECT_EQ(pool.release_empty(), slab_detail::kSlabSize);
+    EXPECT_EQ(pool.slab_count(), 0u);
+}
+
+TEST(SlabPool, RespectsAlignment) {
+    SlabPool pool(48, 64, 0);
+    for (int i = 0; i < 100; ++i) {
+        void* p = pool.allocate();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % 64, 0u);
+    }
+}
+
+TEST(SlabAllocator, ListNodesReturnToOsOnClear) {
+    std::list<Node64, SlabAllocator<Node64>> l;
+    for (int i = 0; i < 10000; ++i) l.emplace_back();
+    auto arena = l.get_allocator().arena();
+    EXPECT_GT(arena->reserved_bytes(), 10000u * sizeof(Node64));
+    l.clear();
+    EXPECT_LE(arena->reserved_bytes(), slab_detail::kSlabSize); // 至多缓存一个空 slab
+    arena->release_empty();
+    EXPECT_EQ(arena->slab_count(), 0u);
+}
+
+TEST(SlabAllocator, EachContainerHasItsOwnArena) {
+    using Map = std::map<int, std::string, std::less<int>, SlabAllocator<std::pair<const int, std::string>>>;
+    Map a;
+    Map b;
+    for (int i = 0; i < 100; ++i) {
+        a.emplace(i, "a");
+        b.emplace(i, "b");
+    }
+    EXPECT_NE(a.get_allocator().arena(), b.get_allocator().arena());
+    Map c(a); // 拷贝构造的副本用新 arena
+    EXPECT_NE(c.get_allocator().arena(), a.get_allocator().arena());
+    EXPECT_EQ(c.size(), 100u);
+    Map d(std::move(a)); // 移动时 arena 跟着节点走
+    EXPECT_EQ(d.at(50), "a");
+    a.emplace(1, "still usable");
+    EXPECT_EQ(a.size(), 1u);
+}
+
+TEST(SlabAllocator, LargeArraysBypassSlabs) {
+    std::unordered_map<int, int, std::hash<int>, std::equal_to<int>, SlabAllocator<std::pair<const int, int>>> m;
+    for (int i = 0; i < 10000; ++i) m.emplace(i, i); // 桶数组远超 2KB，走 operator new
+    for (int i = 0; i < 10000; ++i) EXPECT_EQ(m.at(i), i);
+    std::set<int, std::less<int>, SlabAllocator<int>> s{3, 1, 2};
+    EXPECT_EQ(*s.begin(), 1);
+}
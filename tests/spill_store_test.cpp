@@ -0,0 +1,178 @@
+#include <gtest/gtest.h>
+#include "adapterQueue.h"
+#include "spillStore.h"
+
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Record {
+    uint64_t id;
+    char payload[56];
+};
+
+// 每个用例独占一个临时目录，结束时整体删除
+class SpillDir {
+public:
+    explicit SpillDir(const char* name)
+        : path_((std::filesystem::temp_directory_path() / name).string()) {
+        std::filesystem::remove_all(path_);
+    }
+    ~SpillDir() { std::filesystem::remove_all(path_); }
+
+    const std::string& path() const { return path_; }
+    size_t files() const {
+        if (!std::filesystem::exists(path_)) return 0;
+        size_t n = 0;
+        for (auto& e : std::filesystem::directory_iterator(path_)) n += e.is_regular_file() ? 1 : 0;
+        return n;
+    }
+
+private:
+    std::string path_;
+};
+
+SpillOptions SmallOptions(const std::string& dir) {
+    SpillOptions o;
+    o.directory = dir;
+    o.memory_limit_bytes = 64 * sizeof(Record);
+    o.segment_bytes = 64 << 10;
+    o.refill_batch = 100;
+    o.release_stride = 8 << 10;
+    return o;
+}
+
+} // namespace
+
+static_assert(SpillCodable<Record>);
+static_assert(SpillCodable<std::string>);
+static_assert(!SpillCodable<std::unique_ptr<int>>);
+
+TEST(SpillStore, RollsSegmentsAndDeletesThemWhenDrained) {
+    SpillDir dir("spill_store_roll");
+    SpillStore<std::string> store(SmallOptions(dir.path()));
+    ASSERT_TRUE(store.prepare());
+    for (int i = 0; i < 5000; ++i) store.append(std::string(40, static_cast<char>('a' + i % 26)) + std::to_string(i));
+    EXPECT_EQ(store.size(), 5000u);
+    EXPECT_GT(store.segments(), 2u);
+    EXPECT_EQ(dir.files(), store.segments());
+    EXPECT_EQ(store.fallback_size(), 0u);
+
+    std::deque<std::string> out;
+    size_t bytes = 0;
+    EXPECT_EQ(store.pop_into(out, 1000, bytes), 1000u);
+    EXPECT_GT(bytes, 1000u * 40);
+    while (store.pop_into(out, 1000, bytes) != 0) {
+    }
+    ASSERT_EQ(out.size(), 5000u);
+    for (int i = 0; i < 5000; ++i) {
+        ASSERT_EQ(out[i], std::string(40, static_cast<char>('a' + i % 26)) + std::to_string(i));
+    }
+    EXPECT_TRUE(store.empty());
+    EXPECT_EQ(store.segments(), 0u);
+    EXPECT_EQ(dir.files(), 0u);
+}
+
+TEST(SpillStore, FallsBackToMemoryWhenDiskUnavailable) {
+    SpillOptions o;
+    o.directory = "/proc/nonexistent/spill"; // 不可创建
+    SpillStore<int> store(o);
+    EXPECT_FALSE(store.prepare());
+    for (int i = 0; i < 10; ++i) store.append(i);
+    EXPECT_EQ(store.fallback_size(), 10u);
+    std::vector<int> out;
+    size_t bytes = 0;
+    EXPECT_EQ(store.pop_into(out, 100, bytes), 10u);
+    EXPECT_EQ(out, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+}
+
+TEST(SpillStore, FallbackMovesRvaluesInsteadOfCopying) {
+    SpillOptions o;
+    o.directory = "/proc/nonexistent/spill";
+    SpillStore<std::string> store(o);
+    std::string big(4096, 'x');
+    const char* buffer = big.data();
+    store.append(std::move(big));
+    ASSERT_EQ(store.fallback_size(), 1u);
+    std::vector<std::string> out;
+    size_t bytes = 0;
+    ASSERT_EQ(store.pop_into(out, 1, bytes), 1u);
+    EXPECT_EQ(out[0].data(), buffer); // 同一块堆内存，说明一路都是 move
+}
+
+TEST(SpillQueue, KeepsFifoAcrossMemoryAndDisk) {
+    SpillDir dir("spill_queue_fifo");
+    AutoShrinkBlockingQueue<Record> q;
+    for (int i = 0; i < 10; ++i) q.push(Record{static_cast<uint64_t>(i), {}});
+    ASSERT_TRUE(q.enable_spill(SmallOptions(dir.path())));
+    EXPECT_FALSE(q.enable_spill(SmallOptions(dir.path())));
+
+    const int n = 20000;
+    for (int i = 10; i < n; ++i) q.push(Record{static_cast<uint64_t>(i), {}});
+    EXPECT_EQ(q.size(), static_cast<size_t>(n));
+    EXPECT_EQ(q.spilled(), static_cast<size_t>(n - 64)); // 内存部分只留到阈值
+    EXPECT_GT(q.spill_segments(), 0u);
+    EXPECT_LE(q.last_high_mark(), 64u);
+
+    for (int i = 0; i < n; ++i) {
+        Record r = q.pop();
+        ASSERT_EQ(r.id, static_cast<uint64_t>(i));
+        if (i % 1000 == 0) {
+            EXPECT_LE(q.size() - q.spilled(), 100u); // 读回一批不超过 refill_batch
+        }
+    }
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(q.spilled(), 0u);
+    EXPECT_EQ(dir.files(), 0u);
+}
+
+TEST(SpillQueue, DetachStorageTakesOnlyTheInMemoryPart) {
+    SpillDir dir("spill_queue_detach");
+    AutoShrinkBlockingQueue<Record> q;
+    ASSERT_TRUE(q.enable_spill(SmallOptions(dir.path())));
+    const int n = 1000;
+    for (int i = 0; i < n; ++i) q.push(Record{static_cast<uint64_t>(i), {}});
+    ASSERT_EQ(q.spilled(), static_cast<size_t>(n - 64));
+
+    std::deque<Record> detached = q.detach_storage();
+    ASSERT_EQ(detached.size(), 64u); // 最早的 64 个，磁盘积压留在队列里
+    for (int i = 0; i < 64; ++i) EXPECT_EQ(detached[i].id, static_cast<uint64_t>(i));
+    EXPECT_EQ(q.size(), static_cast<size_t>(n - 64));
+    EXPECT_FALSE(q.empty());
+    EXPECT_LE(q.size() - q.spilled(), 100u); // 立即读回一批
+
+    for (int i = 64; i < n; ++i) ASSERT_EQ(q.pop().id, static_cast<uint64_t>(i));
+    EXPECT_TRUE(q.empty());
+    EXPECT_EQ(dir.files(), 0u);
+}
+
+TEST(SpillQueue, ConcurrentProducersWithStalledConsumer) {
+    SpillDir dir("spill_queue_mt");
+    AutoShrinkBlockingQueue<std::string> q;
+    auto o = SmallOptions(dir.path());
+    o.memory_limit_bytes = 16 << 10;
+    ASSERT_TRUE(q.enable_spill(o));
+    constexpr int producerN = 4, perProducer = 5000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerN; ++p) {
+        producers.emplace_back([&q, p] {
+            for (int i = 0; i < perProducer; ++i) q.push(std::to_string(p) + ":" + std::to_string(i));
+        });
+    }
+    for (auto& t : producers) t.join();
+    EXPECT_GT(q.spilled(), 0u);
+
+    std::vector<int> next(producerN, 0);
+    for (int i = 0; i < producerN * perProducer; ++i) {
+        std::string s = q.pop();
+        int p = std::stoi(s.substr(0, s.find(':')));
+        int seq = std::stoi(s.substr(s.find(':') + 1));
+        ASSERT_EQ(seq, next[p]++); // 单生产者内 FIFO
+    }
+    EXPECT_EQ(dir.files(), 0u);
+}
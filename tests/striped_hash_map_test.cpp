@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+#include "stripedHashMap.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(StripedHashMap, BasicOperations) {
+    StripedHashMap<int, std::string> m(8);
+    EXPECT_EQ(m.segment_count(), 8u);
+    EXPECT_TRUE(m.insert(1, "a"));
+    EXPECT_FALSE(m.insert(1, "b")); // 不覆盖
+    EXPECT_EQ(*m.find(1), "a");
+    EXPECT_FALSE(m.insert_or_assign(1, "c"));
+    EXPECT_EQ(*m.find(1), "c");
+    EXPECT_TRUE(m.update(1, [](std::string& v) { v += "!"; }));
+    EXPECT_FALSE(m.update(2, [](std::string&) {}));
+    EXPECT_EQ(*m.find(1), "c!");
+    m.compute(2, [](std::string& v) { v = "new"; });
+    EXPECT_TRUE(m.contains(2));
+    EXPECT_EQ(m.size(), 2u);
+    EXPECT_EQ(*m.extract(2), "new");
+    EXPECT_FALSE(m.find(2).has_value());
+    EXPECT_TRUE(m.erase(1));
+    EXPECT_FALSE(m.erase(1));
+    EXPECT_TRUE(m.empty());
+}
+
+TEST(StripedHashMap, SegmentCountRoundedToPowerOfTwo) {
+    StripedHashMap<int, int> a(5);
+    StripedHashMap<int, int> b(0);
+    EXPECT_EQ(a.segment_count(), 8u);
+    EXPECT_EQ(b.segment_count(), 1u);
+    for (int i = 0; i < 100; ++i) b.insert(i, i);
+    EXPECT_EQ(b.size(), 100u);
+}
+
+TEST(StripedHashMap, SegmentsShrinkAfterBurst) {
+    StripedHashMap<int, int> m(16, 100, 0.25f);
+    for (int i = 0; i < 200000; ++i) m.insert(i, i);
+    size_t peak_buckets = m.bucket_count();
+    for (int i = 0; i < 200000; ++i) m.erase(i);
+    EXPECT_GE(m.shrink_count(), 16u); // 每段至少收缩一次
+    EXPECT_LT(m.bucket_count(), peak_buckets / 10);
+}
+
+TEST(StripedHashMap, ConcurrentInsertEraseIsConsistent) {
+    StripedHashMap<int, int> m(32, 50, 0.25f);
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 20000;
+    std::vector<std::thread> threads;
+    std::atomic<int> found{0};
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kPerThread; ++i) {
+                int key = t * kPerThread + i;
+                m.insert(key, key);
+                if (m.find(key) == key) found.fetch_add(1, std::memory_order_relaxed);
+                if (i % 2 == 0) m.erase(key);
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    EXPECT_EQ(found.load(), kThreads * kPerThread);
+    EXPECT_EQ(m.size(), static_cast<size_t>(kThreads * kPerThread / 2));
+    size_t odd = 0;
+    m.for_each([&](const int& k, int& v) {
+        EXPECT_EQ(k, v);
+        if (k % 2 == 1) ++odd;
+    });
+    EXPECT_EQ(odd, m.size());
+}
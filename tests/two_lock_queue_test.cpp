@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "twoLockQueue.h"
+#include "shrinkCoordinator.h"
+#include "sequenceStamp.h"
+
+using namespace std::chrono_literals;
+
+TEST(TwoLockQueueTest, PushPopAcrossChunks) {
+    TwoLockQueue<int> q;
+    const int n = static_cast<int>(TwoLockQueue<int>::kChunkElems) * 3 + 7;
+    for (int i = 0; i < n; ++i) q.push(i);
+    EXPECT_EQ(q.size(), static_cast<size_t>(n));
+    EXPECT_EQ(q.last_high_mark(), static_cast<size_t>(n));
+    for (int i = 0; i < n; ++i) EXPECT_EQ(q.pop(), i);
+    EXPECT_TRUE(q.empty());
+    EXPECT_FALSE(q.try_pop().has_value());
+}
+
+TEST(TwoLockQueueTest, MoveOnlyAndDestructorReleasesElements) {
+    auto probe = std::make_shared<int>(0);
+    {
+        TwoLockQueue<std::shared_ptr<int>> q;
+        for (int i = 0; i < 1000; ++i) q.push(probe);
+        for (int i = 0; i < 10; ++i) q.pop();
+        EXPECT_EQ(probe.use_count(), 991);
+    }
+    EXPECT_EQ(probe.use_count(), 1);
+
+    TwoLockQueue<std::unique_ptr<std::string>> q;
+    q.emplace(std::make_unique<std::string>("x"));
+    EXPECT_EQ(*q.pop(), "x");
+}
+
+TEST(TwoLockQueueTest, PopBlocksUntilPush) {
+    TwoLockQueue<int> q;
+    std::atomic<bool> got{false};
+    std::thread consumer([&] {
+        EXPECT_EQ(q.pop(), 42);
+        got = true;
+    });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(got.load());
+    q.push(42);
+    consumer.join();
+    EXPECT_TRUE(got.load());
+}
+
+TEST(TwoLockQueueTest, BoundedPushBlocksUntilPop) {
+    TwoLockQueue<int> q(150, 0.25f, 2);
+    q.push(1);
+    q.push(2);
+    std::atomic<bool> pushed{false};
+    std::thread producer([&] {
+        q.push(3);
+        pushed = true;
+    });
+    std::this_thread::sleep_for(20ms);
+    EXPECT_FALSE(pushed.load());
+    EXPECT_EQ(q.pop(), 1);
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+    EXPECT_EQ(q.size(), 2u);
+}
+
+TEST(TwoLockQueueTest, DrainIntoBatch) {
+    TwoLockQueue<int> q;
+    for (int i = 0; i < 10; ++i) q.push(i);
+    std::vector<int> out;
+    EXPECT_EQ(q.drain_into(std::back_inserter(out), 4), 4u);
+    EXPECT_EQ(q.drain_into(std::back_inserter(out)), 6u);
+    EXPECT_EQ(out, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+    EXPECT_EQ(q.drain_into(std::back_inserter(out)), 0u);
+}
+
+// 突发过后备用块囤积到高水位，auto shrink 释放掉并把 high mark 降下来
+TEST(TwoLockQueueTest, AutoShrinkReleasesSpareChunks) {
+    TwoLockQueue<int> q(64, 0.25f);
+    const size_t n = TwoLockQueue<int>::kChunkElems * 16;
+    for (size_t i = 0; i < n; ++i) q.push(static_cast<int>(i));
+    for (size_t i = 0; i < n; ++i) q.pop();
+    EXPECT_GT(q.shrink_count(), 0u);
+    EXPECT_EQ(q.spare_chunks(), 0u);
+    EXPECT_EQ(q.last_high_mark(), 0u);
+}
+
+TEST(TwoLockQueueTest, CoordinatorTakesOverShrink) {
+    ShrinkCoordinator::Config cfg;
+    cfg.min_reclaimable = 1;
+    cfg.trim_malloc = false;
+    cfg.psi_path = "/nonexistent/memory.pressure";
+    ShrinkCoordinator c(cfg);
+    TwoLockQueue<int> q(16, 0.25f);
+    auto handle = c.join("two-lock", q);
+    const size_t n = TwoLockQueue<int>::kChunkElems * 8;
+    for (size_t i = 0; i < n; ++i) q.push(static_cast<int>(i));
+    for (size_t i = 0; i < n; ++i) q.pop();
+    EXPECT_EQ(q.shrink_count(), 0u);
+    EXPECT_GE(q.spare_chunks(), 7u);
+    size_t reclaimable = q.reclaimable_bytes();
+    EXPECT_EQ(c.trim_all().estimated_bytes, reclaimable);
+    EXPECT_EQ(q.spare_chunks(), 0u);
+    EXPECT_EQ(q.shrink_count(), 1u);
+}
+
+// 20 生产者 / 1 消费者，频繁 shrink 下校验单生产者内 FIFO
+TEST(TwoLockQueueTest, MultiProducerPerProducerFifo) {
+    TwoLockQueue<Stamped<int>> q(16, 0.5f);
+    constexpr int producerN = 20, numPerProducer = 5000;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < producerN; ++p) {
+        producers.emplace_back([&, p] {
+            SequenceStamper stamper(p);
+            for (int j = 0; j < numPerProducer; ++j) q.push(stamper.stamp(j));
+        });
+    }
+    FifoOrderChecker checker(producerN, true);
+    for (int i = 0; i < producerN * numPerProducer; ++i) {
+        auto s = q.pop();
+        checker.check(s);
+        EXPECT_EQ(s.value, static_cast<int>(s.seq));
+    }
+    for (auto& t : producers) t.join();
+    EXPECT_EQ(checker.violations(), 0u);
+    EXPECT_TRUE(checker.complete(numPerProducer));
+}
+
+TEST(TwoLockQueueTest, BoundedMultiProducerMultiConsumer) {
+    TwoLockQueue<Stamped<int>> q(16, 0.5f, 64);
+    constexpr int producerN = 8, consumerN = 4, numPerProducer = 5000;
+    std::vector<std::thread> threads;
+    std::vector<FifoOrderChecker> checkers(consumerN, FifoOrderChecker(producerN));
+    for (int p = 0; p < producerN; ++p) {
+        threads.emplace_back([&, p] {
+            SequenceStamper stamper(p);
+            for (int j = 0; j < numPerProducer; ++j) q.push(stamper.stamp(j));
+        });
+    }
+    for (int c = 0; c < consumerN; ++c) {
+        threads.emplace_back([&, c] {
+            for (int i = 0; i < producerN * numPerProducer / consumerN; ++i) checkers[c].check(q.pop());
+        });
+    }
+    for (auto& t : threads) t.join();
+    for (int c = 1; c < consumerN; ++c) checkers[0].merge(checkers[c]);
+    EXPECT_EQ(checkers[0].violations(), 0u);
+    EXPECT_TRUE(checkers[0].complete(numPerProducer));
+    EXPECT_LE(q.last_high_mark(), 64u);
+    EXPECT_TRUE(q.empty());
+}
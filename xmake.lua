@@ -3,13 +3,20 @@ add_requires("conan::boost/1.85.0#3add30047e4245e29efe86ba14014e76", { alias = "
 add_requires("conan::benchmark/1.9.4#ce4403f7a24d3e1f907cd9da4b678be4", { alias = "benchmark" , debug = is_mode("debug"), configs = { settings = "compiler.cppstd=20"}})
 add_requires("conan::gtest/1.14.0#25e2a474b4d1aecf5ff4f0555dcdf72c", { alias = "gtest" , debug = is_mode("debug"), configs = { settings = "compiler.cppstd=20"}})
 
-add_rules("mode.debug", "mode.release")
+-- releasedbg: O2 + 调试符号；asan/tsan: 地址/线程检查（主要用于 Linux 上对无锁/并发队列做竞态检查）
+-- xmake f -m releasedbg / xmake f -m asan / xmake f -m tsan
+add_rules("mode.debug", "mode.release", "mode.releasedbg", "mode.asan", "mode.tsan")
 set_languages("c++20")
 add_cxxflags("cl::/bigobj", "cl::/Zc:__cplusplus", "cl::/Oy-", "cl::/permissive-", "cl::/FS", "cl::/Zi")
+-- gcc/clang 下保留帧指针，perf record -g 才能拿到完整调用栈（对应 MSVC 的 /Oy-）
+add_cxflags("gcc::-fno-omit-frame-pointer", "clang::-fno-omit-frame-pointer")
+if is_plat("linux") then
+    add_syslinks("pthread", "rt") -- rt: shm_open（glibc 2.34 之前不在 libc 里）
+end
 -- todo: recover this falg to generate cod
 -- add_cxxflags("cl::/FAcs")
 local buildir = get_config("buildir") or "build"
-local plat    = get_config("plat") or "windows"
+local plat    = get_config("plat") or os.host()
 local arch    = get_config("arch") or "x86"
 local mode    = get_config("mode") or "release"
 set_symbols("debug")
@@ -21,7 +28,9 @@ if is_mode("debug") and has_config("vld") then
     add_links("vld")
 end
 set_configvar("PROJECT_NAME", "MT4_SG")
-set_runtimes("MT")
+if is_plat("windows") then
+    set_runtimes("MT")
+end
 option("vld")
     set_showmenu(true)
     set_default(false)
@@ -39,11 +48,16 @@ target("stl-test")
     -- add_defines("_WIN32", "_WINDOWS", "WIN32_LEAN_AND_MEAN", "SPDLOG_ACTIVE_LEVEL=SPDLOG_LEVEL_TRACE", "_USE_32BIT_TIME_T")
     add_files("src/*.cpp")
     add_packages("spdlog", "boost")
-    add_links("advapi32")
+    if is_plat("windows") then
+        add_links("advapi32")
+    end
     -- add_includedirs("src")
     set_version("1.16.0")
     -- === 修复LNK1104，给不同target分配独立map，并在构建前自动建目录 ===
     on_load(function(target)
+        if not target:is_plat("windows") then
+            return
+        end
         local map_path = path.join(buildir, plat, arch, mode, target:name() .. ".map")
         target:data_set("my_map_path", map_path)
         target:add("ldflags", "/DEBUG", 
@@ -114,14 +128,20 @@ target("benchmark-stl-test")
     set_kind("binary")
     add_defines("SPDLOG_ACTIVE_LEVEL=SPDLOG_LEVEL_TRACE")
     add_files("bench/*.cpp")   -- 假如你的benchmark代码在此
+    add_files("src/memoryStats_windows.cpp", "src/memoryStats_linux.cpp") -- 对比 benchmark 采样 RSS
     --add_files("src/adapterQueue.h") -- 因为没有cpp文件
     add_includedirs("src")            -- 让benchmark_queue.cpp可 #include "adapterQueue.h"
     add_packages("benchmark", "spdlog", "boost")
-    add_links("advapi32")
+    if is_plat("windows") then
+        add_links("advapi32")
+    end
     --add_includedirs("src") -- 假如AutoShrinkBlockingQueue.h在src下，提供给benchmark用
     set_version("1.16.0")
     -- === 修复LNK1104，map单独命名并自动建目录 ===
     on_load(function(target)
+        if not target:is_plat("windows") then
+            return
+        end
         local map_path = path.join(buildir, plat, arch, mode, target:name() .. ".map")
         target:data_set("my_map_path", map_path)
         target:add("ldflags", "/DEBUG", 
@@ -199,6 +219,11 @@ target("benchmark-stl-test")
 -- or 
 ---- xmake test 
 
+-- Linux:
+--xmake f -p linux -m releasedbg --test=y      (perf record -g 可用，保留帧指针)
+--xmake f -p linux -m tsan --test=y && xmake && xmake run unit_tests    (竞态检查)
+--xmake f -p linux -m asan --test=y && xmake && xmake run unit_tests    (越界/泄漏检查)
+
 -- 单元测试 target
 if has_config("test") then
     target("unit_tests")
@@ -211,6 +236,9 @@ if has_config("test") then
         set_version("1.16.0")
         -- === 修复LNK1104，map单独命名并自动建目录 ===
         on_load(function(target)
+            if not target:is_plat("windows") then
+                return
+            end
             local map_path = path.join(buildir, plat, arch, mode, target:name() .. ".map")
             target:data_set("my_map_path", map_path)
             target:add("ldflags", "/DEBUG", 